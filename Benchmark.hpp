@@ -0,0 +1,935 @@
+#ifndef BENCHMARK_HPP
+#define BENCHMARK_HPP
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <set>
+#include <vector>
+#include <bitset>
+#include <functional>
+#include <random>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <queue>
+
+#include "SynchrotronComponent.hpp"
+#include "SynchrotronNetlist.hpp"
+#include "SynchrotronParallel.hpp"
+#include "SynchrotronGraph.hpp"
+#include "SynchrotronBuilder.hpp"
+#include "SynchrotronSubcircuit.hpp"
+#include "SynchrotronSnapshot.hpp"
+#include "SynchrotronVCD.hpp"
+#include "SynchrotronTiming.hpp"
+#include "NativeBitset.hpp"
+#include "BitsetKernels.hpp"
+
+#include "CPUComponents/ANDGate.hpp"
+#include "CPUComponents/ORGate.hpp"
+#include "CPUComponents/XORGate.hpp"
+#include "CPUComponents/MemoryCell.hpp"
+#include "CPUComponents/Clock.hpp"
+#include "CPUFactory/BitSliceSimulator.hpp"
+#include "CPUFactory/NetlistFile.hpp"
+#include "CPUFactory/TimingAnalysis.hpp"
+
+using namespace CPUComponents;
+
+/**	\brief	Sink for benchmarked results, so the compiler cannot optimize the work away.
+ */
+static volatile size_t _Benchmark_Sink;
+
+/**	\brief
+ *		Time the given function.
+ *
+ *	\param	f
+ *		The function to call `iterations` times.
+ *	\param	iterations
+ *		The amount of calls to average over.
+ *
+ *	\return	double
+ *		Returns the average duration of one call in nanoseconds.
+ */
+template <class F>
+double benchmark(F f, size_t iterations) {
+	f();	// Warm-up
+
+	auto start = std::chrono::high_resolution_clock::now();
+	for (size_t i = 0; i < iterations; ++i)
+		f();
+	auto stop  = std::chrono::high_resolution_clock::now();
+
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count() / double(iterations);
+}
+
+/**	\brief
+ *		Print a benchmark header with the given title and column names.
+ */
+void printBenchmarkHeader(const std::string& title, std::initializer_list<std::string> columns) {
+	std::cout << std::endl << "--- " << title << " ---" << std::endl;
+	for (auto& column : columns)
+		std::cout << std::setw(14) << column;
+	std::cout << std::endl;
+}
+
+/**	\brief
+ *	Connections : Compare iterating the inputs of a wide fan-in gate
+ *	through a `std::set` (tree) versus the contiguous FlatSet of SynchrotronComponent.
+ */
+void benchmarkFanInIteration(void) {
+	printBenchmarkHeader("Fan-in iteration (ns per input)", { "inputs", "std::set", "FlatSet", "ANDGate::tick" });
+
+	for (size_t fan_in : { 2u, 8u, 64u, 512u, 4096u }) {
+		std::vector<SynchrotronComponent<1>*> sources;
+		std::vector<int*> scatter;
+		std::set<SynchrotronComponent<1>*, Ordered::compare> tree;
+		ANDGate<1> gate;
+
+		for (size_t i = 0; i < fan_in; ++i) {
+			sources.push_back(new SynchrotronComponent<1>(1));
+			gate.addInput(*sources.back());
+			tree.insert(sources.back());
+			scatter.push_back(new int[7]);	// Spread the tree nodes over the heap as in a real build
+		}
+
+		const size_t iterations = 4000000 / fan_in + 1;
+
+		double t_tree = benchmark([&]() {
+			std::bitset<1> state; state.set();
+			for (auto connection : tree)
+				state &= connection->getState();
+			_Benchmark_Sink = state.count();
+		}, iterations);
+
+		double t_flat = benchmark([&]() {
+			std::bitset<1> state; state.set();
+			for (auto connection : gate.getInputs())
+				state &= connection->getState();
+			_Benchmark_Sink = state.count();
+		}, iterations);
+
+		double t_tick = benchmark([&]() {
+			gate.tick();
+		}, iterations);
+
+		std::cout << std::setw(14) << fan_in
+				  << std::fixed << std::setprecision(3)
+				  << std::setw(14) << t_tree / fan_in
+				  << std::setw(14) << t_flat / fan_in
+				  << std::setw(14) << t_tick / fan_in << std::endl;
+
+		for (auto source : sources)
+			delete source;
+		for (auto s : scatter)
+			delete[] s;
+	}
+}
+
+/**	\brief
+ *	State : Compare folding the states of 8 inputs as `std::bitset` versus NativeBitset
+ *	(the state of SynchrotronComponent for bit_width <= 64).
+ */
+template <size_t bit_width>
+void benchmarkStateWidth(void) {
+	const size_t iterations = 2000000;
+	std::vector<std::bitset<bit_width>>		wide;
+	std::vector<NativeBitset<bit_width>>	native;
+	std::vector<SynchrotronComponent<bit_width>*> sources;
+	ANDGate<bit_width> gate;
+
+	for (size_t i = 0; i < 8; ++i) {
+		wide.emplace_back(~0ull - i);
+		native.emplace_back(~0ull - i);
+		sources.push_back(new SynchrotronComponent<bit_width>(~0ull - i));
+		gate.addInput(*sources.back());
+	}
+
+	double t_wide = benchmark([&]() {
+		std::bitset<bit_width> state; state.set();
+		for (auto& input : wide)
+			state &= input;
+		_Benchmark_Sink = state.count();
+	}, iterations);
+
+	double t_native = benchmark([&]() {
+		NativeBitset<bit_width> state; state.set();
+		for (auto& input : native)
+			state &= input;
+		_Benchmark_Sink = state.count();
+	}, iterations);
+
+	double t_tick = benchmark([&]() {
+		gate.tick();
+	}, iterations);
+
+	std::cout << std::setw(14) << bit_width
+			  << std::fixed << std::setprecision(3)
+			  << std::setw(14) << t_wide
+			  << std::setw(14) << t_native
+			  << std::setw(14) << t_tick << std::endl;
+
+	for (auto source : sources)
+		delete source;
+}
+
+/**	\brief
+ *	Gate kernels : Compare folding the inputs of a wide gate one `std::bitset` at a time
+ *	(the loop the gates used) versus the n-ary foldStates() kernel, as XOR of all inputs.
+ */
+template <size_t bit_width>
+void benchmarkGateKernel(void) {
+	for (size_t inputs : { 2u, 8u, 64u }) {
+		const size_t iterations = 4000000 / inputs;
+		std::vector<SynchrotronComponent<bit_width>*> sources;
+		XORGate<bit_width> gate;
+
+		for (size_t i = 0; i < inputs; ++i) {
+			sources.push_back(new SynchrotronComponent<bit_width>(0x9E3779B97F4A7C15ull * (i + 1)));
+			gate.addInput(*sources.back());
+		}
+
+		std::StateBitset<bit_width> state;
+
+		double t_loop = benchmark([&]() {
+			state.reset();
+			for (auto& connection : gate.getInputs())
+				state ^= connection->getNativeState();
+			_Benchmark_Sink = state.test(bit_width - 1);
+		}, iterations);
+
+		double t_kernel = benchmark([&]() {
+			std::foldStates<std::FoldXOR>(state, gate.getInputs());
+			_Benchmark_Sink = state.test(bit_width - 1);
+		}, iterations);
+
+		std::cout << std::setw(14) << bit_width << std::setw(14) << inputs
+				  << std::fixed << std::setprecision(3)
+				  << std::setw(14) << t_loop / inputs
+				  << std::setw(14) << t_kernel / inputs << std::endl;
+
+		for (auto source : sources)
+			delete source;
+	}
+}
+
+/**	\brief
+ *	Bit-slicing : Exhaustively evaluate a ripple-carry adder built from 1-bit gates,
+ *	one input vector at a time through tick() versus 64 vectors per BitSliceSimulator pass.
+ */
+void benchmarkBitSlice(void) {
+	printBenchmarkHeader("Exhaustive ripple-carry adder (ns per input vector)", { "adder bits", "vectors", "tick()", "bit-sliced" });
+
+	for (size_t bits : { 2u, 4u, 6u }) {
+		std::vector<MemoryCell<1>*> sources;
+		std::vector<SynchrotronComponent<1>*> gates, inputs, outputs;
+		SynchrotronComponent<1> *carry;
+
+		for (size_t i = 0; i < 2 * bits + 1; ++i) {
+			sources.push_back(new MemoryCell<1>());
+			inputs.push_back(sources.back());
+		}
+
+		carry = sources.back();
+		for (size_t i = 0; i < bits; ++i) {
+			SynchrotronComponent<1> *x = new XORGate<1>( {sources[i], sources[bits + i]} ),
+									*s = new XORGate<1>( {x, carry} ),
+									*g = new ANDGate<1>( {sources[i], sources[bits + i]} ),
+									*p = new ANDGate<1>( {x, carry} );
+			carry = new ORGate<1>( {g, p} );
+			gates.insert(gates.end(), { x, s, g, p, carry });
+			outputs.push_back(s);
+		}
+		outputs.push_back(carry);
+
+		const size_t vectors = size_t(1) << inputs.size();
+
+		double t_tick = benchmark([&]() {
+			size_t sink = 0;
+			for (size_t v = 0; v < vectors; ++v) {
+				for (size_t j = 0; j < sources.size(); ++j)
+					sources[j]->setState((v >> j) & 1u);
+				for (auto output : outputs)
+					sink += output->getState().test(0);
+			}
+			_Benchmark_Sink = sink;
+		}, 20);
+
+		CPUFactory::BitSliceSimulator sim;
+		sim.compile(inputs);
+
+		double t_slice = benchmark([&]() {
+			size_t sink = 0;
+			for (size_t v = 0; v < vectors; v += CPUFactory::BitSliceSimulator::LANES) {
+				sim.setExhaustive(inputs, v);
+				sim.evaluate();
+				for (auto output : outputs)
+					sink += sim.getLanes(*output) & 1u;
+			}
+			_Benchmark_Sink = sink;
+		}, 20);
+
+		std::cout << std::setw(14) << bits
+				  << std::setw(14) << vectors
+				  << std::fixed << std::setprecision(3)
+				  << std::setw(14) << t_tick / vectors
+				  << std::setw(14) << t_slice / vectors << std::endl;
+
+		for (auto it = gates.rbegin(); it != gates.rend(); ++it)
+			delete *it;
+		for (auto source : sources)
+			delete source;
+	}
+}
+
+/**	\brief
+ *	Parallel levels : Evaluate wide levels of gates with SynchrotronNetlist (one thread)
+ *	versus SynchrotronParallelNetlist (every level split over all hardware threads).
+ */
+void benchmarkParallelLevels(void) {
+	printBenchmarkHeader("Level-parallel evaluation (ms per evaluate())", { "gates/level", "threads", "netlist", "parallel" });
+
+	for (size_t width : { 1000u, 10000u, 50000u }) {
+		std::vector<MemoryCell<64>*> cells;
+		std::vector<SynchrotronComponent<64>*> gates, layer;
+
+		for (size_t i = 0; i < 64; ++i) {
+			cells.push_back(new MemoryCell<64>(~0ull - i));
+			layer.push_back(cells.back());
+		}
+
+		for (size_t level = 0; level < 8; ++level) {
+			std::vector<SynchrotronComponent<64>*> next;
+			for (size_t i = 0; i < width; ++i) {
+				SynchrotronComponent<64> *gate = new ANDGate<64>();
+				for (size_t j = 0; j < 8; ++j)
+					gate->addInput(*layer[(i * 31 + j * 17) % layer.size()]);
+				gates.push_back(gate);
+				next.push_back(gate);
+			}
+			layer.swap(next);
+		}
+
+		double t_serial, t_parallel;
+		size_t threads;
+		{
+			SynchrotronNetlist<64> netlist;
+			netlist.compile(cells);
+			t_serial = benchmark([&]() { netlist.evaluate(); }, 5);
+		}
+		{
+			SynchrotronParallelNetlist<64> parallel;
+			parallel.compile(cells);
+			threads = parallel.getWorkerCount();
+			t_parallel = benchmark([&]() { parallel.evaluate(); }, 5);
+		}
+
+		std::cout << std::setw(14) << width
+				  << std::setw(14) << threads
+				  << std::fixed << std::setprecision(3)
+				  << std::setw(14) << t_serial / 1e6
+				  << std::setw(14) << t_parallel / 1e6 << std::endl;
+
+		for (auto it = gates.rbegin(); it != gates.rend(); ++it)
+			delete *it;
+		for (auto cell : cells)
+			delete cell;
+	}
+}
+
+/**	\brief
+ *	Netlist loading : Load a layered gate graph from its text form versus its binary form
+ *	(from memory, as the memory mapped file would be).
+ */
+void benchmarkNetlistLoad(void) {
+	printBenchmarkHeader("Netlist loading (ms per load)", { "components", "edges", "text", "binary" });
+
+	for (size_t width : { 1000u, 10000u, 50000u }) {
+		std::vector<SynchrotronComponent<16>*> components, layer;
+		size_t edges = 0;
+
+		for (size_t i = 0; i < 64; ++i) {
+			components.push_back(new MemoryCell<16>(i));
+			layer.push_back(components.back());
+		}
+
+		for (size_t level = 0; level < 4; ++level) {
+			std::vector<SynchrotronComponent<16>*> next;
+			for (size_t i = 0; i < width; ++i) {
+				SynchrotronComponent<16> *gate = (i & 1u) ? (SynchrotronComponent<16>*) new ANDGate<16>()
+														   : (SynchrotronComponent<16>*) new XORGate<16>();
+				for (size_t j = 0; j < 4; ++j)
+					gate->addInput(*layer[(i * 31 + j * 17) % layer.size()]);
+				edges += gate->getInputs().size();
+				components.push_back(gate);
+				next.push_back(gate);
+			}
+			layer.swap(next);
+		}
+
+		std::stringstream text, binary;
+		CPUFactory::NetlistFile<16>::writeText(text, components);
+		CPUFactory::NetlistFile<16>::writeBinary(binary, components);
+		const std::string textForm = text.str(), binaryForm = binary.str();
+
+		double t_text = benchmark([&]() {
+			std::stringstream ss(textForm);
+			CPUFactory::NetlistFile<16> loaded;
+			loaded.readText(ss);
+			_Benchmark_Sink = loaded.size();
+		}, 3);
+
+		double t_binary = benchmark([&]() {
+			CPUFactory::NetlistFile<16> loaded;
+			loaded.readBinary(binaryForm.data(), binaryForm.size());
+			_Benchmark_Sink = loaded.size();
+		}, 3);
+
+		std::cout << std::setw(14) << components.size()
+				  << std::setw(14) << edges
+				  << std::fixed << std::setprecision(3)
+				  << std::setw(14) << t_text / 1e6
+				  << std::setw(14) << t_binary / 1e6 << std::endl;
+
+		for (auto it = components.rbegin(); it != components.rend(); ++it)
+			delete *it;
+	}
+}
+
+/**	\brief
+ *	Graph teardown : Build and destroy a layered gate graph with one heap allocation per component
+ *	versus in a SynchrotronGraph arena.
+ */
+void benchmarkGraphTeardown(void) {
+	printBenchmarkHeader("Build + teardown (ms per graph)", { "components", "new/delete", "arena" });
+
+	for (size_t width : { 1000u, 10000u, 50000u }) {
+		auto build = [width](std::function<SynchrotronComponent<16>*(bool)> make) {
+			std::vector<SynchrotronComponent<16>*> all, layer, next;
+
+			for (size_t i = 0; i < 64; ++i) {
+				all.push_back(make(false));
+				layer.push_back(all.back());
+			}
+			for (size_t level = 0; level < 4; ++level, layer.swap(next)) {
+				next.clear();
+				for (size_t i = 0; i < width; ++i) {
+					SynchrotronComponent<16> *gate = make(true);
+					for (size_t j = 0; j < 4; ++j)
+						gate->addInput(*layer[(i * 31 + j * 17) % layer.size()]);
+					all.push_back(gate);
+					next.push_back(gate);
+				}
+			}
+			return all;
+		};
+
+		double t_heap = benchmark([&]() {
+			std::vector<SynchrotronComponent<16>*> all = build([](bool gate) -> SynchrotronComponent<16>* {
+				return gate ? (SynchrotronComponent<16>*) new ANDGate<16>() : new MemoryCell<16>();
+			});
+			for (auto it = all.rbegin(); it != all.rend(); ++it)
+				delete *it;
+		}, 3);
+
+		double t_arena = benchmark([&]() {
+			SynchrotronGraph<16> graph;
+			build([&graph](bool gate) -> SynchrotronComponent<16>* {
+				return gate ? (SynchrotronComponent<16>*) graph.create<ANDGate<16>>() : graph.create<MemoryCell<16>>();
+			});
+		}, 3);
+
+		std::cout << std::setw(14) << 64 + 4 * width
+				  << std::fixed << std::setprecision(3)
+				  << std::setw(14) << t_heap / 1e6
+				  << std::setw(14) << t_arena / 1e6 << std::endl;
+	}
+}
+
+/**	\brief
+ *	Bulk connection : Connect a random DAG with 4 inputs per gate, listed in random order,
+ *	through addInput() per edge versus one SynchrotronBuilder::commit() (both include disconnecting it again).
+ */
+void benchmarkBulkConnect(void) {
+	printBenchmarkHeader("Connect (ms per graph)", { "edges", "addInput", "builder" });
+
+	for (size_t count : { 10000u, 100000u, 400000u }) {
+		std::vector<SynchrotronComponent<16>*> components;
+		std::vector<std::pair<size_t, size_t>> edges;
+		size_t seed = 12345;
+
+		for (size_t i = 0; i < count; ++i) {
+			components.push_back(new ANDGate<16>());
+			for (size_t j = 0; i > 0 && j < 4; ++j) {
+				seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+				edges.push_back(std::make_pair(size_t(seed >> 33) % i, i));
+			}
+		}
+		std::shuffle(edges.begin(), edges.end(), std::mt19937(42));
+
+		auto disconnect = [&components]() {
+			for (auto component : components)
+				while (!component->getInputs().empty())
+					component->removeInput(**component->getInputs().begin());
+		};
+
+		double t_single = benchmark([&]() {
+			for (auto& edge : edges)
+				components[edge.second]->addInput(*components[edge.first]);
+			disconnect();
+		}, 3);
+
+		double t_bulk = benchmark([&]() {
+			SynchrotronBuilder<16> builder(components);
+			builder.connect(edges);
+			builder.commit();
+			disconnect();
+		}, 3);
+
+		for (auto component : components)
+			delete component;
+
+		std::cout << std::setw(14) << edges.size()
+				  << std::fixed << std::setprecision(3)
+				  << std::setw(14) << t_single / 1e6
+				  << std::setw(14) << t_bulk / 1e6 << std::endl;
+	}
+}
+
+/**	\brief
+ *	Snapshots : Cost of one SynchrotronSnapshot publication without observers
+ *	and with observer threads copying it continuously.
+ */
+void benchmarkSnapshot(void) {
+	printBenchmarkHeader("Snapshot publish (ns per publication)", { "values", "no readers", "3 readers", "reads" });
+
+	for (size_t count : { 64u, 1024u, 16384u }) {
+		SynchrotronSnapshot<16> snapshot(count);
+		size_t value = 0;
+
+		auto publish = [&]() {
+			snapshot.publish([&](SynchrotronSnapshot<16>::Writer& writer) {
+				++value;
+				for (size_t i = 0; i < count; ++i)
+					writer.set(i, uint64_t(value + i));
+			});
+		};
+
+		const size_t iterations = 2000000 / count;
+		double t_alone = benchmark(publish, iterations);
+
+		std::atomic<bool> stop(false);
+		std::atomic<size_t> reads(0);
+		std::vector<std::thread> readers;
+
+		for (size_t r = 0; r < 3; ++r)
+			readers.emplace_back([&]() {
+				std::vector<uint64_t> copy;
+				while (!stop.load(std::memory_order_relaxed)) {
+					snapshot.read(copy);
+					reads.fetch_add(1, std::memory_order_relaxed);
+				}
+			});
+
+		double t_observed = benchmark(publish, iterations);
+		stop = true;
+		for (auto& reader : readers)
+			reader.join();
+
+		std::cout << std::setw(14) << count
+				  << std::fixed << std::setprecision(1)
+				  << std::setw(14) << t_alone
+				  << std::setw(14) << t_observed
+				  << std::setw(14) << reads.load() << std::endl;
+	}
+}
+
+/**	\brief
+ *	GateSummary : Compare folding all inputs of a wide fan-in gate again (tick())
+ *	with updating it from the one input that changed (tickInput()).
+ */
+template <class Gate>
+void benchmarkIncrementalGate(const std::string& name) {
+	for (size_t inputs : { 8u, 64u, 1024u }) {
+		std::vector<MemoryCell<64>*> cells;
+		Gate gate;
+		size_t step = 0;
+
+		for (size_t i = 0; i < inputs; ++i) {
+			cells.push_back(new MemoryCell<64>(~size_t(0)));
+			gate.addInput(*cells.back());
+		}
+		// Only the calls below evaluate the gate.
+		gate.setEnabled(false);
+
+		auto change = [&]() -> MemoryCell<64>& {
+			MemoryCell<64> &cell = *cells[(step * 7919) % inputs];
+			cell.setState(std::bitset<64>(~(++step & 0xFF)));
+			return cell;
+		};
+
+		double t_full = benchmark([&]() { change(); gate.tick(); _Benchmark_Sink = gate.getState().test(0); }, 200000 / inputs + 1000);
+		double t_incr = benchmark([&]() { gate.tickInput(change()); _Benchmark_Sink = gate.getState().test(0); }, 200000 / inputs + 1000);
+
+		std::cout << std::setw(14) << name
+				  << std::setw(14) << inputs
+				  << std::fixed << std::setprecision(1)
+				  << std::setw(14) << t_full
+				  << std::setw(14) << t_incr << std::endl;
+
+		for (auto cell : cells) delete cell;
+	}
+}
+
+/**	\brief
+ *	Clock : Compare a clock edge over 1024 XOR gates (the clock and 8 registers each) with and without
+ *	skipping quiescent outputs, for several fractions of registers changing between edges.
+ */
+void benchmarkClockQuiescence(void) {
+	printBenchmarkHeader("Clock edge over 1024 gates (ns per edge)", { "active %", "tracking off", "tracking on", "skip ratio" });
+
+	const size_t gates = 1024, registers = 8;
+
+	for (size_t percent : { 0u, 10u, 100u }) {
+		Clock<16>							c(1.0F);
+		std::vector<MemoryCell<16>*>		cells;
+		std::vector<XORGate<16>*>			xors;
+		std::mt19937						random(42);
+		size_t								value = 0;
+
+		for (size_t i = 0; i < gates; ++i) {
+			xors.push_back(new XORGate<16>());
+			xors.back()->addInput(c);
+			for (size_t r = 0; r < registers; ++r) {
+				cells.push_back(new MemoryCell<16>(r));
+				xors.back()->addInput(*cells.back());
+			}
+		}
+
+		auto edge = [&]() {
+			for (size_t i = 0; i < gates; ++i)
+				if (random() % 100 < percent)
+					cells[i * registers]->setState(std::bitset<16>(++value));
+			c.tick();
+			_Benchmark_Sink = xors.back()->getState().test(0);
+		};
+
+		c.setQuiescenceTracking(false);
+		double t_off = benchmark(edge, 500);
+		c.setQuiescenceTracking(true);
+		c.resetQuiescence();
+		double t_on  = benchmark(edge, 500);
+
+		std::cout << std::setw(14) << percent
+				  << std::fixed << std::setprecision(1)
+				  << std::setw(14) << t_off
+				  << std::setw(14) << t_on
+				  << std::setprecision(3)
+				  << std::setw(14) << c.getQuiescence().getSkipRatio() << std::endl;
+
+		for (auto g : xors) delete g;
+		for (auto m : cells) delete m;
+	}
+}
+
+/**	\brief
+ *	VCD : Cost of probing 256 registers that change on every clock edge, with the VCD written in the background.
+ */
+void benchmarkVCD(void) {
+	printBenchmarkHeader("VCD probes on 256 registers (ns per edge)", { "buffer", "no probes", "probed", "changes" });
+
+	const size_t registers = 256, edges = 2000;
+	const std::string filename = "benchmarkVCD.vcd";
+
+	for (size_t buffered : { 256u, 4096u, 65536u }) {
+		Clock<16>						c(1e6F);
+		std::vector<MemoryCell<16>*>	cells;
+		size_t							value = 0;
+
+		for (size_t i = 0; i < registers; ++i)
+			cells.push_back(new MemoryCell<16>(i));
+
+		auto edge = [&]() {
+			++value;
+			for (auto cell : cells)
+				cell->setState(std::bitset<16>(value));
+			c.tick();
+		};
+
+		double t_plain = benchmark(edge, edges), t_probed;
+		size_t changes;
+		{
+			SynchrotronVCD<16> vcd(filename, buffered);
+			for (size_t i = 0; i < registers; ++i)
+				vcd.add(*cells[i], "r" + std::to_string(i));
+			vcd.setClock(c);
+
+			t_probed = benchmark(edge, edges);
+			vcd.close();
+			changes = vcd.getChangeCount();
+		}
+		std::remove(filename.c_str());
+
+		std::cout << std::setw(14) << buffered
+				  << std::fixed << std::setprecision(1)
+				  << std::setw(14) << t_plain
+				  << std::setw(14) << t_probed
+				  << std::setw(14) << changes << std::endl;
+
+		for (auto m : cells) delete m;
+	}
+}
+
+/**	\brief
+ *	TimingWheel : Hold model (pop the earliest event, schedule one later) with many pending events,
+ *	against a std::priority_queue (binary heap).
+ */
+void benchmarkTimingWheel(void) {
+	printBenchmarkHeader("Pending events, pop + schedule (ns per event)", { "pending", "binary heap", "timing wheel" });
+
+	typedef std::pair<SimTime, size_t> Event;
+
+	for (size_t pending : { 1000u, 100000u, 1000000u }) {
+		const size_t operations = 2000000;
+		std::mt19937 random(42);
+		std::priority_queue<Event, std::vector<Event>, std::greater<Event>> heap;
+		TimingWheel<size_t> wheel;
+		std::vector<size_t> due;
+		SimTime now = 0;
+
+		for (size_t i = 0; i < pending; ++i) {
+			const SimTime time = random() % 10000;
+			heap.push(Event(time, i));
+			wheel.schedule(time, i);
+		}
+
+		double t_heap = benchmark([&]() {
+			for (size_t i = 0; i < operations; ++i) {
+				now = heap.top().first;
+				_Benchmark_Sink = heap.top().second;
+				heap.pop();
+				heap.push(Event(now + 1 + random() % 10000, i));
+			}
+		}, 1) / operations;
+
+		double t_wheel = benchmark([&]() {
+			for (size_t i = 0; i < operations; ) {
+				wheel.pop(due);
+				for (auto value : due) {
+					_Benchmark_Sink = value;
+					wheel.schedule(wheel.now() + 1 + random() % 10000, i++);
+				}
+				due.clear();
+			}
+		}, 1) / operations;
+
+		std::cout << std::setw(14) << pending
+				  << std::fixed << std::setprecision(1)
+				  << std::setw(14) << t_heap
+				  << std::setw(14) << t_wheel << std::endl;
+	}
+}
+
+/**	\brief
+ *	SynchrotronTiming : Events per second through 256 chains of 64 XOR gates with mixed delays.
+ */
+void benchmarkTimingSimulation(void) {
+	printBenchmarkHeader("Timing simulation, 16k XOR gates (per stimulus)", { "us", "events", "Mevents/s" });
+
+	const size_t chains = 256, length = 64;
+	MemoryCell<16> head, other;
+	std::vector<XORGate<16>*> gates;
+
+	for (size_t c = 0; c < chains; ++c) {
+		SynchrotronComponent<16> *previous = &head;
+		for (size_t i = 0; i < length; ++i) {
+			gates.push_back(new XORGate<16>( {previous, &other} ));
+			previous = gates.back();
+		}
+	}
+
+	{
+		DelayTable table(10);
+		table.set<XORGate<16>>(35);
+		SynchrotronTiming<16> timing( {&head}, table );
+		size_t value = 0;
+
+		const size_t stimuli = 50;
+		double t = benchmark([&]() {
+			head.setState(std::bitset<16>(++value));
+			other.setState(std::bitset<16>(value * 7));
+		}, stimuli);
+		const double events = double(timing.getEventCount()) / (stimuli + 1);
+
+		std::cout << std::fixed << std::setprecision(1)
+				  << std::setw(14) << t / 1000.0
+				  << std::setw(14) << events
+				  << std::setw(14) << events / t * 1000.0 << std::endl;
+	}
+
+	for (auto g : gates) delete g;
+}
+
+/**	\brief
+ *	TimingAnalysis : Static critical path of random graphs, against only walking the graph (collectGraph()):
+ *	the analysis is a single pass, its cost per component follows that of the walk.
+ */
+void benchmarkTimingAnalysis(void) {
+	printBenchmarkHeader("Static timing analysis (ns per component)", { "components", "collectGraph", "analysis", "delay [ps]" });
+
+	for (size_t size : { 10000u, 100000u, 400000u }) {
+		const size_t registers = 256;
+		std::mt19937 random(42);
+		SynchrotronGraph<16> graph;
+		std::vector<SynchrotronComponent<16>*> nodes;
+
+		for (size_t i = 0; i < registers; ++i)
+			nodes.push_back(graph.create<MemoryCell<16>>());
+
+		// Every gate reads two random earlier components; every 64th drives a register that has no driver yet.
+		for (size_t i = registers; i < size; ++i) {
+			SynchrotronComponent<16> *gate;
+			switch (random() % 3) {
+				case 0:		gate = graph.create<ANDGate<16>>();	break;
+				case 1:		gate = graph.create<ORGate<16>>();	break;
+				default:	gate = graph.create<XORGate<16>>();	break;
+			}
+			gate->addInput(*nodes[random() % i]);
+			gate->addInput(*nodes[random() % i]);
+			nodes.push_back(gate);
+			if (i % 64 == 0 && nodes[i / 64 % registers]->getInputs().empty())
+				nodes[i / 64 % registers]->addInput(*gate);
+		}
+
+		SimTime delay = 0;
+		double t_walk = benchmark([&]() {
+			_Benchmark_Sink = collectGraph<16>(nodes).size();
+		}, 3) / size;
+		double t = benchmark([&]() {
+			CPUFactory::TimingAnalysis<16> analysis(nodes);
+			delay = analysis.getCriticalDelay();
+		}, 3) / size;
+
+		std::cout << std::setw(14) << size
+				  << std::fixed << std::setprecision(1)
+				  << std::setw(14) << t_walk
+				  << std::setw(14) << t
+				  << std::setw(14) << delay << std::endl;
+	}
+}
+
+/**	\brief
+ *	SynchrotronSubcircuit : A 16-bit ripple-carry adder instantiated from a hierarchical definition,
+ *	against the same gates wired by hand (build and evaluation).
+ */
+void benchmarkSubcircuit(void) {
+	printBenchmarkHeader("16-bit ripple-carry adder of full adders", { "", "build [ns]", "add [ns]" });
+
+	typedef SynchrotronSubcircuit<1> Subcircuit;
+	std::vector<MemoryCell<1>> cells(33);
+	std::vector<SynchrotronComponent<1>*> inputs;
+	for (auto& cell : cells)
+		inputs.push_back(&cell);
+
+	// The definition: 16 instances of a full adder.
+	Subcircuit full(3), adder(33);
+	{
+		const Subcircuit::Signal half = full.add<XORGate<1>>( {0, 1} );
+		full.output(full.add<XORGate<1>>( {half, 2} ));
+		full.output(full.add<ORGate<1>>( {full.add<ANDGate<1>>( {0, 1} ), full.add<ANDGate<1>>( {half, 2} )} ));
+
+		Subcircuit::Signal carry = 32;
+		std::vector<Subcircuit::Signal> sums;
+		for (size_t i = 0; i < 16; ++i) {
+			const std::vector<Subcircuit::Signal> out = adder.add(full, { i, 16 + i, carry });
+			sums.push_back(out[0]);
+			carry = out[1];
+		}
+		adder.output(sums).output(carry);
+	}
+
+	auto byHand = [&inputs](SynchrotronGraph<1>& graph) {
+		std::vector<SynchrotronComponent<1>*> out;
+		SynchrotronComponent<1> *carry = inputs[32];
+
+		for (size_t i = 0; i < 16; ++i) {
+			SynchrotronComponent<1> *a = inputs[i], *b = inputs[16 + i];
+			SynchrotronComponent<1> *half = graph.create<XORGate<1>>( {a, b} );
+			out.push_back(graph.create<XORGate<1>>( {half, carry} ));
+			carry = graph.create<ORGate<1>>( {graph.create<ANDGate<1>>( {a, b} ), graph.create<ANDGate<1>>( {half, carry} )} );
+		}
+		out.push_back(carry);
+		return out;
+	};
+
+	auto evaluate = [&cells](const std::vector<SynchrotronComponent<1>*>& sum) {
+		size_t value = 0;
+		return benchmark([&]() {
+			++value;
+			for (size_t i = 0; i < 32; ++i)
+				cells[i].setState(std::bitset<1>((value * 40503u >> i) & 1));
+			_Benchmark_Sink = sum[16]->getState().to_ulong();
+		}, 20000);
+	};
+
+	const size_t builds = 200;
+	for (bool flattened : { false, true }) {
+		SynchrotronGraph<1> graph;
+		std::vector<SynchrotronComponent<1>*> sum;
+
+		double t_build = benchmark([&]() {
+			sum = flattened ? adder.instantiate(graph, inputs) : byHand(graph);
+		}, builds);
+
+		std::cout << std::setw(14) << (flattened ? "flattened" : "by hand")
+				  << std::fixed << std::setprecision(1)
+				  << std::setw(14) << t_build;
+
+		// Evaluate a single instance.
+		graph.clear();
+		sum = flattened ? adder.instantiate(graph, inputs) : byHand(graph);
+		std::cout << std::setw(14) << evaluate(sum) << std::endl;
+	}
+}
+
+/**	\brief
+ *		Run all benchmarks.
+ */
+void runBenchmarks(void) {
+	std::cout << "Starting Benchmarks..." << std::endl;
+
+	benchmarkFanInIteration();
+
+	printBenchmarkHeader("8-input AND fold (ns per fold)", { "bit_width", "std::bitset", "NativeBitset", "ANDGate::tick" });
+	benchmarkStateWidth<8>();
+	benchmarkStateWidth<32>();
+	benchmarkStateWidth<64>();
+
+	printBenchmarkHeader("n-ary XOR gate (ns per input)", { "bit_width", "inputs", "bitset loop", "kernel" });
+	benchmarkGateKernel<64>();
+	benchmarkGateKernel<128>();
+	benchmarkGateKernel<256>();
+	benchmarkGateKernel<512>();
+
+	benchmarkBitSlice();
+	benchmarkParallelLevels();
+	benchmarkNetlistLoad();
+	benchmarkGraphTeardown();
+	benchmarkBulkConnect();
+	benchmarkSnapshot();
+	printBenchmarkHeader("One input changed on a 64-bit gate (ns per change)", { "gate", "inputs", "tick()", "tickInput()" });
+	benchmarkIncrementalGate<ANDGate<64>>("AND");
+	benchmarkIncrementalGate<XORGate<64>>("XOR");
+
+	benchmarkClockQuiescence();
+	benchmarkVCD();
+	benchmarkTimingWheel();
+	benchmarkTimingSimulation();
+	benchmarkTimingAnalysis();
+	benchmarkSubcircuit();
+
+	std::cout << std::endl << "Benchmarks finished." << std::endl;
+}
+
+#endif // BENCHMARK_HPP
@@ -0,0 +1,255 @@
+#ifndef BITSETKERNELS_HPP
+#define BITSETKERNELS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <bitset>
+
+#include "NativeBitset.hpp"
+
+#if defined(__AVX2__)
+	#include <immintrin.h>
+	#define BITSET_KERNELS_AVX2
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define BITSET_KERNELS_SSE2
+#endif
+#if defined(_MSC_VER)
+	#include <intrin.h>
+#endif
+
+namespace std {
+
+	/**	\brief	A 64-bit word that may alias the words of a std::bitset (whatever their declared type).
+	 */
+	#if defined(__GNUC__)
+		typedef uint64_t __attribute__((__may_alias__)) bitset_word;
+	#else
+		typedef uint64_t bitset_word;
+	#endif
+
+	/**	\brief	Whether std::bitset<bit_width> is stored as exactly its 64-bit words
+	 *			(true for libstdc++, libc++ and MSVC on 64-bit targets), so the kernels can address them.
+	 */
+	template <size_t bit_width>
+	struct BitsetWords {
+		static const size_t count = (bit_width + 63) / 64;
+		static const bool   contiguous = bit_width > 64 && sizeof(std::bitset<bit_width>) == count * sizeof(uint64_t);
+	};
+
+	/**	\brief	Returns the index of the lowest set bit of w (w must not be 0).
+	 */
+	inline size_t lowestSetBit(uint64_t w) {
+		#if defined(__GNUC__)
+			return size_t(__builtin_ctzll(w));
+		#elif defined(_MSC_VER) && defined(_M_X64)
+			unsigned long index;
+			_BitScanForward64(&index, w);
+			return size_t(index);
+		#else
+			size_t index = 0;
+			while (!(w & 1u)) { w >>= 1; ++index; }
+			return index;
+		#endif
+	}
+
+	/**	\brief	Call f(bit) for every set bit of bits, from the lowest up.
+	 */
+	template <size_t bit_width, class F>
+	inline void forEachSetBit(const NativeBitset<bit_width>& bits, F f) {
+		for (uint64_t w = bits.to_word(); w; w &= w - 1)
+			f(lowestSetBit(w));
+	}
+
+	template <size_t bit_width, class F>
+	inline void forEachSetBit(const std::bitset<bit_width>& bits, F f) {
+		for (size_t bit = 0; bit < bit_width; ++bit)
+			if (bits.test(bit)) f(bit);
+	}
+
+	/**	\brief	The operations of the n-ary fold kernels.
+	 *
+	 *		Each provides the scalar operation, the bitset operator and, when available, the SSE2 and AVX2 ones.
+	 *		(The scalar apply() doubles as the FoldVector operation without SSE2.)
+	 *		idempotent tells whether `x op x == x` (see CPUComponents::GateSummary).
+	 */
+	struct FoldAND {
+		static const bool idempotent = true;
+		static inline uint64_t apply(uint64_t a, uint64_t b)	{ return a & b; }
+		template <class B>
+		static inline void combine(B& a, const B& b)			{ a &= b; }
+		static inline uint64_t identity(void)					{ return ~uint64_t(0); }
+		#ifdef BITSET_KERNELS_SSE2
+			static inline __m128i apply(__m128i a, __m128i b)	{ return _mm_and_si128(a, b); }
+		#endif
+		#ifdef BITSET_KERNELS_AVX2
+			static inline __m256i apply(__m256i a, __m256i b)	{ return _mm256_and_si256(a, b); }
+		#endif
+	};
+
+	struct FoldOR {
+		static const bool idempotent = true;
+		static inline uint64_t apply(uint64_t a, uint64_t b)	{ return a | b; }
+		template <class B>
+		static inline void combine(B& a, const B& b)			{ a |= b; }
+		static inline uint64_t identity(void)					{ return 0; }
+		#ifdef BITSET_KERNELS_SSE2
+			static inline __m128i apply(__m128i a, __m128i b)	{ return _mm_or_si128(a, b); }
+		#endif
+		#ifdef BITSET_KERNELS_AVX2
+			static inline __m256i apply(__m256i a, __m256i b)	{ return _mm256_or_si256(a, b); }
+		#endif
+	};
+
+	struct FoldXOR {
+		static const bool idempotent = false;
+		static inline uint64_t apply(uint64_t a, uint64_t b)	{ return a ^ b; }
+		template <class B>
+		static inline void combine(B& a, const B& b)			{ a ^= b; }
+		static inline uint64_t identity(void)					{ return 0; }
+		#ifdef BITSET_KERNELS_SSE2
+			static inline __m128i apply(__m128i a, __m128i b)	{ return _mm_xor_si128(a, b); }
+		#endif
+		#ifdef BITSET_KERNELS_AVX2
+			static inline __m256i apply(__m256i a, __m256i b)	{ return _mm256_xor_si256(a, b); }
+		#endif
+	};
+
+	/**	\brief	The widest available vector of 64-bit words (chosen at compile time:
+	 *			`-mavx2` or `/arch:AVX2` enables AVX2, SSE2 is always present on x86-64, else scalar).
+	 */
+	struct FoldVector {
+		#if defined(BITSET_KERNELS_AVX2)
+			typedef __m256i type;
+			static const size_t lanes = 4;
+			static inline type load(const bitset_word *p)		{ return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+			static inline void store(bitset_word *p, type v)	{ _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+			static inline type broadcast(uint64_t w)			{ return _mm256_set1_epi64x((long long) w); }
+		#elif defined(BITSET_KERNELS_SSE2)
+			typedef __m128i type;
+			static const size_t lanes = 2;
+			static inline type load(const bitset_word *p)		{ return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+			static inline void store(bitset_word *p, type v)	{ _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+			static inline type broadcast(uint64_t w)			{ return _mm_set1_epi64x((long long) w); }
+		#else
+			typedef uint64_t type;
+			static const size_t lanes = 1;
+			static inline type load(const bitset_word *p)		{ return *p; }
+			static inline void store(bitset_word *p, type v)	{ *p = v; }
+			static inline type broadcast(uint64_t w)			{ return w; }
+		#endif
+	};
+
+	/**	\brief	Fold the words of every input into out: out = words(first[0]) op words(first[1]) op ...
+	 *
+	 *		The words are folded in blocks of two FoldVectors (then one, then a scalar tail;
+	 *		with AVX2 a remaining pair of words uses SSE2):
+	 *		one pass over the inputs per block, with the accumulators in registers, so out is written once.
+	 *
+	 *	\tparam	Op
+	 *		FoldAND, FoldOR or FoldXOR.
+	 *	\tparam	words
+	 *		The amount of 64-bit words per input.
+	 *	\param	out
+	 *		The words to write.
+	 *	\param	first, count
+	 *		A contiguous buffer of count inputs (e.g. the component pointers of a FlatSet).
+	 *	\param	wordsOf
+	 *		Returns the `const bitset_word*` of an input. With no inputs, out is Op::identity().
+	 */
+	template <class Op, size_t words, class Input, class Access>
+	inline void foldWords(bitset_word *out, const Input *first, size_t count, Access wordsOf) {
+		typedef FoldVector V;
+		size_t w = 0;
+
+		// Blocks of two vectors in named registers (an accumulator array is not kept in registers at -O2).
+		for (; w + 2 * V::lanes <= words; w += 2 * V::lanes) {
+			typename V::type a = V::broadcast(Op::identity()), b = a;
+
+			for (size_t i = 0; i < count; ++i) {
+				const bitset_word *in = wordsOf(first[i]) + w;
+				a = Op::apply(a, V::load(in));
+				b = Op::apply(b, V::load(in + V::lanes));
+			}
+
+			V::store(out + w, a);
+			V::store(out + w + V::lanes, b);
+		}
+
+		for (; w + V::lanes <= words; w += V::lanes) {
+			typename V::type a = V::broadcast(Op::identity());
+
+			for (size_t i = 0; i < count; ++i)
+				a = Op::apply(a, V::load(wordsOf(first[i]) + w));
+
+			V::store(out + w, a);
+		}
+
+		#if defined(BITSET_KERNELS_AVX2)
+			// Remaining pair of words (e.g. a 128-bit state) in an SSE2 register.
+			for (; w + 2 <= words; w += 2) {
+				__m128i a = _mm_set1_epi64x((long long) Op::identity());
+
+				for (size_t i = 0; i < count; ++i)
+					a = Op::apply(a, _mm_loadu_si128(reinterpret_cast<const __m128i*>(wordsOf(first[i]) + w)));
+
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out + w), a);
+			}
+		#endif
+
+		for (; w < words; ++w) {
+			uint64_t a = Op::identity();
+
+			for (size_t i = 0; i < count; ++i)
+				a = Op::apply(a, wordsOf(first[i])[w]);
+
+			out[w] = a;
+		}
+	}
+
+	/**	\brief	Fold the states of every component in inputs into state (an n-ary AND, OR or XOR).
+	 *
+	 *		Up to 64 bits, the state is one NativeBitset word and is folded directly.
+	 *		std::bitset states of 256 bits and more are folded by foldWords() directly from the contiguous
+	 *		input array; narrower ones (or a bitset layout that is not plain words) use the bitset
+	 *		operators, which the compiler already handles as well as the kernel at those widths.
+	 *
+	 *	\param	state
+	 *		The state to write.
+	 *	\param	inputs
+	 *		A FlatSet (or vector) of pointers to components with getNativeState(), e.g. getInputs().
+	 */
+	template <class Op, size_t bit_width, class Inputs>
+	inline typename enable_if<(bit_width <= 64)>::type foldStates(NativeBitset<bit_width>& state, const Inputs& inputs) {
+		typename NativeBitset<bit_width>::word_type acc = typename NativeBitset<bit_width>::word_type(Op::identity());
+
+		for (auto& connection : inputs)
+			acc = typename NativeBitset<bit_width>::word_type(Op::apply(acc, connection->getNativeState().to_word()));
+
+		state = NativeBitset<bit_width>(acc);
+	}
+
+	template <class Op, size_t bit_width, class Inputs>
+	inline typename enable_if<(bit_width > 64)>::type foldStates(std::bitset<bit_width>& state, const Inputs& inputs) {
+		if (!BitsetWords<bit_width>::contiguous || BitsetWords<bit_width>::count < 4) {
+			if (Op::identity()) state.set();
+			else				state.reset();
+
+			for (auto& connection : inputs)
+				Op::combine(state, connection->getNativeState());
+			return;
+		}
+
+		bitset_word *out = reinterpret_cast<bitset_word*>(&state);
+		foldWords<Op, BitsetWords<bit_width>::count>(out, inputs.data(), inputs.size(), [](typename Inputs::value_type connection) {
+			return reinterpret_cast<const bitset_word*>(&connection->getNativeState());
+		});
+
+		// Keep the bits above bit_width zero, as std::bitset requires (only AND of no inputs sets them).
+		if (bit_width % 64)
+			out[BitsetWords<bit_width>::count - 1] &= (uint64_t(1) << (bit_width % 64)) - 1;
+	}
+}
+
+#endif // BITSETKERNELS_HPP
@@ -119,26 +119,33 @@ namespace CPUComponents {
 					//throw Exceptions::Exception("[ERROR] ALUnit connectInternal requires tha ALU to have exactly 2 inputs!");
 					return;
 
-				std::initializer_list<SynchrotronComponent<bit_width>*> inputList
-						= { *this->getInputs().begin(), *this->getInputs().rbegin() };
+				// The operands in port order (port(0) is the left operand of SUB, DIV, ...).
+				SynchrotronComponent<bit_width> &left = this->port(0), &right = this->port(1);
+				std::initializer_list<SynchrotronComponent<bit_width>*> inputList = { &left, &right };
 
 				this->_AND.addInput(inputList);
 				this->_NAND.addInput(inputList);
 				this->_OR.addInput(inputList);
 				this->_NOR.addInput(inputList);
 				this->_XOR.addInput(inputList);
-				this->_NOT.addInput(**this->getInputs().begin());
+				this->_NOT.addInput(left);
 				this->_ADD.addInput(inputList);
 				this->_SUB.addInput(inputList);
 				this->_MUL.addInput(inputList);
 				this->_DIV.addInput(inputList);
 				this->_MOD.addInput(inputList);
-				this->_SHL.addInput(**this->getInputs().begin());
-				this->_SHR.addInput(**this->getInputs().begin());
+				this->_SHL.addInput(left);
+				this->_SHR.addInput(left);
 				this->_CMP.addInput(inputList);
 
-				this->removeInput(**this->getInputs().begin());
-				this->removeInput(**this->getInputs().begin());
+				this->removeInput(left);
+				this->removeInput(right);
+			}
+
+			/**	\brief	The result depends on the operation set with setOperation(), not only on the inputs.
+			 */
+			inline bool hasHiddenState(void) const {
+				return true;
 			}
 
 			/**	\brief	Set the operation/instruction to execute on tick().
@@ -171,27 +178,27 @@ namespace CPUComponents {
 			 *		Throws generic Exception when the requested operation is not an ALU operation.
 			 */
 			void tick(void) {
-				std::bitset<bit_width> prevState = this->state;
+				const std::StateBitset<bit_width> prevState = this->state;
 
 				switch(this->operation) {
 					// TO-DO : Replace "this->REG_FLAGS	= this->_AND.getFlags();"
 					//				by "this->REG_FLAGS	= this->_AND;"
 					//				or "this->REG_FLAGS	= (FlagRegister) this->_AND;"
 					//				instead?
-					case InstructionSet::AND:	this->state = this->_AND.getState();	this->setFlags(this->_AND.getFlags());	break;
-					case InstructionSet::NAND:	this->state = this->_NAND.getState();	this->setFlags(this->_NAND.getFlags());	break;
-					case InstructionSet::OR:	this->state = this->_OR.getState();		this->setFlags(this->_OR.getFlags()); 	break;
-					case InstructionSet::NOR:	this->state = this->_NOR.getState();	this->setFlags(this->_NOR.getFlags()); 	break;
-					case InstructionSet::XOR:	this->state = this->_XOR.getState();	this->setFlags(this->_XOR.getFlags());	break;
-					case InstructionSet::NOT:	this->state = this->_NOT.getState();	this->setFlags(this->_NOT.getFlags()); 	break;
-					case InstructionSet::ADD:	this->state = this->_ADD.getState();	this->setFlags(this->_ADD.getFlags());	break;
-					case InstructionSet::SUB:	this->state = this->_SUB.getState();	this->setFlags(this->_SUB.getFlags());	break;
-					case InstructionSet::MUL:	this->state = this->_MUL.getState();	this->setFlags(this->_MUL.getFlags());	break;
-					case InstructionSet::DIV:	this->state = this->_DIV.getState();	this->setFlags(this->_DIV.getFlags());	break;
-					case InstructionSet::MOD:	this->state = this->_MOD.getState();	this->setFlags(this->_MOD.getFlags());	break;
-					case InstructionSet::SHL:	this->state = this->_SHL.getState();	this->setFlags(this->_SHL.getFlags());	break;
-					case InstructionSet::SHR:	this->state = this->_SHR.getState();	this->setFlags(this->_SHR.getFlags());	break;
-					case InstructionSet::CMP:	this->state = this->_CMP.getState();	this->setFlags(this->_CMP.getFlags());	break;
+					case InstructionSet::AND:	this->state = this->_AND.getNativeState();	this->setFlags(this->_AND.getFlags());	break;
+					case InstructionSet::NAND:	this->state = this->_NAND.getNativeState();	this->setFlags(this->_NAND.getFlags());	break;
+					case InstructionSet::OR:	this->state = this->_OR.getNativeState();		this->setFlags(this->_OR.getFlags()); 	break;
+					case InstructionSet::NOR:	this->state = this->_NOR.getNativeState();	this->setFlags(this->_NOR.getFlags()); 	break;
+					case InstructionSet::XOR:	this->state = this->_XOR.getNativeState();	this->setFlags(this->_XOR.getFlags());	break;
+					case InstructionSet::NOT:	this->state = this->_NOT.getNativeState();	this->setFlags(this->_NOT.getFlags()); 	break;
+					case InstructionSet::ADD:	this->state = this->_ADD.getNativeState();	this->setFlags(this->_ADD.getFlags());	break;
+					case InstructionSet::SUB:	this->state = this->_SUB.getNativeState();	this->setFlags(this->_SUB.getFlags());	break;
+					case InstructionSet::MUL:	this->state = this->_MUL.getNativeState();	this->setFlags(this->_MUL.getFlags());	break;
+					case InstructionSet::DIV:	this->state = this->_DIV.getNativeState();	this->setFlags(this->_DIV.getFlags());	break;
+					case InstructionSet::MOD:	this->state = this->_MOD.getNativeState();	this->setFlags(this->_MOD.getFlags());	break;
+					case InstructionSet::SHL:	this->state = this->_SHL.getNativeState();	this->setFlags(this->_SHL.getFlags());	break;
+					case InstructionSet::SHR:	this->state = this->_SHR.getNativeState();	this->setFlags(this->_SHR.getFlags());	break;
+					case InstructionSet::CMP:	this->state = this->_CMP.getNativeState();	this->setFlags(this->_CMP.getFlags());	break;
 					case InstructionSet::NOP:	break;
 					default:
 						throw Exceptions::Exception("ALU: Unsupported Arithmetic or Logic operation!");
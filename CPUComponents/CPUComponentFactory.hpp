@@ -1,18 +1,155 @@
-//#ifndef CPUCOMPONENTFACTORY_HPP
-//#define CPUCOMPONENTFACTORY_HPP
+#ifndef CPUCOMPONENTFACTORY_HPP
+#define CPUCOMPONENTFACTORY_HPP
 
-//#include <bitset>
-//#include "../SignedBitset.hpp"
-//#include "../SynchrotronComponent.hpp"
-//#include "../ScottyCPU.hpp"
+#include <map>
+#include <string>
+#include <vector>
+#include <typeindex>
+#include <functional>
 
-//namespace CPUComponents {
+#include "../SynchrotronComponent.hpp"
+#include "ANDGate.hpp"
+#include "NANDGate.hpp"
+#include "ORGate.hpp"
+#include "NORGate.hpp"
+#include "XORGate.hpp"
+#include "NOTGate.hpp"
+#include "SHIFTLeft.hpp"
+#include "SHIFTRight.hpp"
+#include "ADD.hpp"
+#include "SUBTRACT.hpp"
+#include "MULTIPLY.hpp"
+#include "DIVIDE.hpp"
+#include "MODULO.hpp"
+#include "COMPERATOR.hpp"
+#include "MemoryCell.hpp"
+#include "../Exceptions.hpp"
+#include "../utils.hpp"
+using namespace Synchrotron;
 
-//	class CPUComponentFactory {
-//		public:
+namespace CPUComponents {
 
-//	};
+	/** \brief	**CPUComponentFactory** : Registry creating single components by type name.
+	 *
+	 *		All components with a `(size_t initial_value)` constructor are registered by default
+	 *		under their class name (SynchrotronComponent, ANDGate, ..., COMPERATOR, MemoryCell);
+	 *		others can be added with registerComponent(). Each bit_width has its own registry.
+	 *
+	 *	\tparam	bit_width
+	 *		This template argument specifies the width of the created components.
+	 */
+	template <size_t bit_width>
+	class CPUComponentFactory {
+		public:
+			/**	\brief	Creates a new component with the given initial state.
+			 */
+			typedef std::function<SynchrotronComponent<bit_width>*(size_t initial_value)> Creator;
 
-//}
+		private:
+			/**	\brief	The registered types.
+			 */
+			struct Registry {
+				std::map<std::string, Creator>			creators;	///< Creator per type name.
+				std::map<std::type_index, std::string>	names;		///< Type name per class.
 
-//#endif // CPUCOMPONENTFACTORY_HPP
+				Registry() {
+					CPUComponentFactory::add<SynchrotronComponent<bit_width>>(*this, "SynchrotronComponent");
+					CPUComponentFactory::add<ANDGate<bit_width>>	(*this, "ANDGate");
+					CPUComponentFactory::add<NANDGate<bit_width>>	(*this, "NANDGate");
+					CPUComponentFactory::add<ORGate<bit_width>>		(*this, "ORGate");
+					CPUComponentFactory::add<NORGate<bit_width>>	(*this, "NORGate");
+					CPUComponentFactory::add<XORGate<bit_width>>	(*this, "XORGate");
+					CPUComponentFactory::add<NOTGate<bit_width>>	(*this, "NOTGate");
+					CPUComponentFactory::add<SHIFTLeft<bit_width>>	(*this, "SHIFTLeft");
+					CPUComponentFactory::add<SHIFTRight<bit_width>>	(*this, "SHIFTRight");
+					CPUComponentFactory::add<ADD<bit_width>>		(*this, "ADD");
+					CPUComponentFactory::add<SUBTRACT<bit_width>>	(*this, "SUBTRACT");
+					CPUComponentFactory::add<MULTIPLY<bit_width>>	(*this, "MULTIPLY");
+					CPUComponentFactory::add<DIVIDE<bit_width>>		(*this, "DIVIDE");
+					CPUComponentFactory::add<MODULO<bit_width>>		(*this, "MODULO");
+					CPUComponentFactory::add<COMPERATOR<bit_width>>	(*this, "COMPERATOR");
+					CPUComponentFactory::add<MemoryCell<bit_width>>	(*this, "MemoryCell");
+				}
+			};
+
+			/**	\brief	Returns the registry of this bit_width (created with the defaults on first use).
+			 */
+			static Registry& registry(void) {
+				static Registry instance;
+				return instance;
+			}
+
+			/**	\brief	Register component class T under name.
+			 */
+			template <class T>
+			static void add(Registry& r, const std::string& name) {
+				r.creators[name] = [](size_t initial_value) -> SynchrotronComponent<bit_width>* {
+					return new T(initial_value);
+				};
+				r.names[std::type_index(typeid(T))] = name;
+			}
+
+		public:
+			/**	\brief	Register component class T under name (replacing any type registered under name).
+			 *
+			 *	\tparam	T
+			 *		A SynchrotronComponent<bit_width> with a `(size_t initial_value)` constructor.
+			 */
+			template <class T>
+			static void registerComponent(const std::string& name) {
+				add<T>(registry(), name);
+			}
+
+			/**	\brief	Whether a type is registered under name.
+			 */
+			static bool isRegistered(const std::string& name) {
+				return registry().creators.count(name) > 0;
+			}
+
+			/**	\brief	Returns the names of all registered types.
+			 */
+			static std::vector<std::string> getNames(void) {
+				std::vector<std::string> names;
+
+				for (auto& entry : registry().creators)
+					names.push_back(entry.first);
+
+				return names;
+			}
+
+			/**	\brief	Create a new component (delete it when done).
+			 *
+			 *	\param	name
+			 *		The registered type name.
+			 *	\param	initial_value
+			 *		The initial state.
+			 *	\exception	Exceptions::Exception
+			 *		Throws exception if no type is registered under name.
+			 */
+			static SynchrotronComponent<bit_width>* create(const std::string& name, size_t initial_value = 0) {
+				auto it = registry().creators.find(name);
+
+				if (it == registry().creators.end())
+					throw Exceptions::Exception("[ERROR] Unknown component type \"" + name + "\"!");
+
+				return it->second(initial_value);
+			}
+
+			/**	\brief	Returns the name the class of component is registered under.
+			 *
+			 *	\exception	Exceptions::Exception
+			 *		Throws exception if the class of component is not registered (e.g. an Instruction).
+			 */
+			static const std::string& getName(const SynchrotronComponent<bit_width>& component) {
+				auto it = registry().names.find(std::type_index(typeid(component)));
+
+				if (it == registry().names.end())
+					throw Exceptions::Exception("[ERROR] Component type \"" + std::type2name(component) + "\" is not registered!");
+
+				return it->second;
+			}
+	};
+
+}
+
+#endif // CPUCOMPONENTFACTORY_HPP
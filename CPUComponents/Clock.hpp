@@ -3,6 +3,7 @@
 
 #include <chrono>
 #include <thread>
+#include <vector>
 #include "../SynchrotronComponentFixedInput.hpp"
 #include "../Exceptions.hpp"
 
@@ -10,7 +11,29 @@ using namespace std::chrono;
 
 namespace CPUComponents {
 
+	/**	\brief	Quiescence statistics of a Clock: how many of its outputs were skipped on its edges.
+	 */
+	struct QuiescenceCounters {
+		size_t edges		= 0;	///< Clock edges (tick()s) with quiescence tracking.
+		size_t evaluated	= 0;	///< Outputs evaluated on those edges.
+		size_t skipped		= 0;	///< Outputs skipped as quiescent on those edges.
+
+		/**	\brief	Returns the fraction of outputs skipped (0 without edges).
+		 */
+		inline double getSkipRatio(void) const {
+			return this->evaluated + this->skipped ? double(this->skipped) / double(this->evaluated + this->skipped) : 0.0;
+		}
+	};
+
 	/** \brief	**Clock** : Generate a pulse on a certain frequency.
+	 *
+	 *		With quiescence tracking (default), an edge skips every output that was not updated (by a changed
+	 *		input) since its last evaluation on an edge, together with everything it would have driven:
+	 *		evaluating it again would produce the same state.
+	 *		Outputs with hasHiddenState() (e.g. the ControlUnit) are evaluated on every edge.
+	 *		In the ScottyCPU that is the only output: the ControlUnit drives the bus, the ALU buffer and the ALU
+	 *		by setting their states, not through the Clock, so tracking never skips anything there (skip ratio 0).
+	 *		It pays off for clocked gate-level netlists, where the Clock drives the gates directly.
 	 *
 	 *	\tparam	bit_width
 	 *		This template argument specifies the width of the in and output connections.
@@ -32,6 +55,72 @@ namespace CPUComponents {
 			 *	\brief	The clock period in nanoseconds.
 			 */
 			long long int period;
+
+			/**
+			 *	\brief	The amount of clock edges (tick()s) so far.
+			 */
+			unsigned long long cycles;
+
+			/**	\brief	The output and its update count after its last evaluation on an edge.
+			 */
+			struct Quiescence {
+				SynchrotronComponent<bit_width>	*component;
+				size_t							updates;
+			};
+
+			/**
+			 *	\brief	Whether tick() skips quiescent outputs.
+			 */
+			bool tracking;
+
+			/**
+			 *	\brief	The update count of each output (in output order).
+			 */
+			std::vector<Quiescence> quiescence;
+
+			/**
+			 *	\brief	The quiescence statistics.
+			 */
+			QuiescenceCounters counters;
+
+			/**	\brief	Evaluate every output (that is not quiescent, with tracking).
+			 *
+			 *		Outputs get a full update(), never tickInput(): the state of a clock returns to 0
+			 *		without an emit(), so no output may keep a summary of it (see GateSummary).
+			 */
+			void emitEdge(void) {
+				const auto &outputs = this->getOutputs();
+
+				if (this->getProbe())
+					this->getProbe()->sample(*this);
+
+				if (!this->tracking) {
+					for (auto& connection : outputs)
+						connection->update();
+					return;
+				}
+
+				++this->counters.edges;
+				if (this->quiescence.size() != outputs.size())
+					this->quiescence.assign(outputs.size(), Quiescence{ nullptr, 0 });
+
+				for (size_t i = 0; i < outputs.size(); ++i) {
+					SynchrotronComponent<bit_width> *component = outputs[i];
+					Quiescence &entry = this->quiescence[i];
+
+					if (entry.component == component && entry.updates == component->getUpdateCount()
+						&& !component->hasHiddenState()) {
+						++this->counters.skipped;
+						continue;
+					}
+
+					component->update();
+					++this->counters.evaluated;
+					entry.component = component;
+					entry.updates   = component->getUpdateCount();
+				}
+			}
+
 		public:
 			/**
 			 *	Default constructor
@@ -40,7 +129,7 @@ namespace CPUComponents {
 			 *			Frequency in Hz.
 			 */
 			Clock(float frequency)
-				: SynchrotronComponentFixedInput<bit_width, 0u>(0) {
+				: SynchrotronComponentFixedInput<bit_width, 0u>(0), cycles(0), tracking(true) {
 				this->setFrequency(frequency);
 				this->reset();
 			}
@@ -98,6 +187,51 @@ namespace CPUComponents {
 				return this->period / 1e9F;
 			}
 
+			/**
+			 *	\brief	Returns the amount of clock edges (tick()s) so far.
+			 */
+			inline unsigned long long getCycles(void) const {
+				return this->cycles;
+			}
+
+			/**
+			 *	\brief	Returns the simulated time in nanoseconds: the amount of edges times the period.
+			 *
+			 *			Edge n happens at n periods, so the states before the first edge are at time 0.
+			 */
+			inline unsigned long long getSimulatedTime(void) const {
+				return this->cycles * (unsigned long long) this->period;
+			}
+
+			/**
+			 *	\brief	Enable or disable skipping quiescent outputs (enabling starts with every output evaluated once).
+			 */
+			void setQuiescenceTracking(bool enable) {
+				this->tracking = enable;
+				this->quiescence.clear();
+			}
+
+			/**
+			 *	\brief	Returns whether quiescent outputs are skipped.
+			 */
+			bool getQuiescenceTracking(void) const {
+				return this->tracking;
+			}
+
+			/**
+			 *	\brief	Returns the quiescence statistics (see QuiescenceCounters::getSkipRatio()).
+			 */
+			const QuiescenceCounters& getQuiescence(void) const {
+				return this->counters;
+			}
+
+			/**
+			 *	\brief	Reset the quiescence statistics.
+			 */
+			void resetQuiescence(void) {
+				this->counters = QuiescenceCounters();
+			}
+
 			/**
 			 *	\brief	Reset the clock by setting the startTime to now().
 			 */
@@ -151,9 +285,17 @@ namespace CPUComponents {
 			/**	\brief	The tick() method will be called when this Gate's input issues an emit().
 			 */
 			inline void tick(void) {
+				++this->cycles;
 				this->state = 1;
-				this->emit();
+				// Outputs are evaluated directly, so fall back to emit() if a Propagator handles this clock.
+				if (this->isEnabled() && this->getPropagator() == nullptr)
+					this->emitEdge();
+				else
+					this->emit();
 				this->state = 0;
+				// The falling edge is not emitted, but a probe records it half a period after the rising one.
+				if (this->getProbe())
+					this->getProbe()->sample(*this, this->getSimulatedTime() + (unsigned long long) this->period / 2);
 				// Test load duration
 				//std::this_thread::sleep_for(milliseconds(245));
 			}
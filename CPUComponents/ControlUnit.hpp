@@ -86,7 +86,7 @@ namespace CPUComponents {
 				this->_BUS->setState(this->_REG->getData(REG_PROGRAM_COUNTER_ADDR));
 				this->_ALU_BUFFER->setState(std::bitset<bit_width>(1u));
 				//this->_BUS->tick();
-				this->_ALU->tick();
+				this->_ALU->update();
 
 				this->_REG->setData(REG_PROGRAM_COUNTER_ADDR, this->_ALU->getState());
 
@@ -169,6 +169,12 @@ namespace CPUComponents {
 				return this->_REG->getData(this->REG_INTRUCTION_REGISTER_ADDR);
 			}
 
+			/**	\brief	The CU steps through its program on every tick(), whatever its inputs.
+			 */
+			inline bool hasHiddenState(void) const {
+				return true;
+			}
+
 			/**	\brief	Gets amount of CU Registers.
 			 *
 			 *	\return	size_t
@@ -205,8 +211,8 @@ namespace CPUComponents {
 					this->_ALU->setOperation((InstructionSet) instr);
 					this->_BUS->setState(this->_REG->getData(REG_A_ADDR));
 					this->_ALU_BUFFER->setState(this->_REG->getData(REG_B_ADDR));
-					this->_BUS->tick();
-					this->_ALU->tick();
+					this->_BUS->update();
+					this->_ALU->update();
 
 					if (instr < UINT(InstructionSet::CMP)) { // instr != CMP, because CMP does not set the output state
 						this->_REG->setData(REG_A_ADDR, this->_ALU->getState());
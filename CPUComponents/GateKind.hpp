@@ -0,0 +1,75 @@
+#ifndef GATEKIND_HPP
+#define GATEKIND_HPP
+
+#include <typeinfo>
+
+#include "../SynchrotronComponent.hpp"
+#include "ANDGate.hpp"
+#include "NANDGate.hpp"
+#include "ORGate.hpp"
+#include "NORGate.hpp"
+#include "XORGate.hpp"
+#include "NOTGate.hpp"
+#include "SHIFTLeft.hpp"
+#include "SHIFTRight.hpp"
+#include "ADD.hpp"
+#include "SUBTRACT.hpp"
+#include "MULTIPLY.hpp"
+#include "MemoryCell.hpp"
+using namespace Synchrotron;
+
+namespace CPUComponents {
+
+	/**	\brief	The logic function a SynchrotronComponent applies on its inputs,
+	 *			for tools that evaluate a gate graph without calling tick().
+	 */
+	enum class GateKind : size_t {
+		SOURCE = 0,	///< No inputs or a MemoryCell: the state is set from outside the graph.
+		AND, NAND, OR, NOR, XOR, NOT,
+		SHL, SHR,	///< SHIFTLeft / SHIFTRight by one.
+		ADD, SUB, MUL,	///< Wrapping ADD, SUBTRACT (first input minus the others) and MULTIPLY.
+		ACCUMULATE,	///< A plain SynchrotronComponent: ORs its inputs into its own state (see SynchrotronComponent::tick()).
+		OTHER		///< Any other component (DIVIDE, MODULO, COMPERATOR, ALU...).
+	};
+
+	/**	\brief	Classify the given component.
+	 *
+	 *	\param	component
+	 *		The SynchrotronComponent to classify.
+	 *
+	 *	\return	GateKind
+	 *		Returns the logic function of component (Instructions derive from their gates and classify as such).
+	 */
+	template <size_t bit_width>
+	GateKind getGateKind(const SynchrotronComponent<bit_width>& component) {
+		const SynchrotronComponent<bit_width> *c = &component;
+
+		if (component.getInputs().empty() || dynamic_cast<const MemoryCell<bit_width>*>(c))
+			return GateKind::SOURCE;
+		if (dynamic_cast<const ANDGate<bit_width>*>(c))		return GateKind::AND;
+		if (dynamic_cast<const NANDGate<bit_width>*>(c))	return GateKind::NAND;
+		if (dynamic_cast<const ORGate<bit_width>*>(c))		return GateKind::OR;
+		if (dynamic_cast<const NORGate<bit_width>*>(c))		return GateKind::NOR;
+		if (dynamic_cast<const XORGate<bit_width>*>(c))		return GateKind::XOR;
+		if (dynamic_cast<const NOTGate<bit_width>*>(c))		return GateKind::NOT;
+		if (dynamic_cast<const SHIFTLeft<bit_width>*>(c))	return GateKind::SHL;
+		if (dynamic_cast<const SHIFTRight<bit_width>*>(c))	return GateKind::SHR;
+		if (dynamic_cast<const ADD<bit_width>*>(c))			return GateKind::ADD;
+		if (dynamic_cast<const SUBTRACT<bit_width>*>(c))	return GateKind::SUB;
+		if (dynamic_cast<const MULTIPLY<bit_width>*>(c))	return GateKind::MUL;
+		if (typeid(component) == typeid(SynchrotronComponent<bit_width>))
+			return GateKind::ACCUMULATE;
+
+		return GateKind::OTHER;
+	}
+
+	/**	\brief	Returns the name of the given GateKind.
+	 */
+	inline const char* getGateKindName(GateKind kind) {
+		static const char* const names[] = { "SOURCE", "AND", "NAND", "OR", "NOR", "XOR", "NOT",
+											   "SHL", "SHR", "ADD", "SUB", "MUL", "ACCUMULATE", "OTHER" };
+		return names[size_t(kind)];
+	}
+}
+
+#endif // GATEKIND_HPP
@@ -0,0 +1,133 @@
+#ifndef GATESUMMARY_HPP
+#define GATESUMMARY_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "../SynchrotronComponent.hpp"
+#include "../BitsetKernels.hpp"
+using namespace Synchrotron;
+
+namespace CPUComponents {
+
+	/** \brief	**GateSummary** : Summary of the inputs of an n-ary gate, to update its fold after one input changed.
+	 *
+	 *		The summary remembers the last state it saw of every input, and:
+	 *		*	for AND (and NAND) the amount of inputs with a 0, per bit: the result bit is 1 while it is zero;
+	 *		*	for OR (and NOR) the amount of inputs with a 1, per bit: the result bit is 1 while it is not zero;
+	 *		*	for XOR only the result itself, the running parity.
+	 *
+	 *		update() then only looks up the changed input and applies the difference between its old
+	 *		and new state, which costs about the same for 16 or 8000 inputs.
+	 *		It is rebuilt (a full fold) after invalidate() or when an input was connected or disconnected.
+	 *
+	 *	\tparam	bit_width
+	 *		This template argument specifies the width of the gate.
+	 *	\tparam	Op
+	 *		std::FoldAND, std::FoldOR or std::FoldXOR (see BitsetKernels.hpp).
+	 */
+	template <size_t bit_width, class Op>
+	class GateSummary {
+		public:
+			/**	\brief	Gates with less inputs than this are cheaper to fold again than to update incrementally.
+			 */
+			static const size_t threshold = 16;
+
+		private:
+			/**	\brief	The bit value that decides the result of an idempotent Op (0 for AND, 1 for OR).
+			 */
+			static inline bool dominant(void) {
+				return Op::identity() == 0;
+			}
+
+			/**	\brief	The last seen state of every input (in input order).
+			 */
+			std::vector<std::StateBitset<bit_width>> seen;
+
+			/**	\brief	Per bit, the amount of inputs with the dominant value (idempotent Op only).
+			 */
+			std::vector<uint32_t> counts;
+
+			/**	\brief	The fold of the seen states.
+			 */
+			std::StateBitset<bit_width> result;
+
+			/**	\brief	The getInputsVersion() of the gate the summary was built for.
+			 */
+			size_t version;
+
+			/**	\brief	Whether the summary matches the inputs (until invalidate()).
+			 */
+			bool valid;
+
+			/**	\brief	Build the summary from the current states of inputs.
+			 */
+			template <class Inputs>
+			void rebuild(const Inputs& inputs) {
+				this->seen.clear();
+				for (auto& connection : inputs)
+					this->seen.push_back(connection->getNativeState());
+
+				std::foldStates<Op>(this->result, inputs);
+
+				if (Op::idempotent) {
+					this->counts.assign(bit_width, 0);
+					for (auto& state : this->seen)
+						for (size_t bit = 0; bit < bit_width; ++bit)
+							this->counts[bit] += state.test(bit) == dominant();
+				}
+			}
+
+		public:
+			/**	\brief	Default constructor: the summary is built on the first update().
+			 */
+			GateSummary() : version(0), valid(false) {}
+
+			/**	\brief	Mark the summary as outdated, e.g. after the gate folded all inputs itself.
+			 */
+			inline void invalidate(void) {
+				this->valid = false;
+			}
+
+			/**	\brief	Update the summary after source, an input of gate, emitted.
+			 *
+			 *	\param	gate
+			 *		The gate the summary belongs to.
+			 *	\param	source
+			 *		The input that emitted.
+			 *
+			 *	\return	const std::StateBitset<bit_width>&
+			 *		Returns the fold of all inputs of gate.
+			 */
+			const std::StateBitset<bit_width>& update(const SynchrotronComponent<bit_width>& gate, const SynchrotronComponent<bit_width>& source) {
+				const auto &inputs = gate.getInputs();
+				const auto pos = inputs.find(const_cast<SynchrotronComponent<bit_width>*>(&source));
+
+				if (!this->valid || this->version != gate.getInputsVersion() || pos == inputs.end()) {
+					this->rebuild(inputs);
+					this->version = gate.getInputsVersion();
+					this->valid = true;
+					return this->result;
+				}
+
+				std::StateBitset<bit_width> &old = this->seen[pos - inputs.begin()];
+				const std::StateBitset<bit_width> &now = source.getNativeState();
+				if (old == now) return this->result;
+
+				if (Op::idempotent) {
+					std::forEachSetBit(old ^ now, [this, &now](size_t bit) {
+						if (now.test(bit) == dominant())	++this->counts[bit];
+						else								--this->counts[bit];
+						this->result.set(bit, this->counts[bit] ? dominant() : !dominant());
+					});
+				} else {
+					this->result ^= old ^ now;
+				}
+
+				old = now;
+				return this->result;
+			}
+	};
+}
+
+#endif // GATESUMMARY_HPP
@@ -57,17 +57,14 @@ namespace CPUComponents {
 					if (this->getInputs().size() < 2)
 						throw Exceptions::Exception("[ERROR] MODULO requires exactly 2 inputs!");
 				#endif
-				std::bitset<bit_width> prevState = this->state;
+				const std::StateBitset<bit_width> prevState = this->state;
 
 				//this->state.reset();	// Default non-destructive state for MODULO-operation
-				std::SignedBitset<bit_width + 1> current(0);
+				const auto &ports = this->getPorts();
+				std::SignedBitset<bit_width + 1> current(this->port(0).getState().to_ullong());
 
-				for(auto& connection : this->getInputs()) {
-					if (connection == *this->getInputs().begin())
-						current = connection->getState().to_ullong();
-					else
-						current %= std::SignedBitset<bit_width + 1>(connection->getState().to_ullong());
-				}
+				for(size_t i = 1; i < ports.size(); ++i)
+					current %= std::SignedBitset<bit_width + 1>(ports[i]->getState().to_ullong());
 
 				this->state = current.to_ullong();
 
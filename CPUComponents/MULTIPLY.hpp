@@ -59,16 +59,17 @@ namespace CPUComponents {
 					if (this->getInputs().size() < 2)
 						throw Exceptions::Exception("[ERROR] MULTIPLY requires at least 2 inputs!");
 				#endif
-				std::bitset<bit_width> prevState = this->state;
+				const std::StateBitset<bit_width> prevState = this->state;
 
 				//this->state.reset();	// Default non-destructive state for MULTIPLY-operation
-				std::SignedBitset<bit_width * 2 + 1> current(1);
+				// Two's complement wrap-around: the product modulo 2^bit_width is the same as with SignedBitset.
+				unsigned long long current = 1;
 
 				for(auto& connection : this->getInputs()) {
-					current *= std::SignedBitset<bit_width * 2 + 1>(connection->getState().to_ullong());
+					current *= connection->getNativeState().to_ullong();
 				}
 
-				this->state = current.to_ullong();
+				this->state = current;
 
 				if (prevState != this->state) this->emit();
 			}
@@ -31,9 +31,11 @@ namespace CPUComponents {
 	 *		This template argument specifies the width of the internal bitsets.
 	 *	\tparam	mem_size
 	 *		This template argument specifies the amount of internal bitsets.
+	 *	\tparam	lock_policy
+	 *		This template argument specifies how data access is synchronized (NullLock, SpinLock or MutexLock).
 	 */
-	template <size_t bit_width, size_t mem_size>
-	class Memory : public Mutex {
+	template <size_t bit_width, size_t mem_size, class lock_policy = SYNCHROTRON_LOCK_POLICY>
+	class Memory : public Mutex<lock_policy> {
 		private:
 			/**
 			 *	\brief	Array of `std::bitset` containing the memory data.
@@ -72,7 +74,7 @@ namespace CPUComponents {
 					if (mem_size - 1 > this->getMaxSize())
 						throw Exceptions::Exception("[ERROR] Memory size is to big: Insufficient adresses!");
 				#endif
-				LockBlock lock(this);
+				LockBlock<Memory> lock(this);
 
 				this->_memory = SysUtils::allocArray<std::bitset<bit_width>>(mem_size);
 			}
@@ -141,7 +143,7 @@ namespace CPUComponents {
 						//throw Exceptions::OutOfBoundsException("[ERROR] Memory address out of bounds!");
 						throw Exceptions::OutOfBoundsException(address.to_ulong());
 				#endif
-				LockBlock lock(this);
+				LockBlock<Memory> lock(this);
 				return this->_memory[address.to_ullong()];
 			}
 
@@ -170,7 +172,7 @@ namespace CPUComponents {
 					if (from.to_ulong() > to.to_ulong())
 						throw Exceptions::OutOfBoundsException(from.to_ulong());
 				#endif
-				LockBlock lock(this);
+				LockBlock<Memory> lock(this);
 				std::bitset<bit_width>* range = SysUtils::allocArray<std::bitset<bit_width>>(to.to_ulong() - from.to_ulong() + 1);
 
 				for (size_t i = from.to_ulong(); i <= to.to_ulong(); ++i)
@@ -179,6 +181,19 @@ namespace CPUComponents {
 				return range;
 			}
 
+			/**	\brief	Call f(address, data) for every address, taking the lock only once.
+			 *
+			 *	\param	f
+			 *		Called as f(size_t address, const std::bitset<bit_width>& data) in address order.
+			 */
+			template <class Function>
+			void forEachData(Function f) {
+				LockBlock<Memory> lock(this);
+
+				for (size_t address = 0; address < mem_size; ++address)
+					f(address, const_cast<const std::bitset<bit_width>&>(this->_memory[address]));
+			}
+
 			/**	\brief	Set data on a given address in the memory.
 			 *
 			 *	\param	address
@@ -197,7 +212,7 @@ namespace CPUComponents {
 						//throw Exceptions::OutOfBoundsException("[ERROR] Memory address out of bounds!");
 						throw Exceptions::OutOfBoundsException(address.to_ulong());
 				#endif
-				LockBlock lock(this);
+				LockBlock<Memory> lock(this);
 				this->_memory[address.to_ulong()] = data;
 			}
 
@@ -216,7 +231,7 @@ namespace CPUComponents {
 						//throw Exceptions::OutOfBoundsException("[ERROR] Memory address out of bounds!");
 						throw Exceptions::OutOfBoundsException(address.to_ulong());
 				#endif
-				LockBlock lock(this);
+				LockBlock<Memory> lock(this);
 				this->_memory[address.to_ulong()].reset();
 			}
 
@@ -1,24 +1,27 @@
 #ifndef MEMORYCELL_HPP
 #define MEMORYCELL_HPP
 
-#include "../SynchrotronComponentFixedInput.hpp"
+#include "../SynchrotronComponentEnable.hpp"
 #include "../Exceptions.hpp"
 using namespace Synchrotron;
 
 namespace CPUComponents {
 
 	/** \brief	**MemoryCell** : Save the state of a SynchrotronComponent.
+	 *
+	 *		With an enable line (see SynchrotronComponentEnable::setEnable()) it acts as a register
+	 *		driving a bus: while disabled it holds its state and emits nothing.
 	 *
 	 *	\tparam	bit_width
 	 *		This template argument specifies the width of the in and output connections.
 	 */
 	template <size_t bit_width>
-	class MemoryCell : public SynchrotronComponentFixedInput<bit_width, 1u> {
+	class MemoryCell : public SynchrotronComponentEnable<bit_width, 1u> {
 		public:
 			/**
 			 *	Default constructor
 			 */
-			MemoryCell(size_t initial_value = 0) : SynchrotronComponentFixedInput<bit_width, 1u>(initial_value) {}
+			MemoryCell(size_t initial_value = 0) : SynchrotronComponentEnable<bit_width, 1u>(initial_value) {}
 
 			/**	Copy constructor
 			 *	\param	other
@@ -27,7 +30,14 @@ namespace CPUComponents {
 			 *		Specifies whether to only copy inputs (false) or outputs as well (true).
 			 */
 			MemoryCell(const SynchrotronComponent<bit_width>& other, bool duplicateAll_IO = false)
-				: SynchrotronComponentFixedInput<bit_width, 1u>(other, duplicateAll_IO) {}
+				: SynchrotronComponentEnable<bit_width, 1u>(other, duplicateAll_IO) {}
+
+			/**	Copy constructor (the enable line is not copied)
+			 *	\param	other
+			 *		MemoryCell to copy the inputs from
+			 */
+			MemoryCell(const MemoryCell& other)
+				: MemoryCell(static_cast<const SynchrotronComponent<bit_width>&>(other)) {}
 
 			/**	\brief
 			 *	Connection constructor
@@ -41,7 +51,7 @@ namespace CPUComponents {
 			 */
 			MemoryCell(	std::initializer_list<SynchrotronComponent<bit_width>*> inputList,
 						std::initializer_list<SynchrotronComponent<bit_width>*> outputList = {} )
-									: SynchrotronComponentFixedInput<bit_width, 1u>(inputList, outputList) {}
+									: SynchrotronComponentEnable<bit_width, 1u>(inputList, outputList) {}
 
 			/**
 			 *	Default destructor
@@ -54,7 +64,7 @@ namespace CPUComponents {
 			 *		The state to set this' state to.
 			 */
 			void setState(const std::bitset<bit_width>& newstate) {
-				std::bitset<bit_width> prevState = this->state;
+				const std::StateBitset<bit_width> prevState = this->state;
 
 				this->state = newstate;
 
@@ -65,15 +75,7 @@ namespace CPUComponents {
 			 *		The tick() method will be called when one of this Gate's inputs issues an emit().
 			 */
 			void tick(void) {
-				//if (enabled) {
-//					std::bitset<bit_width> prevState = this->state;
-
-//					this->state = this->getInput().getState();
-
-//					if (prevState != this->state) this->emit();
-
-					this->emit();
-				//}
+				this->emit();
 			}
 	};
 }
@@ -2,6 +2,8 @@
 #define NORGATE_HPP
 
 #include "../SynchrotronComponent.hpp"
+#include "../BitsetKernels.hpp"
+#include "GateSummary.hpp"
 #include "../Exceptions.hpp"
 using namespace Synchrotron;
 
@@ -14,6 +16,11 @@ namespace CPUComponents {
 	 */
 	template <size_t bit_width>
 	class NORGate : public SynchrotronComponent<bit_width> {
+		private:
+			/**	\brief	The input summary for tickInput().
+			 */
+			GateSummary<bit_width, std::FoldOR> summary;
+
 		public:
 			/**
 			 *	Default constructor
@@ -58,14 +65,28 @@ namespace CPUComponents {
 					if (this->getInputs().size() < 2)
 						throw Exceptions::Exception("[ERROR] NORGate requires at least 2 inputs!");
 				#endif
-				std::bitset<bit_width> prevState = this->state;
+				const std::StateBitset<bit_width> prevState = this->state;
+
+				// n-ary OR of all inputs (vectorized for wide bit_widths, see BitsetKernels.hpp)
+				std::foldStates<std::FoldOR>(this->state, this->getInputs());
+				this->summary.invalidate();
+
+				this->state.flip();
 
-				this->state.reset();	// Default non-destructive state for OR-operation
+				if (prevState != this->state) this->emit();
+			}
 
-				for(auto& connection : this->getInputs()) {
-					this->state |= connection->getState();
+			/**	\brief	The tickInput() method will be called when only source issued an emit():
+			 *			updates the state from the old and new state of source (see GateSummary).
+			 */
+			void tickInput(const SynchrotronComponent<bit_width>& source) {
+				if (this->getInputs().size() < GateSummary<bit_width, std::FoldOR>::threshold) {
+					this->tick();
+					return;
 				}
+				const std::StateBitset<bit_width> prevState = this->state;
 
+				this->state = this->summary.update(*this, source);
 				this->state.flip();
 
 				if (prevState != this->state) this->emit();
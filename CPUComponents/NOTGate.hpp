@@ -56,9 +56,9 @@ namespace CPUComponents {
 					if (this->getInputs().size() == 0)
 						throw Exceptions::Exception("[ERROR] NOTGate requires 1 input!");
 				#endif
-				std::bitset<bit_width> prevState = this->state;
+				const std::StateBitset<bit_width> prevState = this->state;
 
-				this->state = this->getInput().getState().flip();
+				this->state = ~this->getInput().getNativeState();
 
 				if (prevState != this->state) this->emit();
 			}
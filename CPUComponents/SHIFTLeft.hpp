@@ -58,9 +58,9 @@ namespace CPUComponents {
 					if (this->getInputs().size() == 0)
 						throw Exceptions::Exception("[ERROR] SHIFTLeft requires 1 input!");
 				#endif
-				std::bitset<bit_width> prevState = this->state;
+				const std::StateBitset<bit_width> prevState = this->state;
 
-				this->state = this->getInput().getState() << 1;
+				this->state = this->getInput().getNativeState() << 1;
 
 				if (prevState != this->state) this->emit();
 			}
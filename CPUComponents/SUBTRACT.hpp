@@ -59,19 +59,17 @@ namespace CPUComponents {
 					if (this->getInputs().size() < 2)
 						throw Exceptions::Exception("[ERROR] SUBTRACT requires at least 2 inputs!");
 				#endif
-				std::bitset<bit_width> prevState = this->state;
+				const std::StateBitset<bit_width> prevState = this->state;
 
 				// Default non-destructive state for SUBTRACT-operation
-				std::SignedBitset<bit_width> current;
+				// Two's complement wrap-around: the difference modulo 2^bit_width is the same as with SignedBitset.
+				const auto &ports = this->getPorts();
+				unsigned long long current = this->port(0).getNativeState().to_ullong();
 
-				for(auto& connection : this->getInputs()) {
-					if (connection == *this->getInputs().begin())
-						current = connection->getState().to_ullong();
-					else
-						current -= std::SignedBitset<bit_width>(connection->getState().to_ullong());
-				}
+				for(size_t i = 1; i < ports.size(); ++i)
+					current -= ports[i]->getNativeState().to_ullong();
 
-				this->state = current.to_ullong();
+				this->state = current;
 
 				if (prevState != this->state) this->emit();
 			}
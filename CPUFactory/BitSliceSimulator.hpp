@@ -0,0 +1,258 @@
+#ifndef BITSLICESIMULATOR_HPP
+#define BITSLICESIMULATOR_HPP
+
+#include <cstdint>
+#include <vector>
+#include <unordered_map>
+#include <initializer_list>
+
+#include "../SynchrotronComponent.hpp"
+#include "../SynchrotronNetlist.hpp"
+#include "../CPUComponents/GateKind.hpp"
+#include "../Exceptions.hpp"
+using namespace CPUComponents;
+
+namespace CPUFactory {
+
+	/**
+	 *	\brief	**BitSliceSimulator** :
+	 *			Evaluates a graph of 1-bit gates for 64 independent input vectors at once.
+	 *
+	 *		Every signal is a uint64_t in which bit `l` is the value of that signal in simulation lane `l`,
+	 *		so one pass over the levelized graph with plain word operations (`&`, `|`, `^`, `~`)
+	 *		does the work of 64 tick() propagations. Meant for exhaustively verifying small
+	 *		combinational circuits (adders, comparators...) built from gates.
+	 *
+	 *		Supported are the 1-bit AND, NAND, OR, NOR, XOR and NOT gates (and their Instructions),
+	 *		plain SynchrotronComponents (OR-accumulate, as their tick()) and sources:
+	 *		components without inputs or MemoryCells, whose lanes are set with setLanes().
+	 *		The components themselves are only read, never ticked or changed.
+	 */
+	class BitSliceSimulator {
+		public:
+			/**	\brief	The amount of simulation lanes evaluated per pass.
+			 */
+			static constexpr size_t LANES = 64;
+
+		private:
+			/**	\brief	All components in topological order.
+			 */
+			std::vector<SynchrotronComponent<1>*> nodes;
+
+			/**	\brief	The logic function of each node.
+			 */
+			std::vector<GateKind> kinds;
+
+			/**	\brief	Offset of the inputs of each node in inputs (CSR, nodes.size() + 1 entries).
+			 */
+			std::vector<size_t> inputOffsets;
+
+			/**	\brief	Node positions of the inputs of each node (CSR).
+			 */
+			std::vector<size_t> inputs;
+
+			/**	\brief	The 64 lanes of every node.
+			 */
+			std::vector<uint64_t> values;
+
+			/**	\brief	Position of each component in nodes.
+			 */
+			std::unordered_map<const SynchrotronComponent<1>*, size_t> index;
+
+			/**	\brief	Returns the position of component in nodes.
+			 *
+			 *	\exception	Exceptions::Exception
+			 *		Throws exception if the component is not part of this simulator.
+			 */
+			inline size_t position(const SynchrotronComponent<1>& component) const {
+				auto it = this->index.find(&component);
+
+				if (it == this->index.end())
+					throw Exceptions::Exception("[ERROR] Component is not part of this BitSliceSimulator!");
+
+				return it->second;
+			}
+
+		public:
+			/**	\brief	Default constructor (empty graph).
+			 */
+			BitSliceSimulator() {}
+
+			/**	\brief	Compile constructor
+			 *
+			 *	\param	roots
+			 *		Any components of the graph; everything connected to them is included.
+			 */
+			BitSliceSimulator(std::initializer_list<SynchrotronComponent<1>*> roots) {
+				this->compile(roots);
+			}
+
+			/**	\brief	Default destructor
+			 */
+			~BitSliceSimulator() {}
+
+			/**	\brief	Levelize the gate graph connected to roots and load every lane with the current states.
+			 *
+			 *	\param	roots
+			 *		Any components of the graph; everything connected to them is included.
+			 *	\exception	Exceptions::Exception
+			 *		Throws exception if the graph contains a combinational loop or an unsupported component.
+			 */
+			template <class Iterable>
+			void compile(const Iterable& roots) {
+				std::vector<size_t> levelOffsets;
+				std::vector<SynchrotronComponent<1>*> sorted = levelize<1>(roots, levelOffsets);
+
+				this->nodes.swap(sorted);
+				this->kinds.clear();
+				this->inputOffsets.assign(1, 0);
+				this->inputs.clear();
+				this->index.clear();
+
+				for (size_t pos = 0; pos < this->nodes.size(); ++pos)
+					this->index[this->nodes[pos]] = pos;
+
+				for (auto node : this->nodes) {
+					const GateKind kind = getGateKind(*node);
+
+					if (kind > GateKind::NOT && kind != GateKind::ACCUMULATE)
+						throw Exceptions::Exception("[ERROR] BitSliceSimulator only supports 1-bit logic gates!");
+
+					this->kinds.push_back(kind);
+
+					if (kind != GateKind::SOURCE)
+						for (auto& connection : node->getInputs())
+							this->inputs.push_back(this->index[connection]);
+					this->inputOffsets.push_back(this->inputs.size());
+				}
+
+				this->reset();
+			}
+
+			/**	\brief	Levelize the gate graph connected to roots and load every lane with the current states.
+			 *
+			 *	\param	roots
+			 *		Any components of the graph; everything connected to them is included.
+			 */
+			void compile(std::initializer_list<SynchrotronComponent<1>*> roots) {
+				this->compile<std::initializer_list<SynchrotronComponent<1>*>>(roots);
+			}
+
+			/**	\brief	Load all 64 lanes of every node with the node's current state.
+			 */
+			void reset(void) {
+				this->values.resize(this->nodes.size());
+
+				for (size_t pos = 0; pos < this->nodes.size(); ++pos)
+					this->values[pos] = this->nodes[pos]->getState().test(0) ? ~uint64_t(0) : 0;
+			}
+
+			/**	\brief	Set the lanes of a source.
+			 *
+			 *	\param	source
+			 *		A component without inputs or a MemoryCell.
+			 *	\param	lanes
+			 *		Bit `l` is the value of source in lane `l`.
+			 *	\exception	Exceptions::Exception
+			 *		Throws exception if source is not a source of this simulator.
+			 */
+			void setLanes(const SynchrotronComponent<1>& source, uint64_t lanes) {
+				const size_t pos = this->position(source);
+
+				if (this->kinds[pos] != GateKind::SOURCE)
+					throw Exceptions::Exception("[ERROR] Only the lanes of a source can be set!");
+
+				this->values[pos] = lanes;
+			}
+
+			/**	\brief	Load the sources so that lane `l` holds input vector `first + l`.
+			 *
+			 *		Bit `j` of an input vector is the value of sources[j],
+			 *		so calling this with first = 0, 64, 128... enumerates every input combination.
+			 *
+			 *	\param	sources
+			 *		The sources, least significant first.
+			 *	\param	first
+			 *		The input vector in lane 0.
+			 */
+			void setExhaustive(const std::vector<SynchrotronComponent<1>*>& sources, uint64_t first) {
+				for (size_t j = 0; j < sources.size(); ++j) {
+					uint64_t lanes = 0;
+
+					for (size_t l = 0; l < LANES; ++l)
+						lanes |= (j < 64 ? ((first + l) >> j) & 1u : 0) << l;
+
+					this->setLanes(*sources[j], lanes);
+				}
+			}
+
+			/**	\brief	Evaluate every non-source node once, in topological order, for all 64 lanes.
+			 */
+			void evaluate(void) {
+				for (size_t pos = 0; pos < this->nodes.size(); ++pos) {
+					const size_t *in  = this->inputs.data() + this->inputOffsets[pos],
+								 *end = this->inputs.data() + this->inputOffsets[pos + 1];
+					uint64_t lanes;
+
+					switch (this->kinds[pos]) {
+						case GateKind::AND:
+						case GateKind::NAND:
+							lanes = ~uint64_t(0);
+							for (; in != end; ++in) lanes &= this->values[*in];
+							this->values[pos] = this->kinds[pos] == GateKind::AND ? lanes : ~lanes;
+							break;
+						case GateKind::OR:
+						case GateKind::NOR:
+							lanes = 0;
+							for (; in != end; ++in) lanes |= this->values[*in];
+							this->values[pos] = this->kinds[pos] == GateKind::OR ? lanes : ~lanes;
+							break;
+						case GateKind::XOR:
+							lanes = 0;
+							for (; in != end; ++in) lanes ^= this->values[*in];
+							this->values[pos] = lanes;
+							break;
+						case GateKind::NOT:
+							this->values[pos] = ~this->values[*in];
+							break;
+						case GateKind::ACCUMULATE:
+							for (; in != end; ++in) this->values[pos] |= this->values[*in];
+							break;
+						default:
+							break;
+					}
+				}
+			}
+
+			/**	\brief	Returns the 64 lanes of component (bit `l` is its value in lane `l`).
+			 *
+			 *	\exception	Exceptions::Exception
+			 *		Throws exception if the component is not part of this simulator.
+			 */
+			inline uint64_t getLanes(const SynchrotronComponent<1>& component) const {
+				return this->values[this->position(component)];
+			}
+
+			/**	\brief	Returns the value of component in the given lane.
+			 */
+			inline bool getLane(const SynchrotronComponent<1>& component, size_t lane) const {
+				return (this->getLanes(component) >> lane) & 1u;
+			}
+
+			/**	\brief	Returns the amount of components in the simulator.
+			 */
+			inline size_t size(void) const {
+				return this->nodes.size();
+			}
+
+			/**	\brief	Returns all components in topological order.
+			 */
+			inline const std::vector<SynchrotronComponent<1>*>& getNodes(void) const {
+				return this->nodes;
+			}
+	};
+
+	constexpr size_t BitSliceSimulator::LANES;
+}
+
+#endif // BITSLICESIMULATOR_HPP
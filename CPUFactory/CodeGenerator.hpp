@@ -0,0 +1,262 @@
+#ifndef CODEGENERATOR_HPP
+#define CODEGENERATOR_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <sstream>
+#include <iostream>
+
+#include "LogicGraph.hpp"
+#include "../NativeBitset.hpp"
+#include "../Exceptions.hpp"
+
+namespace CPUFactory {
+
+	/**
+	 *	\brief	**CodeGenerator** :
+	 *			Emits a LogicGraph as one straight-line C++ function over plain integers.
+	 *
+	 *		Every node becomes one local variable, assigned in topological order; there is no
+	 *		virtual tick(), no iteration over inputs and no emit(). The generated function is:
+	 *
+	 *			inline void name(const word_type *in, word_type *state, word_type *out)
+	 *
+	 *		*	in:    the variables (see getInputs()), read once.
+	 *		*	state: the persistent state of plain SynchrotronComponents (see getInitialState()).
+	 *		*	out:   the observed components (see getOutputs()), written once.
+	 *
+	 *		Paste the output into any translation unit that includes <cstdint> and check it
+	 *		against the live graph with countMismatches().
+	 *
+	 *	\tparam	bit_width
+	 *		This template argument specifies the width of the components in the graph (up to 64).
+	 */
+	template <size_t bit_width>
+	class CodeGenerator {
+		public:
+			typedef typename std::NativeWord<bit_width>::type word_type;
+
+		private:
+			/**	\brief	The graph to generate.
+			 */
+			const LogicGraph<bit_width> &graph;
+
+			/**	\brief	The node of each in[] entry.
+			 */
+			std::vector<size_t> inputNodes;
+
+			/**	\brief	The node of each state[] entry.
+			 */
+			std::vector<size_t> stateNodes;
+
+			/**	\brief	The components of each out[] entry.
+			 */
+			std::vector<const SynchrotronComponent<bit_width>*> outputs;
+
+			/**	\brief	The components of each in[] entry.
+			 */
+			std::vector<const SynchrotronComponent<bit_width>*> inputs;
+
+			/**	\brief	Returns the C++ name of word_type.
+			 */
+			static inline const char* typeName(void) {
+				return sizeof(word_type) == 1 ? "uint8_t"
+					 : sizeof(word_type) == 2 ? "uint16_t"
+					 : sizeof(word_type) == 4 ? "uint32_t" : "uint64_t";
+			}
+
+			/**	\brief	Returns value as a C++ hexadecimal literal (without suffix).
+			 */
+			static inline std::string hex(uint64_t value) {
+				std::stringstream ss;
+				ss << "0x" << std::hex << std::uppercase << value;
+				return ss.str();
+			}
+
+			/**	\brief	Returns the operands of a node joined by op, each optionally cast.
+			 */
+			static std::string join(const std::vector<size_t>& operands, const char *op, const char *cast = "") {
+				std::stringstream ss;
+
+				for (size_t i = 0; i < operands.size(); ++i)
+					ss << (i ? op : "") << cast << (*cast ? "(n" : "n") << operands[i] << (*cast ? ")" : "");
+
+				return ss.str();
+			}
+
+			/**	\brief	Whether kind can set bits above bit_width (and has to be masked).
+			 */
+			static inline bool masked(GateKind kind) {
+				return kind != GateKind::AND && kind != GateKind::OR
+					&& kind != GateKind::XOR && kind != GateKind::SHR;
+			}
+
+			/**	\brief	Returns the expression a gate node computes, before masking.
+			 */
+			static std::string expression(GateKind kind, const std::vector<size_t>& in) {
+				switch (kind) {
+					case GateKind::AND:		return join(in, " & ");
+					case GateKind::NAND:	return "~(" + join(in, " & ") + ")";
+					case GateKind::OR:		return join(in, " | ");
+					case GateKind::NOR:		return "~(" + join(in, " | ") + ")";
+					case GateKind::XOR:		return join(in, " ^ ");
+					case GateKind::NOT:		return "~" + join(in, "");
+					case GateKind::SHL:		return join(in, "") + " << 1";
+					case GateKind::SHR:		return join(in, "") + " >> 1";
+					// Arithmetic in 64 bits, as the components do (no signed int promotion overflow).
+					case GateKind::ADD:		return join(in, " + ", "uint64_t");
+					case GateKind::SUB:		return join(in, " - ", "uint64_t");
+					case GateKind::MUL:		return join(in, " * ", "uint64_t");
+					default:				return "0";
+				}
+			}
+
+		public:
+			/**	\brief	Assign the in[], state[] and out[] entries of graph.
+			 *
+			 *	\param	graph
+			 *		The (optimized) graph to generate; must outlive this CodeGenerator.
+			 */
+			explicit CodeGenerator(const LogicGraph<bit_width>& graph) : graph(graph) {
+				const auto &nodes = graph.getNodes();
+
+				for (size_t pos = 0; pos < nodes.size(); ++pos) {
+					if (!nodes[pos].alive) continue;
+
+					if (nodes[pos].kind == GateKind::SOURCE && !nodes[pos].constant) {
+						this->inputNodes.push_back(pos);
+						this->inputs.push_back(nodes[pos].origin);
+					} else if (nodes[pos].kind == GateKind::ACCUMULATE) {
+						this->stateNodes.push_back(pos);
+					}
+				}
+
+				// Observed components, including the ones that were replaced by another node.
+				for (auto& node : nodes)
+					if (node.observed && graph.getNodes()[graph.getNode(*node.origin)].alive)
+						this->outputs.push_back(node.origin);
+			}
+
+			/**	\brief	Returns the component of each in[] entry.
+			 */
+			inline const std::vector<const SynchrotronComponent<bit_width>*>& getInputs(void) const {
+				return this->inputs;
+			}
+
+			/**	\brief	Returns the component of each out[] entry.
+			 */
+			inline const std::vector<const SynchrotronComponent<bit_width>*>& getOutputs(void) const {
+				return this->outputs;
+			}
+
+			/**	\brief	Returns the state[] the generated function starts from (the states when the graph was built).
+			 */
+			std::vector<word_type> getInitialState(void) const {
+				std::vector<word_type> state;
+
+				for (auto pos : this->stateNodes)
+					state.push_back(word_type(this->graph.getValues()[pos].to_ullong()));
+
+				return state;
+			}
+
+			/**	\brief	Write the evaluation function of the graph.
+			 *
+			 *	\param	os
+			 *		The stream to write to.
+			 *	\param	name
+			 *		The name of the function.
+			 */
+			void generate(std::ostream& os, const std::string& name) const {
+				const auto &nodes  = this->graph.getNodes();
+				const auto &values = this->graph.getValues();
+				const std::string type = typeName(),
+								  mask = bit_width < 8 * sizeof(word_type)
+									   ? " & " + hex(uint64_t(std::NativeWord<bit_width>::mask)) : "";
+
+				os << "/**\tGenerated by CPUFactory::CodeGenerator<" << bit_width << "> from "
+				   << this->graph.getNodeCount() << " nodes and " << this->graph.getEdgeCount() << " edges.\n"
+				   << " *\tin[" << this->inputs.size() << "], state[" << this->stateNodes.size()
+				   << "], out[" << this->outputs.size() << "]\n */\n"
+				   << "inline void " << name << "(const " << type << " *in, " << type << " *state, " << type << " *out) {\n";
+
+				if (this->stateNodes.empty())
+					os << "\t(void) state;\n";
+
+				for (size_t i = 0; i < this->inputNodes.size(); ++i)
+					os << "\tconst " << type << " n" << this->inputNodes[i] << " = in[" << i << "];\n";
+
+				for (size_t pos = 0, s = 0; pos < nodes.size(); ++pos) {
+					const auto &node = nodes[pos];
+
+					if (!node.alive || (node.kind == GateKind::SOURCE && !node.constant)) continue;
+
+					os << "\tconst " << type << " n" << pos << " = ";
+
+					if (node.constant) {
+						os << hex(uint64_t(values[pos].to_ullong())) << "u;\n";
+					} else if (node.kind == GateKind::ACCUMULATE) {
+						os << "state[" << s << "] = " << type << "(state[" << s << "] | " << join(node.inputs, " | ") << ");\n";
+						++s;
+					} else {
+						os << type << "(" << (masked(node.kind) ? "(" + expression(node.kind, node.inputs) + ")" + mask
+																: expression(node.kind, node.inputs)) << ");\n";
+					}
+				}
+
+				for (size_t i = 0; i < this->outputs.size(); ++i)
+					os << "\tout[" << i << "] = n" << this->graph.getNode(*this->outputs[i]) << ";\n";
+
+				os << "}\n";
+			}
+
+			/**	\brief	Returns the evaluation function of the graph.
+			 */
+			std::string generate(const std::string& name) const {
+				std::stringstream ss;
+				this->generate(ss, name);
+				return ss.str();
+			}
+
+			/**	\brief	Run a generated function on the current states of the inputs
+			 *			and compare its out[] with the current states of the outputs.
+			 *
+			 *	\param	evaluator
+			 *		The generated function (or anything callable as it).
+			 *	\param	state
+			 *		The state[] to pass (starts as getInitialState()).
+			 *
+			 *	\return	size_t
+			 *		Returns the amount of outputs whose state differs from the generated result.
+			 */
+			template <class Function>
+			size_t countMismatches(Function evaluator, std::vector<word_type>& state) const {
+				std::vector<word_type> in, out(this->outputs.size());
+				size_t mismatches = 0;
+
+				for (auto component : this->inputs)
+					in.push_back(word_type(component->getNativeState().to_ullong()));
+
+				if (state.size() < this->stateNodes.size())
+					throw Exceptions::Exception("[ERROR] The state does not match the generated function!");
+
+				evaluator(in.data(), state.data(), out.data());
+
+				for (size_t i = 0; i < this->outputs.size(); ++i)
+					mismatches += out[i] != this->outputs[i]->getNativeState().to_ullong();
+
+				return mismatches;
+			}
+
+			/**	\brief	Run a generated function, starting from getInitialState(), and compare its result.
+			 */
+			template <class Function>
+			size_t countMismatches(Function evaluator) const {
+				std::vector<word_type> state = this->getInitialState();
+				return this->countMismatches(evaluator, state);
+			}
+	};
+}
+
+#endif // CODEGENERATOR_HPP
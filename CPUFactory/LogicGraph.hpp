@@ -0,0 +1,650 @@
+#ifndef LOGICGRAPH_HPP
+#define LOGICGRAPH_HPP
+
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <algorithm>
+#include <initializer_list>
+
+#include "../SynchrotronComponent.hpp"
+#include "../NativeBitset.hpp"
+#include "../CPUComponents/GateKind.hpp"
+#include "../Exceptions.hpp"
+using namespace CPUComponents;
+
+namespace CPUFactory {
+
+	/**
+	 *	\brief	**LogicGraph** :
+	 *			A frozen copy of a SynchrotronComponent graph that can be optimized and evaluated
+	 *			without touching (or ticking) the components themselves.
+	 *
+	 *		Every component becomes one node with its GateKind and its inputs (in port order).
+	 *		The optimizer passes rewrite the nodes only, never the components:
+	 *		*	foldConstants():                  evaluate gates whose result does not depend on a variable.
+	 *		*	eliminateBuffers():               bypass single-input gates and double negation.
+	 *		*	eliminateCommonSubexpressions():  merge gates with the same function and inputs.
+	 *		*	removeDeadNodes():                drop nodes no observed node depends on.
+	 *
+	 *		Components without inputs are constants unless marked with setVariable().
+	 *		MemoryCells and components the optimizer does not understand (GateKind::OTHER)
+	 *		are variables whose value is read from the component on evaluate(): a MemoryCell
+	 *		does not forward its input, its consumers read the state that was set on it.
+	 *		The inputs of those components are always observed.
+	 *
+	 *	\tparam	bit_width
+	 *		This template argument specifies the width of the components in the graph.
+	 */
+	template <size_t bit_width>
+	class LogicGraph {
+		public:
+			/**	\brief	The result of one optimizer pass.
+			 */
+			struct PassReport {
+				std::string	name;			///< The name of the pass.
+				size_t		nodesRemoved;	///< The amount of nodes the pass removed.
+				size_t		edgesRemoved;	///< The amount of edges (inputs) the pass removed.
+			};
+
+			/**	\brief	One node of the graph.
+			 */
+			struct Node {
+				GateKind							kind;		///< The logic function (SOURCE for constants and variables).
+				bool								constant;	///< Whether value never changes.
+				bool								observed;	///< Whether the value must be kept (sinks, setObserved(), inputs of variables).
+				bool								alive;		///< Whether the node was not removed.
+				std::vector<size_t>					inputs;		///< The nodes this node reads, in port order.
+				const SynchrotronComponent<bit_width>	*origin;	///< The component this node was built from.
+			};
+
+		private:
+			/**	\brief	Every node, in topological order.
+			 */
+			std::vector<Node> nodes;
+
+			/**	\brief	The current value of every node.
+			 */
+			std::vector<std::StateBitset<bit_width>> values;
+
+			/**	\brief	The node that replaces each node (itself if not replaced).
+			 */
+			mutable std::vector<size_t> forward;
+
+			/**	\brief	Position of each component in nodes.
+			 */
+			std::unordered_map<const SynchrotronComponent<bit_width>*, size_t> index;
+
+			/**	\brief	Whether the inputs of kind may be reordered.
+			 */
+			static inline bool isCommutative(GateKind kind) {
+				return kind != GateKind::SUB && kind != GateKind::NOT
+					&& kind != GateKind::SHL && kind != GateKind::SHR;
+			}
+
+			/**	\brief	Whether kind is a pure function of its inputs (no state, no variable).
+			 */
+			static inline bool isPure(GateKind kind) {
+				return kind != GateKind::SOURCE && kind != GateKind::ACCUMULATE;
+			}
+
+			/**	\brief	Returns the node that currently stands for node pos.
+			 */
+			size_t resolve(size_t pos) const {
+				size_t root = pos;
+
+				while (this->forward[root] != root)
+					root = this->forward[root];
+				while (this->forward[pos] != root) {
+					const size_t next = this->forward[pos];
+					this->forward[pos] = root;
+					pos = next;
+				}
+
+				return root;
+			}
+
+			/**	\brief	Replace node pos by node by: every consumer of pos reads by instead.
+			 *
+			 *	\return	size_t
+			 *		Returns the amount of edges removed (the inputs of pos).
+			 */
+			size_t replace(size_t pos, size_t by) {
+				Node &node = this->nodes[pos];
+				const size_t edges = node.inputs.size();
+
+				this->forward[pos] = by;
+				node.alive = false;
+				node.inputs.clear();
+
+				return edges;
+			}
+
+			/**	\brief	Point every input at the node that currently stands for it.
+			 */
+			void canonicalize(void) {
+				for (auto& node : this->nodes)
+					for (auto& in : node.inputs)
+						in = this->resolve(in);
+			}
+
+			/**	\brief	Returns the value of a kind node with the given inputs.
+			 */
+			std::StateBitset<bit_width> compute(GateKind kind, const std::vector<size_t>& inputs,
+												const std::StateBitset<bit_width>& previous) const {
+				std::StateBitset<bit_width> value;
+				unsigned long long current = 0;
+
+				switch (kind) {
+					case GateKind::AND:
+					case GateKind::NAND:
+						value.set();
+						for (auto in : inputs) value &= this->values[in];
+						return kind == GateKind::AND ? value : ~value;
+					case GateKind::OR:
+					case GateKind::NOR:
+						for (auto in : inputs) value |= this->values[in];
+						return kind == GateKind::OR ? value : ~value;
+					case GateKind::XOR:
+						for (auto in : inputs) value ^= this->values[in];
+						return value;
+					case GateKind::NOT:
+						return ~this->values[inputs.front()];
+					case GateKind::SHL:
+						return this->values[inputs.front()] << 1;
+					case GateKind::SHR:
+						return this->values[inputs.front()] >> 1;
+					case GateKind::ADD:
+						for (auto in : inputs) current += this->values[in].to_ullong();
+						return std::StateBitset<bit_width>(current);
+					case GateKind::SUB:
+						for (size_t i = 0; i < inputs.size(); ++i)
+							current = i ? current - this->values[inputs[i]].to_ullong() : this->values[inputs[i]].to_ullong();
+						return std::StateBitset<bit_width>(current);
+					case GateKind::MUL:
+						current = 1;
+						for (auto in : inputs) current *= this->values[in].to_ullong();
+						return std::StateBitset<bit_width>(current);
+					case GateKind::ACCUMULATE:
+						value = previous;
+						for (auto in : inputs) value |= this->values[in];
+						return value;
+					default:
+						return previous;
+				}
+			}
+
+			/**	\brief	Make node pos a constant with its current inputs evaluated.
+			 *
+			 *	\return	size_t
+			 *		Returns the amount of edges removed.
+			 */
+			size_t makeConstant(size_t pos) {
+				Node &node = this->nodes[pos];
+				const size_t edges = node.inputs.size();
+
+				this->values[pos] = this->compute(node.kind, node.inputs, this->values[pos]);
+				node.kind	  = GateKind::SOURCE;
+				node.constant = true;
+				node.inputs.clear();
+
+				return edges;
+			}
+
+			/**	\brief	Remove the constants in dropped from the inputs of node pos.
+			 *
+			 *	\return	size_t
+			 *		Returns the amount of edges removed.
+			 */
+			template <class Predicate>
+			size_t dropInputs(size_t pos, Predicate dropped) {
+				std::vector<size_t> &inputs = this->nodes[pos].inputs;
+				const size_t before = inputs.size();
+
+				inputs.erase(std::remove_if(inputs.begin(), inputs.end(), [&](size_t in) {
+					return this->nodes[in].constant && dropped(this->values[in]);
+				}), inputs.end());
+
+				return before - inputs.size();
+			}
+
+			/**	\brief	Whether any input of node pos is a constant for which absorbing holds.
+			 */
+			template <class Predicate>
+			bool anyInput(size_t pos, Predicate absorbing) const {
+				for (auto in : this->nodes[pos].inputs)
+					if (this->nodes[in].constant && absorbing(this->values[in]))
+						return true;
+				return false;
+			}
+
+			/**	\brief	Remove every node that no observed node depends on.
+			 *
+			 *	\param	constantsOnly
+			 *		Only remove constants.
+			 *	\return	PassReport
+			 *		Returns the amount of nodes and edges removed.
+			 */
+			PassReport sweep(const char *name, bool constantsOnly) {
+				PassReport report = { name, 0, 0 };
+				std::vector<bool> needed(this->nodes.size(), false);
+
+				// Reverse topological order: a node is needed when it is observed or read by a needed node
+				// (when only removing constants, every other node is needed).
+				for (size_t pos = this->nodes.size(); pos-- > 0;) {
+					const Node &node = this->nodes[pos];
+
+					if (!node.alive) {
+						// Replaced by an earlier node, which stands in for it.
+						if (node.observed) needed[this->resolve(pos)] = true;
+						continue;
+					}
+					if (node.observed || (constantsOnly && !node.constant)) needed[pos] = true;
+					if (needed[pos])
+						for (auto in : node.inputs)
+							needed[this->resolve(in)] = true;
+				}
+
+				for (size_t pos = 0; pos < this->nodes.size(); ++pos) {
+					Node &node = this->nodes[pos];
+
+					if (!node.alive || needed[pos] || (constantsOnly && !node.constant)) continue;
+
+					report.edgesRemoved += node.inputs.size();
+					++report.nodesRemoved;
+					node.alive = false;
+					node.inputs.clear();
+				}
+
+				return report;
+			}
+
+			/**	\brief	Build the nodes of every component connected to roots.
+			 */
+			template <class Iterable>
+			void build(const Iterable& roots) {
+				const std::vector<SynchrotronComponent<bit_width>*> components = collectGraph<bit_width>(roots);
+				std::unordered_map<const SynchrotronComponent<bit_width>*, size_t> id;
+				std::vector<GateKind> kinds(components.size());
+				std::vector<size_t> inDegree(components.size(), 0), ready;
+
+				for (size_t i = 0; i < components.size(); ++i)
+					id[components[i]] = i;
+
+				for (size_t i = 0; i < components.size(); ++i) {
+					kinds[i] = getGateKind(*components[i]);
+					if (kinds[i] == GateKind::OTHER) kinds[i] = GateKind::SOURCE;
+					if (kinds[i] != GateKind::SOURCE) inDegree[i] = components[i]->getInputs().size();
+					if (!inDegree[i]) ready.push_back(i);
+				}
+
+				// Kahn's algorithm on the edges into non-sources.
+				for (size_t r = 0; r < ready.size(); ++r)
+					for (auto& connection : components[ready[r]]->getOutputs()) {
+						const size_t o = id[connection];
+						if (kinds[o] != GateKind::SOURCE && !--inDegree[o]) ready.push_back(o);
+					}
+
+				if (ready.size() != components.size())
+					throw Exceptions::Exception("[ERROR] Cannot build a LogicGraph of a graph with combinational loops!");
+
+				this->nodes.clear();
+				this->values.clear();
+				this->index.clear();
+
+				for (auto i : ready) {
+					this->index[components[i]] = this->nodes.size();
+					this->nodes.push_back({ kinds[i], components[i]->getInputs().empty()
+													  && !dynamic_cast<const MemoryCell<bit_width>*>(components[i]),
+											components[i]->getOutputs().empty(), true, {}, components[i] });
+				}
+
+				for (auto& node : this->nodes) {
+					if (node.kind == GateKind::SOURCE) {
+						// Variables that read their inputs themselves: keep what they read.
+						for (auto& connection : node.origin->getInputs())
+							this->nodes[this->index[connection]].observed = true;
+					} else {
+						for (auto& connection : node.origin->getPorts())
+							node.inputs.push_back(this->index[connection]);
+					}
+					this->values.push_back(node.origin->getNativeState());
+				}
+
+				this->forward.resize(this->nodes.size());
+				for (size_t pos = 0; pos < this->nodes.size(); ++pos)
+					this->forward[pos] = pos;
+			}
+
+			/**	\brief	Returns the node of component.
+			 *
+			 *	\exception	Exceptions::Exception
+			 *		Throws exception if the component is not part of this LogicGraph.
+			 */
+			inline size_t position(const SynchrotronComponent<bit_width>& component) const {
+				auto it = this->index.find(&component);
+
+				if (it == this->index.end())
+					throw Exceptions::Exception("[ERROR] Component is not part of this LogicGraph!");
+
+				return it->second;
+			}
+
+		public:
+			/**	\brief	Build constructor
+			 *
+			 *	\param	roots
+			 *		Any iterable of SynchrotronComponent<bit_width>*; everything connected to them is included.
+			 *	\exception	Exceptions::Exception
+			 *		Throws exception if the graph contains a combinational loop.
+			 */
+			template <class Iterable>
+			explicit LogicGraph(const Iterable& roots) {
+				this->build(roots);
+			}
+
+			/**	\brief	Build constructor
+			 *
+			 *	\param	roots
+			 *		Any components of the graph; everything connected to them is included.
+			 */
+			explicit LogicGraph(std::initializer_list<SynchrotronComponent<bit_width>*> roots) {
+				this->build(roots);
+			}
+
+			/**	\brief	Default destructor
+			 */
+			~LogicGraph() {}
+
+			/**	\brief	Mark sources whose state is changed from outside the graph (e.g. the inputs of a circuit).
+			 *			Call before optimizing.
+			 *
+			 *	\exception	Exceptions::Exception
+			 *		Throws exception if a component is not part of this LogicGraph or has inputs.
+			 */
+			void setVariable(std::initializer_list<const SynchrotronComponent<bit_width>*> sources) {
+				for (auto source : sources) {
+					Node &node = this->nodes[this->position(*source)];
+
+					if (!node.origin->getInputs().empty())
+						throw Exceptions::Exception("[ERROR] Only components without inputs can be variable!");
+
+					node.constant = false;
+				}
+			}
+
+			/**	\brief	Mark components whose value must be kept (in addition to the sinks).
+			 *			Call before optimizing.
+			 *
+			 *	\exception	Exceptions::Exception
+			 *		Throws exception if a component is not part of this LogicGraph.
+			 */
+			void setObserved(std::initializer_list<const SynchrotronComponent<bit_width>*> components) {
+				for (auto component : components)
+					this->nodes[this->position(*component)].observed = true;
+			}
+
+			/**	\brief	Evaluate every pure gate whose inputs are all constants and simplify gates with
+			 *			constant inputs: absorbing inputs (0 for AND, ones for OR, 0 for MUL) fold the gate,
+			 *			identity inputs (ones for AND, 0 for OR, XOR, ADD and later SUB inputs, 1 for MUL) are dropped.
+			 *			Constants that are no longer read are removed.
+			 */
+			PassReport foldConstants(void) {
+				const std::StateBitset<bit_width> one(1u);
+				auto zero  = [](const std::StateBitset<bit_width>& v) { return v.none(); };
+				auto ones  = [](const std::StateBitset<bit_width>& v) { return v.all();  };
+				auto unit  = [&one](const std::StateBitset<bit_width>& v) { return v == one; };
+				size_t edges = 0;
+
+				this->canonicalize();
+
+				for (size_t pos = 0; pos < this->nodes.size(); ++pos) {
+					Node &node = this->nodes[pos];
+
+					if (!node.alive || node.kind == GateKind::SOURCE) continue;
+
+					bool absorbed = false;
+					switch (node.kind) {
+						case GateKind::AND: case GateKind::NAND:
+							absorbed = this->anyInput(pos, zero);
+							if (!absorbed) edges += this->dropInputs(pos, ones);
+							break;
+						case GateKind::OR: case GateKind::NOR:
+							absorbed = this->anyInput(pos, ones);
+							if (!absorbed) edges += this->dropInputs(pos, zero);
+							break;
+						case GateKind::XOR: case GateKind::ADD:
+							edges += this->dropInputs(pos, zero);
+							break;
+						case GateKind::MUL:
+							absorbed = this->anyInput(pos, zero);
+							if (!absorbed) edges += this->dropInputs(pos, unit);
+							break;
+						case GateKind::SUB:
+							if (node.inputs.size() > 1) {
+								const size_t first = node.inputs.front();
+								node.inputs.erase(node.inputs.begin());
+								edges += this->dropInputs(pos, zero);
+								node.inputs.insert(node.inputs.begin(), first);
+							}
+							break;
+						default:
+							break;
+					}
+
+					// An absorbing input decides the result whatever the other inputs are.
+					bool constant = absorbed;
+					if (!constant) {
+						constant = true;
+						for (auto in : node.inputs)
+							constant &= this->nodes[in].constant;
+					}
+
+					if (constant)
+						edges += this->makeConstant(pos);
+				}
+
+				PassReport report = this->sweep("foldConstants", true);
+				report.edgesRemoved += edges;
+				return report;
+			}
+
+			/**	\brief	Bypass single-input AND, OR, XOR, ADD, SUB and MUL gates and double negation (NOT of a NOT);
+			 *			single-input NAND and NOR gates become NOTs.
+			 */
+			PassReport eliminateBuffers(void) {
+				PassReport report = { "eliminateBuffers", 0, 0 };
+
+				this->canonicalize();
+
+				for (size_t pos = 0; pos < this->nodes.size(); ++pos) {
+					Node &node = this->nodes[pos];
+
+					if (!node.alive || node.inputs.size() != 1) continue;
+
+					const size_t in = this->resolve(node.inputs.front());
+
+					switch (node.kind) {
+						case GateKind::AND: case GateKind::OR: case GateKind::XOR:
+						case GateKind::ADD: case GateKind::SUB: case GateKind::MUL:
+							report.edgesRemoved += this->replace(pos, in);
+							++report.nodesRemoved;
+							break;
+						case GateKind::NAND: case GateKind::NOR:
+							node.kind = GateKind::NOT;
+							// fall through
+						case GateKind::NOT:
+							if (this->nodes[in].kind == GateKind::NOT) {
+								report.edgesRemoved += this->replace(pos, this->resolve(this->nodes[in].inputs.front()));
+								++report.nodesRemoved;
+							}
+							break;
+						default:
+							break;
+					}
+				}
+
+				this->canonicalize();
+				return report;
+			}
+
+			/**	\brief	Merge constants with the same value and pure gates with the same kind and inputs
+			 *			(in any order for commutative gates) into the first one.
+			 */
+			PassReport eliminateCommonSubexpressions(void) {
+				PassReport report = { "eliminateCommonSubexpressions", 0, 0 };
+				std::map<std::pair<GateKind, std::vector<size_t>>, size_t> gates;
+				std::map<std::string, size_t> constants;
+
+				this->canonicalize();
+
+				for (size_t pos = 0; pos < this->nodes.size(); ++pos) {
+					Node &node = this->nodes[pos];
+					size_t first = pos;
+
+					if (!node.alive) continue;
+
+					if (node.constant) {
+						first = constants.insert(std::make_pair(this->values[pos].to_string(), pos)).first->second;
+					} else if (isPure(node.kind)) {
+						std::vector<size_t> key;
+						for (auto in : node.inputs)
+							key.push_back(this->resolve(in));
+						if (isCommutative(node.kind))
+							std::sort(key.begin(), key.end());
+
+						first = gates.insert(std::make_pair(std::make_pair(node.kind, key), pos)).first->second;
+					}
+
+					if (first != pos) {
+						report.edgesRemoved += this->replace(pos, first);
+						++report.nodesRemoved;
+					}
+				}
+
+				this->canonicalize();
+				return report;
+			}
+
+			/**	\brief	Remove every node that no observed node depends on.
+			 */
+			PassReport removeDeadNodes(void) {
+				return this->sweep("removeDeadNodes", false);
+			}
+
+			/**	\brief	Run all passes until a round removes nothing.
+			 *
+			 *	\return	std::vector<PassReport>
+			 *		Returns the total per pass, in the order the passes run.
+			 */
+			std::vector<PassReport> optimize(void) {
+				std::vector<PassReport> total;
+				size_t removed;
+
+				do {
+					const PassReport round[] = { this->foldConstants(), this->eliminateBuffers(),
+												 this->eliminateCommonSubexpressions(), this->removeDeadNodes() };
+					removed = 0;
+
+					for (size_t i = 0; i < 4; ++i) {
+						if (total.size() <= i) total.push_back({ round[i].name, 0, 0 });
+						total[i].nodesRemoved += round[i].nodesRemoved;
+						total[i].edgesRemoved += round[i].edgesRemoved;
+						removed += round[i].nodesRemoved + round[i].edgesRemoved;
+					}
+				} while (removed);
+
+				return total;
+			}
+
+			/**	\brief	Evaluate every node once, in topological order.
+			 *			Variables read the current state of their component.
+			 */
+			void evaluate(void) {
+				for (size_t pos = 0; pos < this->nodes.size(); ++pos) {
+					const Node &node = this->nodes[pos];
+
+					if (!node.alive || node.constant) continue;
+
+					if (node.kind == GateKind::SOURCE)
+						this->values[pos] = node.origin->getNativeState();
+					else
+						this->values[pos] = this->compute(node.kind, node.inputs, this->values[pos]);
+				}
+			}
+
+			/**	\brief	Returns the value of component after the last evaluate() (through the node that replaced it).
+			 *
+			 *	\exception	Exceptions::Exception
+			 *		Throws exception if the component is not part of this LogicGraph or its node was removed.
+			 */
+			std::StateBitset<bit_width> getValue(const SynchrotronComponent<bit_width>& component) const {
+				const size_t pos = this->resolve(this->position(component));
+
+				if (!this->nodes[pos].alive)
+					throw Exceptions::Exception("[ERROR] The node of this component was removed from the LogicGraph!");
+
+				return this->values[pos];
+			}
+
+			/**	\brief	Compare the value of every component that still has a node with its current state.
+			 *
+			 *	\return	size_t
+			 *		Returns the amount of components whose state differs from the evaluated value.
+			 */
+			size_t countMismatches(void) const {
+				size_t mismatches = 0;
+
+				for (size_t pos = 0; pos < this->nodes.size(); ++pos) {
+					const size_t by = this->resolve(pos);
+
+					if (this->nodes[by].alive && this->values[by] != this->nodes[pos].origin->getNativeState())
+						++mismatches;
+				}
+
+				return mismatches;
+			}
+
+			/**	\brief	Returns the amount of nodes that were not removed.
+			 */
+			size_t getNodeCount(void) const {
+				size_t count = 0;
+				for (auto& node : this->nodes)
+					count += node.alive;
+				return count;
+			}
+
+			/**	\brief	Returns the amount of edges (inputs) of the nodes that were not removed.
+			 */
+			size_t getEdgeCount(void) const {
+				size_t count = 0;
+				for (auto& node : this->nodes)
+					count += node.inputs.size();
+				return count;
+			}
+
+			/**	\brief	Returns the value of every node (by position in getNodes()) after the last evaluate().
+			 */
+			inline const std::vector<std::StateBitset<bit_width>>& getValues(void) const {
+				return this->values;
+			}
+
+			/**	\brief	Returns every node (including removed ones), in topological order.
+			 */
+			inline const std::vector<Node>& getNodes(void) const {
+				return this->nodes;
+			}
+
+			/**	\brief	Returns the node that currently stands for component.
+			 *
+			 *	\exception	Exceptions::Exception
+			 *		Throws exception if the component is not part of this LogicGraph.
+			 */
+			inline size_t getNode(const SynchrotronComponent<bit_width>& component) const {
+				return this->resolve(this->position(component));
+			}
+	};
+}
+
+#endif // LOGICGRAPH_HPP
@@ -0,0 +1,611 @@
+#ifndef NETLISTFILE_HPP
+#define NETLISTFILE_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <bitset>
+#include <sstream>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+
+#ifdef _WIN32
+	#include <windows.h>
+#else
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+#include "../SynchrotronComponent.hpp"
+#include "../SynchrotronBuilder.hpp"
+#include "../CPUComponents/CPUComponentFactory.hpp"
+#include "../Exceptions.hpp"
+#include "../utils.hpp"
+using namespace CPUComponents;
+
+namespace CPUFactory {
+
+	/**	\brief	**MappedFile** : A read-only memory mapping of a whole file.
+	 */
+	class MappedFile {
+		private:
+			const char	*bytes;
+			size_t		length;
+
+			#ifdef _WIN32
+				HANDLE	file, mapping;
+			#endif
+
+		public:
+			/**	\brief	Map the given file.
+			 *
+			 *	\param	filename
+			 *		The (path and) name of the file to map.
+			 *	\exception	FileReadException
+			 *		Throws FileReadException if the file could not be mapped.
+			 */
+			explicit MappedFile(const std::string& filename) : bytes(nullptr), length(0) {
+				#ifdef _WIN32
+					this->mapping = nullptr;
+					this->file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+											 OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+					if (this->file == INVALID_HANDLE_VALUE)
+						throw Exceptions::FileReadException(filename);
+
+					LARGE_INTEGER size;
+					GetFileSizeEx(this->file, &size);
+					this->length = size_t(size.QuadPart);
+
+					if (this->length) {
+						this->mapping = CreateFileMappingA(this->file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+						this->bytes	  = this->mapping ? (const char*) MapViewOfFile(this->mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+
+						if (!this->bytes) {
+							if (this->mapping) CloseHandle(this->mapping);
+							CloseHandle(this->file);
+							throw Exceptions::FileReadException(filename);
+						}
+					}
+				#else
+					const int fd = open(filename.c_str(), O_RDONLY);
+					struct stat info;
+
+					if (fd < 0 || fstat(fd, &info) != 0) {
+						if (fd >= 0) close(fd);
+						throw Exceptions::FileReadException(filename);
+					}
+
+					if (info.st_size > 0) {
+						void *view = mmap(nullptr, size_t(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+
+						if (view != MAP_FAILED) {
+							this->bytes  = (const char*) view;
+							this->length = size_t(info.st_size);
+						}
+					}
+					close(fd);
+
+					if (!this->bytes && info.st_size > 0)
+						throw Exceptions::FileReadException(filename);
+				#endif
+			}
+
+			/**	\brief	Unmap the file.
+			 */
+			~MappedFile() {
+				#ifdef _WIN32
+					if (this->bytes)   UnmapViewOfFile(this->bytes);
+					if (this->mapping) CloseHandle(this->mapping);
+					CloseHandle(this->file);
+				#else
+					if (this->bytes) munmap((void*) this->bytes, this->length);
+				#endif
+			}
+
+			MappedFile(const MappedFile&) = delete;
+			MappedFile& operator=(const MappedFile&) = delete;
+
+			/**	\brief	Returns the contents (nullptr for an empty file).
+			 */
+			inline const char* data(void) const {
+				return this->bytes;
+			}
+
+			/**	\brief	Returns the size of the file in bytes.
+			 */
+			inline size_t size(void) const {
+				return this->length;
+			}
+	};
+
+	/**
+	 *	\brief	**NetlistFile** : Saves SynchrotronComponent graphs and loads them back, in a text or a binary form.
+	 *
+	 *		Every component is stored with its CPUComponentFactory type name, its state and the indices
+	 *		of its inputs in port order (see SynchrotronComponent::port()), so the operand order
+	 *		(e.g. the minuend of SUBTRACT) survives a round trip.
+	 *
+	 *		Text form (`#` starts a comment, states are hexadecimal, or binary `0b...` above 64 bits):
+	 *
+	 *			netlist <bit_width> <components>
+	 *			<index> <type> <state> [<input index> ...]
+	 *
+	 *		Binary form (host byte order, all counts uint32_t):
+	 *
+	 *			"SCNL" version bit_width types components edges
+	 *			types x (length, name), zero padding up to a multiple of 8 bytes
+	 *			components x state (uint64_t words, least significant first)
+	 *			components x type, (components + 1) x input offset, edges x input index
+	 *
+	 *		The loaded components are owned by the NetlistFile and deleted with it.
+	 *
+	 *	\tparam	bit_width
+	 *		This template argument specifies the width of the components in the graph.
+	 */
+	template <size_t bit_width>
+	class NetlistFile {
+		public:
+			/**	\brief	The version of the binary form.
+			 */
+			static constexpr uint32_t VERSION = 1;
+
+		private:
+			/**	\brief	The amount of uint64_t words per state in the binary form.
+			 */
+			static constexpr size_t WORDS = (bit_width + 63) / 64;
+
+			/**	\brief	The loaded components, in index order.
+			 */
+			std::vector<SynchrotronComponent<bit_width>*> components;
+
+			/**	\brief	Returns every component connected to roots in creation order.
+			 */
+			template <class Iterable>
+			static std::vector<SynchrotronComponent<bit_width>*> sorted(const Iterable& roots) {
+				std::vector<SynchrotronComponent<bit_width>*> nodes = collectGraph<bit_width>(roots);
+
+				std::sort(nodes.begin(), nodes.end(), Ordered::compare());
+				return nodes;
+			}
+
+			/**	\brief	Returns word w (64 bits) of state.
+			 */
+			static inline uint64_t word(const std::bitset<bit_width>& state, size_t w) {
+				return bit_width <= 64 ? state.to_ullong()
+									   : ((state >> (64 * w)) & std::bitset<bit_width>(~0ull)).to_ullong();
+			}
+
+			/**	\brief	Create the component at the end of components.
+			 */
+			void create(const std::string& type, const std::bitset<bit_width>& state) {
+				if (bit_width <= 64) {
+					this->components.push_back(CPUComponentFactory<bit_width>::create(type, size_t(state.to_ullong())));
+				} else {
+					this->components.push_back(CPUComponentFactory<bit_width>::create(type));
+					this->components.back()->commit(std::StateBitset<bit_width>(state));
+				}
+			}
+
+			/**	\brief	Connect the inputs of every component (CSR: the inputs of component i are
+			 *			inputs[offsets[i]] up to inputs[offsets[i + 1]]).
+			 *
+			 *		All edges are checked first and then connected at once by a SynchrotronBuilder.
+			 */
+			void connect(const std::vector<uint32_t>& offsets, const std::vector<uint32_t>& inputs) {
+				SynchrotronBuilder<bit_width> builder(this->components);
+				builder.reserve(inputs.size());
+
+				for (size_t i = 0; i < this->components.size(); ++i) {
+					if (offsets[i] > offsets[i + 1] || offsets[i + 1] > inputs.size())
+						throw Exceptions::Exception("[ERROR] Invalid input offsets in netlist!");
+
+					for (size_t e = offsets[i]; e < offsets[i + 1]; ++e)
+						builder.connect(inputs[e], i);
+				}
+
+				builder.commit();
+			}
+
+			/**	\brief	Bounds checked reader over a byte buffer.
+			 */
+			struct Cursor {
+				const char *pos, *end;
+
+				/**	\brief	Throw unless at least bytes are left (before allocating for counts read from the file).
+				 */
+				void require(uint64_t bytes) const {
+					if (uint64_t(this->end - this->pos) < bytes)
+						throw Exceptions::Exception("[ERROR] Truncated netlist!");
+				}
+
+				template <class T>
+				void read(T *out, size_t count) {
+					if (size_t(this->end - this->pos) < count * sizeof(T))
+						throw Exceptions::Exception("[ERROR] Truncated netlist!");
+
+					if (count) std::memcpy(out, this->pos, count * sizeof(T));
+					this->pos += count * sizeof(T);
+				}
+
+				template <class T>
+				T read(void) {
+					T value;
+					this->read(&value, 1);
+					return value;
+				}
+			};
+
+		public:
+			/**	\brief	Default constructor (no components).
+			 */
+			NetlistFile() {}
+
+			/**	\brief	Deletes the loaded components.
+			 */
+			~NetlistFile() {
+				this->clear();
+			}
+
+			NetlistFile(const NetlistFile&) = delete;
+			NetlistFile& operator=(const NetlistFile&) = delete;
+
+			/**	\brief	Delete the loaded components.
+			 */
+			void clear(void) {
+				for (auto it = this->components.rbegin(); it != this->components.rend(); ++it)
+					delete *it;
+				this->components.clear();
+			}
+
+			/**	\brief	Write the text form of the graph connected to roots.
+			 *
+			 *	\exception	Exceptions::Exception
+			 *		Throws exception if a component type is not registered in CPUComponentFactory.
+			 */
+			template <class Iterable>
+			static void writeText(std::ostream& os, const Iterable& roots) {
+				const std::vector<SynchrotronComponent<bit_width>*> nodes = sorted(roots);
+				std::unordered_map<const SynchrotronComponent<bit_width>*, size_t> index;
+
+				for (size_t i = 0; i < nodes.size(); ++i)
+					index[nodes[i]] = i;
+
+				os << "# ScottyCPU netlist: <index> <type> <state> [<input index> ...]\n"
+				   << "netlist " << bit_width << " " << nodes.size() << "\n";
+
+				for (size_t i = 0; i < nodes.size(); ++i) {
+					const std::bitset<bit_width> state = nodes[i]->getState();
+
+					os << i << " " << CPUComponentFactory<bit_width>::getName(*nodes[i]) << " ";
+					if (bit_width <= 64)
+						os << "0x" << std::hex << std::uppercase << state.to_ullong() << std::dec;
+					else
+						os << "0b" << state.to_string();
+
+					for (auto& connection : nodes[i]->getPorts())
+						os << " " << index[connection];
+					os << "\n";
+				}
+			}
+
+			/**	\brief	Write the binary form of the graph connected to roots.
+			 *
+			 *	\exception	Exceptions::Exception
+			 *		Throws exception if a component type is not registered in CPUComponentFactory.
+			 */
+			template <class Iterable>
+			static void writeBinary(std::ostream& os, const Iterable& roots) {
+				const std::vector<SynchrotronComponent<bit_width>*> nodes = sorted(roots);
+				std::unordered_map<const SynchrotronComponent<bit_width>*, uint32_t> index;
+				std::map<std::string, uint32_t> typeIndex;
+				std::vector<std::string> types;
+				std::vector<uint64_t> states;
+				std::vector<uint32_t> nodeTypes, offsets(1, 0), inputs;
+
+				for (size_t i = 0; i < nodes.size(); ++i)
+					index[nodes[i]] = uint32_t(i);
+
+				for (auto node : nodes) {
+					const std::string &type = CPUComponentFactory<bit_width>::getName(*node);
+					const std::bitset<bit_width> state = node->getState();
+
+					if (typeIndex.insert(std::make_pair(type, uint32_t(types.size()))).second)
+						types.push_back(type);
+					nodeTypes.push_back(typeIndex[type]);
+
+					for (size_t w = 0; w < WORDS; ++w)
+						states.push_back(word(state, w));
+
+					for (auto& connection : node->getPorts())
+						inputs.push_back(index[connection]);
+					offsets.push_back(uint32_t(inputs.size()));
+				}
+
+				const uint32_t header[] = { VERSION, uint32_t(bit_width), uint32_t(types.size()),
+											uint32_t(nodes.size()), uint32_t(inputs.size()) };
+				size_t written = 4 + sizeof(header);
+
+				os.write("SCNL", 4);
+				os.write((const char*) header, sizeof(header));
+
+				for (auto& type : types) {
+					const uint32_t length = uint32_t(type.size());
+					os.write((const char*) &length, sizeof(length));
+					os.write(type.data(), length);
+					written += sizeof(length) + length;
+				}
+				for (; written % 8; ++written)
+					os.put('\0');
+
+				os.write((const char*) states.data(),	 states.size()	  * sizeof(uint64_t));
+				os.write((const char*) nodeTypes.data(), nodeTypes.size() * sizeof(uint32_t));
+				os.write((const char*) offsets.data(),	 offsets.size()	  * sizeof(uint32_t));
+				os.write((const char*) inputs.data(),	 inputs.size()	  * sizeof(uint32_t));
+			}
+
+			/**	\brief	Write the text form of the graph connected to roots to a file.
+			 *
+			 *	\exception	FileWriteException
+			 *		Throws FileWriteException if the file could not be written properly.
+			 */
+			template <class Iterable>
+			static void saveText(const std::string& filename, const Iterable& roots) {
+				std::stringstream ss;
+				writeText(ss, roots);
+				SysUtils::writeStringToFile(filename, ss.str());
+			}
+
+			/**	\brief	Write the binary form of the graph connected to roots to a file.
+			 *
+			 *	\exception	FileWriteException
+			 *		Throws FileWriteException if the file could not be written properly.
+			 */
+			template <class Iterable>
+			static void saveBinary(const std::string& filename, const Iterable& roots) {
+				std::stringstream ss;
+				writeBinary(ss, roots);
+				const std::string bytes = ss.str();
+				SysUtils::writeBinaryFile(filename, bytes.data(), bytes.size());
+			}
+
+			/**	\brief	Replace the loaded components by the graph in the text form.
+			 *
+			 *	\exception	Exceptions::Exception
+			 *		Throws exception if the text is not a valid netlist of this bit_width.
+			 */
+			void readText(std::istream& is) {
+				// Per component line, in file order: the vectors only grow with the lines actually read,
+				// whatever count the header claims.
+				std::vector<size_t> indices, lineNumbers;
+				std::vector<std::string> types;
+				std::vector<std::bitset<bit_width>> states;
+				std::vector<std::vector<uint32_t>> nodeInputs;
+				std::string line, token;
+				size_t width = 0, count = 0;
+				bool header = false;
+
+				this->clear();
+
+				for (size_t line_nr = 1; std::getline(is, line); ++line_nr) {
+					std::strEraseFrom(line, "#");
+					std::stringstream ss(line);
+					const std::string where = " (line " + std::to_string(line_nr) + ")!";
+
+					if (!(ss >> token)) continue;	// Empty or comment
+
+					if (!header) {
+						if (token != "netlist" || !(ss >> width >> count))
+							throw Exceptions::Exception("[ERROR] Expected \"netlist <bit_width> <components>\"" + where);
+						if (width != bit_width)
+							throw Exceptions::Exception("[ERROR] Netlist has bit width " + std::to_string(width)
+														+ " instead of " + std::to_string(bit_width) + where);
+						header = true;
+						continue;
+					}
+
+					std::string type, state;
+					std::bitset<bit_width> value;
+					std::vector<uint32_t> nodeInput;
+					size_t i = 0, in = 0;
+
+					try {
+						i = std::stoul(token);
+					} catch (...) {
+						throw Exceptions::Exception("[ERROR] Expected a component index" + where);
+					}
+					// With count lines read, any further one is a duplicate.
+					if (i >= count || indices.size() == count || !(ss >> type >> state))
+						throw Exceptions::Exception("[ERROR] Invalid or duplicate component" + where);
+
+					try {
+						if (state.compare(0, 2, "0b") == 0)
+							value = std::bitset<bit_width>(state.substr(2));
+						else
+							value = std::bitset<bit_width>(std::stoull(state, nullptr, 16));
+					} catch (...) {
+						throw Exceptions::Exception("[ERROR] Invalid state \"" + state + "\"" + where);
+					}
+
+					while (ss >> in)
+						nodeInput.push_back(uint32_t(in));
+					if (!ss.eof())
+						throw Exceptions::Exception("[ERROR] Invalid input index" + where);
+
+					indices.push_back(i);
+					lineNumbers.push_back(line_nr);
+					types.push_back(type);
+					states.push_back(value);
+					nodeInputs.push_back(std::move(nodeInput));
+				}
+
+				if (!header)
+					throw Exceptions::Exception("[ERROR] Missing netlist header!");
+				if (indices.size() != count)
+					throw Exceptions::Exception("[ERROR] Netlist does not define every component!");
+
+				// Every index is below count and there are count lines, so this is bounded by the file.
+				const size_t none = ~size_t(0);
+				std::vector<size_t> lineOf(count, none);
+				for (size_t l = 0; l < count; ++l) {
+					if (lineOf[indices[l]] != none)
+						throw Exceptions::Exception("[ERROR] Invalid or duplicate component (line "
+													+ std::to_string(lineNumbers[l]) + ")!");
+					lineOf[indices[l]] = l;
+				}
+
+				std::vector<uint32_t> offsets(1, 0), inputs;
+				for (auto l : lineOf) {
+					inputs.insert(inputs.end(), nodeInputs[l].begin(), nodeInputs[l].end());
+					offsets.push_back(uint32_t(inputs.size()));
+				}
+
+				this->components.reserve(count);
+				for (auto l : lineOf)
+					this->create(types[l], states[l]);
+				this->connect(offsets, inputs);
+			}
+
+			/**	\brief	Replace the loaded components by the graph in the binary form.
+			 *
+			 *	\param	data
+			 *		The binary form.
+			 *	\param	size
+			 *		The size of data in bytes.
+			 *	\exception	Exceptions::Exception
+			 *		Throws exception if data is not a valid binary netlist of this bit_width.
+			 */
+			void readBinary(const char* data, size_t size) {
+				Cursor cursor = { data, data + size };
+				char magic[4];
+				uint32_t header[5];
+
+				this->clear();
+
+				cursor.read(magic, 4);
+				cursor.read(header, 5);
+
+				if (std::memcmp(magic, "SCNL", 4) || header[0] != VERSION)
+					throw Exceptions::Exception("[ERROR] Not a binary netlist (version " + std::to_string(VERSION) + ")!");
+				if (header[1] != bit_width)
+					throw Exceptions::Exception("[ERROR] Netlist has bit width " + std::to_string(header[1])
+												+ " instead of " + std::to_string(bit_width) + "!");
+
+				const size_t count = header[3], edges = header[4];
+
+				cursor.require(uint64_t(header[2]) * sizeof(uint32_t));
+				std::vector<std::string> types(header[2]);
+
+				for (auto& type : types) {
+					const uint32_t length = cursor.template read<uint32_t>();
+					if (size_t(cursor.end - cursor.pos) < length)
+						throw Exceptions::Exception("[ERROR] Truncated netlist!");
+					type.assign(cursor.pos, length);
+					cursor.pos += length;
+				}
+				cursor.pos += std::min<size_t>((8 - size_t(cursor.pos - data) % 8) % 8, size_t(cursor.end - cursor.pos));
+
+				cursor.require(uint64_t(count) * (WORDS * sizeof(uint64_t) + 2 * sizeof(uint32_t)) + (uint64_t(edges) + 1) * sizeof(uint32_t));
+				std::vector<uint64_t> states(count * WORDS);
+				std::vector<uint32_t> nodeTypes(count), offsets(count + 1), inputs(edges);
+
+				cursor.read(states.data(),	  states.size());
+				cursor.read(nodeTypes.data(), count);
+				cursor.read(offsets.data(),	  count + 1);
+				cursor.read(inputs.data(),	  edges);
+
+				if (offsets.front() != 0 || offsets.back() != edges)
+					throw Exceptions::Exception("[ERROR] Invalid input offsets in netlist!");
+
+				for (auto type : nodeTypes)
+					if (type >= types.size())
+						throw Exceptions::Exception("[ERROR] Type index out of range in netlist!");
+
+				this->components.reserve(count);
+				for (size_t i = 0; i < count; ++i) {
+					std::bitset<bit_width> state;
+
+					for (size_t w = WORDS; w-- > 0;)
+						state = (bit_width > 64 ? state << 64 : state) | std::bitset<bit_width>(states[i * WORDS + w]);
+
+					this->create(types[nodeTypes[i]], state);
+				}
+				this->connect(offsets, inputs);
+			}
+
+			/**	\brief	Replace the loaded components by the graph in a text file.
+			 *
+			 *	\exception	FileReadException
+			 *		Throws FileReadException if the file could not be read.
+			 *	\exception	Exceptions::Exception
+			 *		Throws exception if the file is not a valid netlist of this bit_width.
+			 */
+			void loadText(const std::string& filename) {
+				std::ifstream file(filename);
+
+				if (!file.is_open())
+					throw Exceptions::FileReadException(filename);
+
+				this->readText(file);
+			}
+
+			/**	\brief	Replace the loaded components by the graph in a binary file, read through a memory mapping.
+			 *
+			 *	\exception	FileReadException
+			 *		Throws FileReadException if the file could not be mapped.
+			 *	\exception	Exceptions::Exception
+			 *		Throws exception if the file is not a valid binary netlist of this bit_width.
+			 */
+			void loadBinary(const std::string& filename) {
+				const MappedFile file(filename);
+				this->readBinary(file.data(), file.size());
+			}
+
+			/**	\brief	Replace the loaded components by the graph in a binary (starting with "SCNL") or text file.
+			 *
+			 *	\exception	FileReadException
+			 *		Throws FileReadException if the file could not be read.
+			 *	\exception	Exceptions::Exception
+			 *		Throws exception if the file is not a valid netlist of this bit_width.
+			 */
+			void load(const std::string& filename) {
+				char magic[4] = {};
+				std::ifstream file(filename, std::ios::binary);
+
+				if (!file.is_open())
+					throw Exceptions::FileReadException(filename);
+				file.read(magic, 4);
+				file.close();
+
+				if (!std::memcmp(magic, "SCNL", 4))	this->loadBinary(filename);
+				else								this->loadText(filename);
+			}
+
+			/**	\brief	Returns the loaded components, in index order.
+			 */
+			inline const std::vector<SynchrotronComponent<bit_width>*>& getComponents(void) const {
+				return this->components;
+			}
+
+			/**	\brief	Returns the amount of loaded components.
+			 */
+			inline size_t size(void) const {
+				return this->components.size();
+			}
+
+			/**	\brief	Returns the loaded component with index i.
+			 */
+			inline SynchrotronComponent<bit_width>& operator[](size_t i) const {
+				return *this->components[i];
+			}
+	};
+
+	template <size_t bit_width> constexpr uint32_t NetlistFile<bit_width>::VERSION;
+}
+
+#endif // NETLISTFILE_HPP
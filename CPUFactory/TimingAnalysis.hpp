@@ -0,0 +1,344 @@
+#ifndef TIMINGANALYSIS_HPP
+#define TIMINGANALYSIS_HPP
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <initializer_list>
+
+#include "../SynchrotronComponent.hpp"
+#include "../SynchrotronTiming.hpp"
+#include "../CPUComponents/GateKind.hpp"
+#include "../CPUComponents/DIVIDE.hpp"
+#include "../CPUComponents/MODULO.hpp"
+#include "../CPUComponents/COMPERATOR.hpp"
+#include "../CPUComponents/ALUnit.hpp"
+#include "../Exceptions.hpp"
+#include "../utils.hpp"
+using namespace CPUComponents;
+
+namespace CPUFactory {
+
+	/**
+	 *	\brief	**TimingAnalysis** :
+	 *			Static timing analysis of a frozen SynchrotronComponent graph: the longest combinational path
+	 *			between registers, and the highest Clock frequency it allows.
+	 *
+	 *		Registers are the components whose state is not a function of their inputs: components without
+	 *		inputs, MemoryCells and components with hidden state (see SynchrotronComponent::hasHiddenState()).
+	 *		A path starts at the output of a register, after its own delay (its clock-to-output time),
+	 *		and runs through combinational components, each adding the delay of its type, up to the input
+	 *		of a register or a component without outputs.
+	 *
+	 *		The arrival times are computed in one topological pass (Kahn's algorithm) over the graph,
+	 *		so the analysis runs in O(components + connections). Combinational loops are rejected.
+	 *
+	 *	\tparam	bit_width
+	 *		This template argument specifies the width of the components in the graph.
+	 */
+	template <size_t bit_width>
+	class TimingAnalysis {
+		private:
+			/**	\brief	Every component of the graph.
+			 */
+			std::vector<const SynchrotronComponent<bit_width>*> components;
+
+			/**	\brief	Position of each component in components.
+			 */
+			std::unordered_map<const SynchrotronComponent<bit_width>*, size_t> index;
+
+			/**	\brief	Per component: whether it is a register, and the time its output settles after the clock edge.
+			 */
+			std::vector<char>		registers;
+			std::vector<SimTime>	arrival;
+
+			/**	\brief	Per component: the input its latest arrival comes through (none for registers).
+			 */
+			std::vector<size_t>		via;
+
+			/**	\brief	The amount of path endpoints (register inputs and components without outputs).
+			 */
+			size_t endpoints;
+
+			/**	\brief	The delay of the critical path and its components, from the starting register to the endpoint.
+			 */
+			SimTime critical;
+			std::vector<const SynchrotronComponent<bit_width>*> path;
+
+			/**	\brief	Whether component is a register.
+			 */
+			static inline bool isRegister(const SynchrotronComponent<bit_width>& component) {
+				return component.getInputs().empty() || component.hasHiddenState()
+					|| dynamic_cast<const MemoryCell<bit_width>*>(&component);
+			}
+
+			/**	\brief	Compute the arrival times of every component connected to roots and the critical path.
+			 */
+			template <class Iterable>
+			void analyze(const Iterable& roots, const DelayTable& table) {
+				const size_t none = ~size_t(0);
+				std::vector<size_t> fanoutOffsets(1, 0), fanout;
+
+				this->components.clear();
+				this->index.clear();
+
+				// Collect the graph breadth first, with the outputs of each component as positions (CSR).
+				auto visit = [this](const SynchrotronComponent<bit_width>* component) {
+					auto it = this->index.find(component);
+					if (it != this->index.end()) return it->second;
+
+					this->index.emplace(component, this->components.size());
+					this->components.push_back(component);
+					return this->components.size() - 1;
+				};
+
+				for (auto root : roots)
+					if (root) visit(root);
+
+				for (size_t i = 0; i < this->components.size(); ++i) {
+					const SynchrotronComponent<bit_width> *component = this->components[i];
+
+					for (auto& connection : component->getInputs())
+						visit(connection);
+					for (auto& connection : component->getOutputs())
+						fanout.push_back(visit(connection));
+					fanoutOffsets.push_back(fanout.size());
+				}
+
+				const size_t n = this->components.size();
+				std::vector<size_t> inDegree(n, 0), ready, endVia(n, none);
+				std::vector<SimTime> latest(n, 0), endArrival(n, 0);
+
+				this->registers.assign(n, 0);
+				this->arrival.assign(n, 0);
+				this->via.assign(n, none);
+
+				for (size_t i = 0; i < n; ++i) {
+					this->registers[i] = isRegister(*this->components[i]);
+					if (this->registers[i]) {
+						this->arrival[i] = table.get(*this->components[i]);
+						ready.push_back(i);
+					} else {
+						inDegree[i] = this->components[i]->getInputs().size();
+					}
+				}
+
+				// Kahn's algorithm on the edges into combinational components:
+				// a component's arrival is known once all of its inputs are placed.
+				for (size_t r = 0; r < ready.size(); ++r) {
+					const size_t i = ready[r];
+
+					for (size_t f = fanoutOffsets[i]; f < fanoutOffsets[i + 1]; ++f) {
+						const size_t o = fanout[f];
+
+						if (this->registers[o]) {
+							if (endVia[o] == none || this->arrival[i] > endArrival[o]) {
+								endArrival[o] = this->arrival[i];
+								endVia[o] = i;
+							}
+							continue;
+						}
+
+						if (this->via[o] == none || this->arrival[i] > latest[o]) {
+							latest[o] = this->arrival[i];
+							this->via[o] = i;
+						}
+
+						if (!--inDegree[o]) {
+							this->arrival[o] = latest[o] + table.get(*this->components[o]);
+							ready.push_back(o);
+						}
+					}
+				}
+
+				if (ready.size() != n)
+					throw Exceptions::Exception("[ERROR] Cannot analyze the timing of a graph with combinational loops!");
+
+				// Endpoints: register inputs, and combinational components nothing reads.
+				size_t end = none, last = none;
+				this->endpoints = 0;
+				this->critical = 0;
+
+				for (size_t i = 0; i < n; ++i) {
+					SimTime at;
+					size_t from;
+
+					if (this->registers[i] && endVia[i] != none) {
+						at = endArrival[i];
+						from = endVia[i];
+					} else if (!this->registers[i] && fanoutOffsets[i] == fanoutOffsets[i + 1]) {
+						at = this->arrival[i];
+						from = i;
+					} else {
+						continue;
+					}
+
+					++this->endpoints;
+					if (end == none || at > this->critical) {
+						this->critical = at;
+						end = i;
+						last = from;
+					}
+				}
+
+				this->path.clear();
+				if (end == none) return;
+
+				if (last != end) this->path.push_back(this->components[end]);
+				for (size_t i = last; i != none; i = this->via[i])
+					this->path.push_back(this->components[i]);
+				std::reverse(this->path.begin(), this->path.end());
+			}
+
+		public:
+			/**	\brief	Analyze the graph connected to roots.
+			 *
+			 *	\param	roots
+			 *		Any iterable of SynchrotronComponent<bit_width>*; everything connected to them is included.
+			 *	\param	table
+			 *		The delay of each component type (e.g. defaultDelays()).
+			 *	\exception	Exceptions::Exception
+			 *		Throws exception if the graph contains a combinational loop.
+			 */
+			template <class Iterable>
+			TimingAnalysis(const Iterable& roots, const DelayTable& table = defaultDelays()) : endpoints(0), critical(0) {
+				this->analyze(roots, table);
+			}
+
+			/**	\brief	Analyze the graph connected to roots.
+			 */
+			TimingAnalysis(std::initializer_list<SynchrotronComponent<bit_width>*> roots, const DelayTable& table = defaultDelays())
+				: endpoints(0), critical(0) {
+				this->analyze(roots, table);
+			}
+
+			/**	\brief	Returns a DelayTable with rough delays (in picoseconds) of the gates of this bit_width.
+			 *
+			 *		Simple gates take 10 to 30 ps, arithmetic grows with the width
+			 *		(a ripple-carry ADD or SUBTRACT, an array MULTIPLY, DIVIDE and MODULO);
+			 *		registers take 20 ps from the clock edge to their output.
+			 *		The CPUInstructions of the ALUnit take as long as the gate they compute.
+			 */
+			static DelayTable defaultDelays(void) {
+				const SimTime w = bit_width;
+				DelayTable table(20);
+
+				table.set<NOTGate<bit_width>>(10);
+				table.set<NANDGate<bit_width>>(15);
+				table.set<NORGate<bit_width>>(15);
+				table.set<ANDGate<bit_width>>(20);
+				table.set<ORGate<bit_width>>(20);
+				table.set<XORGate<bit_width>>(30);
+				table.set<SHIFTLeft<bit_width>>(10);
+				table.set<SHIFTRight<bit_width>>(10);
+				table.set<ADD<bit_width>>(20 * w);
+				table.set<SUBTRACT<bit_width>>(20 * w + 10);
+				table.set<COMPERATOR<bit_width>>(20 * w);
+				table.set<MULTIPLY<bit_width>>(40 * w);
+				table.set<DIVIDE<bit_width>>(60 * w);
+				table.set<MODULO<bit_width>>(60 * w);
+
+				table.set<NOTInstruction<bit_width>>(10);
+				table.set<NANDInstruction<bit_width>>(15);
+				table.set<NORInstruction<bit_width>>(15);
+				table.set<ANDInstruction<bit_width>>(20);
+				table.set<ORInstruction<bit_width>>(20);
+				table.set<XORInstruction<bit_width>>(30);
+				table.set<SHLInstruction<bit_width>>(10);
+				table.set<SHRInstruction<bit_width>>(10);
+				table.set<ADDInstruction<bit_width>>(20 * w);
+				table.set<SUBInstruction<bit_width>>(20 * w + 10);
+				table.set<CMPInstruction<bit_width>>(20 * w);
+				table.set<MULInstruction<bit_width>>(40 * w);
+				table.set<DIVInstruction<bit_width>>(60 * w);
+				table.set<MODInstruction<bit_width>>(60 * w);
+
+				return table;
+			}
+
+			/**	\brief	Returns the delay of the critical path in picoseconds (0 without any path).
+			 */
+			inline SimTime getCriticalDelay(void) const {
+				return this->critical;
+			}
+
+			/**	\brief	Returns the components of the critical path, from its starting register to its endpoint.
+			 */
+			inline const std::vector<const SynchrotronComponent<bit_width>*>& getCriticalPath(void) const {
+				return this->path;
+			}
+
+			/**	\brief	Returns the highest Clock frequency in Hz at which every path settles within one period
+			 *			(0 if there is no path with a delay, so any frequency works).
+			 */
+			inline double getMaxFrequency(void) const {
+				return this->critical ? 1e12 / double(this->critical) : 0.0;
+			}
+
+			/**	\brief	Returns the time at which the output of component settles after the clock edge.
+			 *
+			 *	\exception	Exceptions::Exception
+			 *		Throws exception if the component is not part of the analyzed graph.
+			 */
+			SimTime getArrival(const SynchrotronComponent<bit_width>& component) const {
+				auto it = this->index.find(&component);
+
+				if (it == this->index.end())
+					throw Exceptions::Exception("[ERROR] Component is not part of this TimingAnalysis!");
+
+				return this->arrival[it->second];
+			}
+
+			/**	\brief	Returns the amount of analyzed components.
+			 */
+			inline size_t size(void) const {
+				return this->components.size();
+			}
+
+			/**	\brief	Returns the amount of path endpoints (register inputs and components without outputs).
+			 */
+			inline size_t getEndpointCount(void) const {
+				return this->endpoints;
+			}
+
+			/**	\brief	Print the critical path with the arrival time after each component, and the maximum frequency.
+			 *
+			 *	\param	os
+			 *		The stream to print to.
+			 */
+			void print(std::ostream& os) const {
+				os << "Components: " << this->size() << ", endpoints: " << this->endpoints << std::endl;
+
+				if (this->path.empty()) {
+					os << "No timing path." << std::endl;
+					return;
+				}
+
+				os << std::left << std::setw(32) << "Critical path" << std::right << std::setw(12) << "Arrival [ps]" << std::endl;
+				for (size_t i = 0; i < this->path.size(); ++i) {
+					const SynchrotronComponent<bit_width> &component = *this->path[i];
+					const bool endpoint = i + 1 == this->path.size() && i > 0 && isRegister(component);
+
+					os << std::left  << std::setw(32) << (std::type2name(component) + " #" + std::to_string(component.getOrder()))
+					   << std::right << std::setw(12) << (endpoint ? this->critical : this->getArrival(component))
+					   << (endpoint ? " (input)" : "") << std::endl;
+				}
+
+				const std::ios::fmtflags flags = os.flags();
+				const std::streamsize precision = os.precision();
+
+				os << "Critical delay: " << this->critical << " ps, maximum clock frequency: ";
+				if (this->critical)	os << std::fixed << std::setprecision(1) << this->getMaxFrequency() / 1e6 << " MHz";
+				else				os << "unlimited";
+				os << std::endl;
+
+				os.flags(flags);
+				os.precision(precision);
+			}
+	};
+}
+
+#endif // TIMINGANALYSIS_HPP
@@ -45,17 +45,14 @@ namespace CPUInstructions {
 				this->clearFlags();
 
 				//CPUComponents::COMPERATOR<bit_width>::tick();
-				std::bitset<bit_width> prevState = this->state;
+				const std::StateBitset<bit_width> prevState = this->state;
 
 				//this->state.reset();	// Default non-destructive state for COMPERATOR-operation
-				std::SignedBitset<bit_width + 1> current(0);
+				const auto &ports = this->getPorts();
+				std::SignedBitset<bit_width + 1> current(this->port(0).getState().to_ullong());
 
-				for(auto& connection : this->getInputs()) {
-					if (connection == *this->getInputs().begin())
-						current = connection->getState().to_ullong();
-					else
-						this->state = (current = current.compareTo(std::SignedBitset<bit_width + 1>(connection->getState().to_ullong()))).to_ullong();
-				}
+				for(size_t i = 1; i < ports.size(); ++i)
+					this->state = (current = current.compareTo(std::SignedBitset<bit_width + 1>(ports[i]->getState().to_ullong()))).to_ullong();
 
 				if (this->state.none()) {
 					this->setFlag(FLAGS::Zero);
@@ -47,20 +47,18 @@ namespace CPUInstructions {
 				this->clearFlags();
 
 				//CPUComponents::MODULO<bit_width>::tick();
-				std::bitset<bit_width> prevState = this->state;
+				const std::StateBitset<bit_width> prevState = this->state;
 
 				//this->state.reset();	// Default non-destructive state for DIVIDE-operation
+				const auto &ports = this->getPorts();
 				std::SignedBitset<bit_width + 1> current(0);
 
 				try {
-					for(auto& connection : this->getInputs()) {
-						if (connection == *this->getInputs().begin())
-							current = connection->getState().to_ullong();
-						else
-							//current %= std::SignedBitset<current.size()>(connection->getState().to_ullong());
-							// MSVC fixed:
-							current %= std::SignedBitset<bit_width + 1>(connection->getState().to_ullong());
-					}
+					current = this->port(0).getState().to_ullong();
+					for(size_t i = 1; i < ports.size(); ++i)
+						//current %= std::SignedBitset<current.size()>(ports[i]->getState().to_ullong());
+						// MSVC fixed:
+						current %= std::SignedBitset<bit_width + 1>(ports[i]->getState().to_ullong());
 				} catch (Exceptions::DivideByZeroException&) {
 					current.set();
 					this->setFlag(FLAGS::DivByZero);
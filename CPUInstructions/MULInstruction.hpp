@@ -45,7 +45,7 @@ namespace CPUInstructions {
 				this->clearFlags();
 
 				//CPUComponents::MULTIPLY<bit_width>::tick();
-				std::bitset<bit_width> prevState = this->state;
+				const std::StateBitset<bit_width> prevState = this->state;
 
 //				//this->state.reset();	// Default non-destructive state for MUL-operation
 				std::SignedBitset<bit_width * 2 + 1> current(1);
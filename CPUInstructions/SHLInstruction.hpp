@@ -46,7 +46,7 @@ namespace CPUInstructions {
 				this->clearFlags();
 
 				//CPUComponents::SHIFTLeft<bit_width>::tick();
-				std::bitset<bit_width> prevState = this->state;
+				const std::StateBitset<bit_width> prevState = this->state;
 
 				std::bitset<bit_width + 1> current(this->getInput().getState().to_ullong());
 
@@ -0,0 +1,176 @@
+#ifndef FLATSET_HPP
+#define FLATSET_HPP
+
+#include <vector>
+#include <algorithm>
+#include <functional>
+
+namespace Synchrotron {
+
+	/**
+	 *	\brief	**FlatSet** : Sorted set of unique elements, stored in one contiguous array.
+	 *
+	 *	Offers the subset of the `std::set` interface used by SynchrotronComponent,
+	 *	but iterating it walks a single array instead of chasing tree nodes scattered across the heap.
+	 *	Lookups are a binary search; insert() and erase() shift the elements after the position,
+	 *	which is cheap for the connection counts of a component.
+	 *
+	 *	Iterators are invalidated by insert() and erase().
+	 *
+	 *	\tparam	T
+	 *		The element type.
+	 *	\tparam	Compare
+	 *		The strict weak ordering of the elements (as for `std::set`).
+	 */
+	template <class T, class Compare = std::less<T>>
+	class FlatSet {
+		private:
+			/**	\brief	The sorted elements.
+			 */
+			std::vector<T> elements;
+
+			/**	\brief	Returns the first position not ordered before value.
+			 */
+			inline typename std::vector<T>::iterator lower_bound(const T& value) {
+				return std::lower_bound(this->elements.begin(), this->elements.end(), value, Compare());
+			}
+
+			/**	\brief	Returns the first position not ordered before value.
+			 */
+			inline typename std::vector<T>::const_iterator lower_bound(const T& value) const {
+				return std::lower_bound(this->elements.begin(), this->elements.end(), value, Compare());
+			}
+
+			/**	\brief	Returns whether the element at pos is equivalent to value.
+			 */
+			inline bool matches(typename std::vector<T>::const_iterator pos, const T& value) const {
+				return pos != this->elements.end() && !Compare()(value, *pos);
+			}
+
+		public:
+			typedef typename std::vector<T>::const_iterator			iterator;
+			typedef typename std::vector<T>::const_iterator			const_iterator;
+			typedef typename std::vector<T>::const_reverse_iterator	reverse_iterator;
+			typedef typename std::vector<T>::const_reverse_iterator	const_reverse_iterator;
+			typedef T												value_type;
+
+			/**	\brief	Default constructor
+			 */
+			FlatSet() {}
+
+			/**	\brief	Default destructor
+			 */
+			~FlatSet() {}
+
+			/**	\brief	Insert value if no equivalent element is present.
+			 *
+			 *	\return	bool
+			 *		Returns true if value was inserted.
+			 */
+			bool insert(const T& value) {
+				auto pos = this->lower_bound(value);
+
+				if (this->matches(pos, value))
+					return false;
+
+				this->elements.insert(pos, value);
+				return true;
+			}
+
+			/**	\brief	Insert the elements of a range, skipping the ones already present.
+			 *
+			 *		Appends the range and merges it with the current elements in one pass
+			 *		(or only appends when it sorts after them), instead of shifting
+			 *		the elements after every single insert().
+			 *
+			 *	\param	first, last
+			 *		The range to insert, sorted by Compare and without equivalent elements.
+			 */
+			template <class InputIt>
+			void insert(InputIt first, InputIt last) {
+				const size_t previous = this->elements.size();
+
+				this->elements.insert(this->elements.end(), first, last);
+
+				if (previous == 0 || previous == this->elements.size()
+					|| Compare()(this->elements[previous - 1], this->elements[previous]))
+					return;
+
+				std::inplace_merge(this->elements.begin(), this->elements.begin() + previous, this->elements.end(), Compare());
+				this->elements.erase(std::unique(this->elements.begin(), this->elements.end(), [](const T& a, const T& b) {
+					return !Compare()(a, b) && !Compare()(b, a);
+				}), this->elements.end());
+			}
+
+			/**	\brief	Remove the element equivalent to value.
+			 *
+			 *	\return	size_t
+			 *		Returns the amount of removed elements (0 or 1).
+			 */
+			size_t erase(const T& value) {
+				auto pos = this->lower_bound(value);
+
+				if (!this->matches(pos, value))
+					return 0;
+
+				this->elements.erase(pos);
+				return 1;
+			}
+
+			/**	\brief	Returns an iterator to the element equivalent to value, or end().
+			 */
+			const_iterator find(const T& value) const {
+				auto pos = this->lower_bound(value);
+				return this->matches(pos, value) ? pos : this->elements.end();
+			}
+
+			/**	\brief	Returns the amount of elements equivalent to value (0 or 1).
+			 */
+			inline size_t count(const T& value) const {
+				return this->matches(this->lower_bound(value), value) ? 1 : 0;
+			}
+
+			/**	\brief	Reserve storage for at least n elements.
+			 */
+			inline void reserve(size_t n) {
+				this->elements.reserve(n);
+			}
+
+			/**	\brief	Remove all elements.
+			 */
+			inline void clear(void) {
+				this->elements.clear();
+			}
+
+			/**	\brief	Returns the amount of elements.
+			 */
+			inline size_t size(void) const {
+				return this->elements.size();
+			}
+
+			/**	\brief	Returns whether the set is empty.
+			 */
+			inline bool empty(void) const {
+				return this->elements.empty();
+			}
+
+			/**	\brief	Returns a pointer to the contiguous, sorted elements.
+			 */
+			inline const T* data(void) const {
+				return this->elements.data();
+			}
+
+			/**	\brief	Returns the element at position i (in sorted order).
+			 */
+			inline const T& operator[](size_t i) const {
+				return this->elements[i];
+			}
+
+			inline const_iterator			begin(void)  const	{ return this->elements.begin();	}
+			inline const_iterator			end(void)    const	{ return this->elements.end();		}
+			inline const_reverse_iterator	rbegin(void) const	{ return this->elements.rbegin();	}
+			inline const_reverse_iterator	rend(void)   const	{ return this->elements.rend();		}
+	};
+}
+
+#endif // FLATSET_HPP
@@ -0,0 +1,161 @@
+#ifndef NATIVEBITSET_HPP
+#define NATIVEBITSET_HPP
+#include <ostream>
+#include <string>
+#include <bitset>
+#include <cstdint>
+#include <type_traits>
+
+namespace std {
+
+	/**
+	 *	\brief	The smallest unsigned integer type holding bit_width bits (up to 64).
+	 *
+	 *	\tparam	bit_width
+	 *		The amount of bits to hold.
+	 */
+	template <size_t bit_width>
+	struct NativeWord {
+		static_assert(bit_width > 0 && bit_width <= 64, "NativeWord holds 1 up to 64 bits.");
+
+		typedef typename conditional<(bit_width <= 8),  uint8_t,
+				typename conditional<(bit_width <= 16), uint16_t,
+				typename conditional<(bit_width <= 32), uint32_t,
+														uint64_t>::type>::type>::type type;
+
+		/**	\brief	Mask with the lower bit_width bits set.
+		 */
+		static constexpr type mask = type(bit_width == 64 ? ~0ull : ((1ull << (bit_width % 64)) - 1));
+	};
+
+	/**
+	 *	\brief	**NativeBitset** : A std::bitset replacement for bit_width <= 64 stored in one machine word.
+	 *
+	 *	Offers the std::bitset interface used by the components (set(), reset(), flip(), test(), none(),
+	 *	bitwise operators, to_ullong()...) and converts to and compares with std::bitset<bit_width>,
+	 *	but every operation is a single native instruction on NativeWord<bit_width>::type.
+	 *	Bits above bit_width are always kept zero.
+	 *
+	 *	\tparam	bit_width
+	 *		This template argument specifies the amount of bits.
+	 */
+	template <size_t bit_width>
+	class NativeBitset {
+		public:
+			typedef typename NativeWord<bit_width>::type word_type;
+
+		private:
+			/**	\brief	The bits, masked to bit_width.
+			 */
+			word_type word;
+
+			static constexpr word_type MASK = NativeWord<bit_width>::mask;
+
+		public:
+			/**
+			 *	Default constructor (all bits zero).
+			 */
+			constexpr NativeBitset() : word(0) {}
+
+			/**
+			 *	Constructor with default value (truncated to bit_width bits, as std::bitset).
+			 */
+			constexpr NativeBitset(unsigned long long __val) : word(word_type(__val & MASK)) {}
+
+			/**
+			 *	Constructor from a std::bitset with the same width.
+			 */
+			NativeBitset(const std::bitset<bit_width>& __val) : word(word_type(__val.to_ullong())) {}
+
+			/**	\brief	Convert to std::bitset<bit_width>.
+			 */
+			inline operator std::bitset<bit_width>() const {
+				return std::bitset<bit_width>(this->word);
+			}
+
+			/**	\brief	Returns the raw machine word.
+			 */
+			inline word_type to_word(void) const					{ return this->word; }
+
+			inline unsigned long to_ulong(void) const				{ return (unsigned long) this->word; }
+			inline unsigned long long to_ullong(void) const			{ return this->word; }
+			inline std::string to_string(void) const				{ return std::bitset<bit_width>(this->word).to_string(); }
+
+			inline constexpr size_t size(void) const				{ return bit_width; }
+			inline size_t count(void) const							{ return std::bitset<64>(this->word).count(); }
+			inline bool test(size_t pos) const						{ return (this->word >> pos) & 1u; }
+			inline bool operator[](size_t pos) const				{ return this->test(pos); }
+			inline bool none(void) const							{ return !this->word; }
+			inline bool any(void) const								{ return this->word != 0; }
+			inline bool all(void) const								{ return this->word == MASK; }
+
+			inline NativeBitset& set(void)							{ this->word = MASK;						return *this; }
+			inline NativeBitset& set(size_t pos, bool val = true) {
+				if (val)	this->word |= word_type(1ull << pos);
+				else		this->word &= word_type(~(1ull << pos));
+				return *this;
+			}
+			inline NativeBitset& reset(void)						{ this->word = 0;							return *this; }
+			inline NativeBitset& reset(size_t pos)					{ this->word &= word_type(~(1ull << pos));	return *this; }
+			inline NativeBitset& flip(void)							{ this->word = word_type(~this->word & MASK);	return *this; }
+			inline NativeBitset& flip(size_t pos)					{ this->word ^= word_type(1ull << pos);		return *this; }
+
+			inline NativeBitset& operator&=(const NativeBitset& __rhs)	{ this->word &= __rhs.word;	return *this; }
+			inline NativeBitset& operator|=(const NativeBitset& __rhs)	{ this->word |= __rhs.word;	return *this; }
+			inline NativeBitset& operator^=(const NativeBitset& __rhs)	{ this->word ^= __rhs.word;	return *this; }
+
+			inline NativeBitset& operator<<=(size_t __pos) {
+				this->word = __pos < bit_width ? word_type((this->word << __pos) & MASK) : 0;
+				return *this;
+			}
+
+			inline NativeBitset& operator>>=(size_t __pos) {
+				this->word = __pos < bit_width ? word_type(this->word >> __pos) : 0;
+				return *this;
+			}
+
+			inline NativeBitset operator~(void) const				{ return NativeBitset(*this).flip();	}
+			inline NativeBitset operator<<(size_t __pos) const		{ return NativeBitset(*this) <<= __pos;	}
+			inline NativeBitset operator>>(size_t __pos) const		{ return NativeBitset(*this) >>= __pos;	}
+
+			inline bool operator==(const NativeBitset& __rhs) const	{ return this->word == __rhs.word;	}
+			inline bool operator!=(const NativeBitset& __rhs) const	{ return this->word != __rhs.word;	}
+
+			/**	\brief	Add the bits to a given stream (`os << NativeBitset`), as std::bitset.
+			 */
+			friend std::ostream& operator<<(std::ostream &os, const NativeBitset &s) {
+				return os << std::bitset<bit_width>(s.word);
+			}
+	};
+
+	template <size_t bit_width>
+	constexpr typename NativeBitset<bit_width>::word_type NativeBitset<bit_width>::MASK;
+
+	template <size_t bit_width>
+	constexpr typename NativeWord<bit_width>::type NativeWord<bit_width>::mask;
+
+	template <size_t bit_width>
+	inline NativeBitset<bit_width> operator&(NativeBitset<bit_width> __lhs, const NativeBitset<bit_width>& __rhs)	{ return __lhs &= __rhs; }
+	template <size_t bit_width>
+	inline NativeBitset<bit_width> operator|(NativeBitset<bit_width> __lhs, const NativeBitset<bit_width>& __rhs)	{ return __lhs |= __rhs; }
+	template <size_t bit_width>
+	inline NativeBitset<bit_width> operator^(NativeBitset<bit_width> __lhs, const NativeBitset<bit_width>& __rhs)	{ return __lhs ^= __rhs; }
+
+	template <size_t bit_width>
+	inline bool operator==(const NativeBitset<bit_width>& __lhs, const std::bitset<bit_width>& __rhs)	{ return __lhs.to_ullong() == __rhs.to_ullong(); }
+	template <size_t bit_width>
+	inline bool operator==(const std::bitset<bit_width>& __lhs, const NativeBitset<bit_width>& __rhs)	{ return __lhs.to_ullong() == __rhs.to_ullong(); }
+	template <size_t bit_width>
+	inline bool operator!=(const NativeBitset<bit_width>& __lhs, const std::bitset<bit_width>& __rhs)	{ return !(__lhs == __rhs); }
+	template <size_t bit_width>
+	inline bool operator!=(const std::bitset<bit_width>& __lhs, const NativeBitset<bit_width>& __rhs)	{ return !(__lhs == __rhs); }
+
+	/**
+	 *	\brief	The state type of a component with bit_width bits:
+	 *			NativeBitset up to 64 bits, std::bitset beyond that.
+	 */
+	template <size_t bit_width>
+	using StateBitset = typename conditional<(bit_width <= 64), NativeBitset<(bit_width <= 64 ? bit_width : 64)>, std::bitset<bit_width>>::type;
+}
+
+#endif // NATIVEBITSET_HPP
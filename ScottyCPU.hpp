@@ -6,6 +6,7 @@
 #include "CPUComponents/Memory.hpp"
 #include "CPUComponents/Clock.hpp"
 #include "CPUComponents/MemoryCell.hpp"
+#include "SynchrotronSnapshot.hpp"
 
 #include "utils.hpp"
 
@@ -57,7 +58,31 @@ namespace CPUComponents {
 			 */
 			MemoryCell<bit_width>				_ALU_BUFFER;
 
+			/**
+			 *	\brief	The states published for observers in other threads (see publishSnapshot()).
+			 */
+			SynchrotronSnapshot<bit_width>		_snapshot;
+
+			/**
+			 *	\brief	The components published after the registers and RAM.
+			 */
+			std::vector<const SynchrotronComponent<bit_width>*>	_watched;
+
 		public:
+			/**
+			 *	\brief	The snapshot index of register 0 (followed by the other registers).
+			 */
+			static const size_t SNAPSHOT_REGISTERS	= 0;
+
+			/**
+			 *	\brief	The snapshot index of RAM address 0 (followed by the other addresses).
+			 */
+			static const size_t SNAPSHOT_RAM		= reg_size + EXTRA_CPU_REGISTERS;
+
+			/**
+			 *	\brief	The snapshot index of the first watched component (see watch()).
+			 */
+			static const size_t SNAPSHOT_WATCHED	= SNAPSHOT_RAM + mem_size;
 
 			/** \brief	Default constructor
 			 *
@@ -72,7 +97,8 @@ namespace CPUComponents {
 				  _RAM(SysUtils::allocVar<Memory<bit_width, mem_size>>()),
 				 // _CU(SysUtils::allocVar<ControlUnit<bit_width, mem_size, reg_size>(_ALU, _RAM, &_BUS, &_ALU_BUFFER)>()),
 				  _CU(new ControlUnit<bit_width, mem_size, reg_size>(_ALU, _RAM, &_BUS, &_ALU_BUFFER)),
-				  _clk(clk_freq)
+				  _clk(clk_freq),
+				  _snapshot(SNAPSHOT_WATCHED)
 			{
 				#ifdef THROW_EXCEPTIONS
 					if (bit_width != 16u)
@@ -117,6 +143,52 @@ namespace CPUComponents {
 				return this->_clk;
 			}
 
+			/**	\brief	Returns the roots of the component graph of the CPU: the Clock, the bus, the ALU buffer
+			 *			and the ALU (e.g. for a CPUFactory::TimingAnalysis of the CPU).
+			 */
+			std::vector<const SynchrotronComponent<bit_width>*> getGraphRoots(void) const {
+				return { &this->_clk, &this->_BUS, &this->_ALU_BUFFER, this->_ALU };
+			}
+
+			/**	\brief	Add component to every following snapshot.
+			 *
+			 *		**Not thread safe:** watch all components before starting observer threads.
+			 *
+			 *	\return	size_t
+			 *		Returns the snapshot index of component.
+			 */
+			size_t watch(const SynchrotronComponent<bit_width>& component) {
+				this->_watched.push_back(&component);
+				this->_snapshot.resize(SNAPSHOT_WATCHED + this->_watched.size());
+				return SNAPSHOT_WATCHED + this->_watched.size() - 1;
+			}
+
+			/**	\brief	Returns the snapshot observers can read() from any thread, without locking the CPU.
+			 *
+			 *		Indices: registers from SNAPSHOT_REGISTERS, RAM from SNAPSHOT_RAM
+			 *		and the watched components from SNAPSHOT_WATCHED.
+			 */
+			const SynchrotronSnapshot<bit_width>& getSnapshot(void) const {
+				return this->_snapshot;
+			}
+
+			/**	\brief	Publish the current registers, RAM and watched components to the snapshot.
+			 *
+			 *		Called by the simulation thread; never waits for readers.
+			 */
+			void publishSnapshot(void) {
+				this->_snapshot.publish([this](typename SynchrotronSnapshot<bit_width>::Writer& writer) {
+					this->_CU->getRegisters().forEachData([&writer](size_t address, const std::bitset<bit_width>& data) {
+						writer.set(SNAPSHOT_REGISTERS + address, data);
+					});
+					this->_RAM->forEachData([&writer](size_t address, const std::bitset<bit_width>& data) {
+						writer.set(SNAPSHOT_RAM + address, data);
+					});
+					for (size_t i = 0; i < this->_watched.size(); ++i)
+						writer.set(SNAPSHOT_WATCHED + i, this->_watched[i]->getState());
+				});
+			}
+
 			/**	\brief	Staticly loads a program into RAM (from address 0).
 			 *
 			 *	\param	*buffer
@@ -166,7 +238,7 @@ namespace CPUComponents {
 			/**
 			 *	\brief	Steps the execution of the ScottyCPU by one tick().
 			 *			Also dumps the contents of its RAM and Registers respectively
-			 *			to RAMdump.txt and REGdump.txt.
+			 *			to RAMdump.txt and REGdump.txt, and publishes the state after the tick (see getSnapshot()).
 			 */
 			void step(void) {
 				std::bitset<bit_width> *range = this->getRAM().getDataRange(0, this->getRAM().getMaxAddress());
@@ -191,6 +263,7 @@ namespace CPUComponents {
 
 
 				this->getClock().tick();
+				this->publishSnapshot();
 			}
 	};
 
@@ -1,5 +1,5 @@
 TEMPLATE = app
-CONFIG += console c++11
+CONFIG += console c++11 thread
 CONFIG -= app_bundle
 CONFIG -= qt
 
@@ -55,7 +55,29 @@ HEADERS += \
     CPUInstructions/Instruction.hpp \
     Assembler.hpp \
     CPUFactory/SCAMParser.hpp \
-    CPUFactory/SCAMAssembler.hpp
+    CPUFactory/SCAMAssembler.hpp \
+    SynchrotronNetlist.hpp \
+    SynchrotronScheduler.hpp \
+    FlatSet.hpp \
+    Benchmark.hpp \
+    NativeBitset.hpp \
+    CPUComponents/GateKind.hpp \
+    CPUFactory/BitSliceSimulator.hpp \
+    SynchrotronParallel.hpp \
+    SynchrotronFixpoint.hpp \
+    SynchrotronStatistics.hpp \
+    CPUFactory/LogicGraph.hpp \
+    CPUFactory/CodeGenerator.hpp \
+    CPUFactory/NetlistFile.hpp \
+    SynchrotronGraph.hpp \
+    SynchrotronBuilder.hpp \
+    SynchrotronSnapshot.hpp \
+    BitsetKernels.hpp \
+    SynchrotronVCD.hpp \
+    CPUComponents/GateSummary.hpp \
+    SynchrotronTiming.hpp \
+    CPUFactory/TimingAnalysis.hpp \
+    SynchrotronSubcircuit.hpp
 
 DISTFILES += \
     Programs/example.scam \
@@ -0,0 +1,294 @@
+/**
+*	Bulk connection of many SynchrotronComponents at once.
+*/
+#ifndef SYNCHROTRONBUILDER_HPP
+#define SYNCHROTRONBUILDER_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <initializer_list>
+
+#include "SynchrotronComponent.hpp"
+#include "Exceptions.hpp"
+
+namespace Synchrotron {
+
+	/** \brief	**SynchrotronBuilder** : Collects an edge list between components (ports by index) and connects it in bulk.
+	 *
+	 *	Every addInput() takes a lock and inserts into two sorted sets, shifting their tails, once per edge.
+	 *	The builder instead groups all edges once, validates them (port indices and the getMaxInputs()
+	 *	of every target, e.g. of a SynchrotronComponentFixedInput) before changing anything, and then
+	 *	merges the new inputs and outputs into each component's sets in a single pass per component.
+	 *
+	 *	The result equals calling `ports[to]->addInput(*ports[from])` for every edge.
+	 *
+	 *	\tparam	bit_width
+	 *		This template argument specifies the width of the components.
+	 *	\tparam	lock_policy
+	 *		The lock_policy of the components.
+	 */
+	template <size_t bit_width, class lock_policy = SYNCHROTRON_LOCK_POLICY>
+	class SynchrotronBuilder {
+		public:
+			typedef SynchrotronComponent<bit_width, lock_policy> Component;
+
+			/**	\brief	A connection from port first (the input) to port second (the receiving component).
+			 */
+			typedef std::pair<size_t, size_t> Edge;
+
+		private:
+			/**	\brief	The pending edges grouped by receiving component (CSR).
+			 */
+			struct Plan {
+				std::vector<size_t> order;			///< The ports in creation order of their component, without aliases.
+				std::vector<size_t> offsets;		///< The new inputs of port p are sources[offsets[p]] up to sources[offsets[p + 1]].
+				std::vector<size_t> sources;		///< The input ports, per receiving port in creation order and unique.
+				std::vector<size_t> arrivalOffsets;	///< As offsets, for arrivals.
+				std::vector<size_t> arrivals;		///< The input ports, per receiving port in edge order (with duplicates).
+			};
+
+			/**	\brief	The components, by port index.
+			 */
+			std::vector<Component*> ports;
+
+			/**	\brief	The pending edges.
+			 */
+			std::vector<Edge> edges;
+
+			/**	\brief	Group, sort and check every pending edge.
+			 *
+			 *		A counting sort by receiving port, then a sort of each (small) group by creation order,
+			 *		so components are only dereferenced once per port instead of once per comparison.
+			 *		Ports holding the same component are merged into the first of them.
+			 *
+			 *	\exception	Exceptions::Exception
+			 *		Throws exception if a port index is out of range or a component would exceed getMaxInputs().
+			 */
+			Plan plan(void) const {
+				const size_t n = this->ports.size();
+				std::vector<size_t> keys(n), canonical(n);
+				Plan result;
+
+				for (auto& edge : this->edges)
+					if (edge.first >= n || edge.second >= n)
+						throw Exceptions::Exception("[ERROR] Edge (" + std::to_string(edge.first) + ", " + std::to_string(edge.second)
+												  + ") uses a port out of range [0, " + std::to_string(n) + ")!");
+
+				for (size_t p = 0; p < n; ++p) {
+					keys[p] = this->ports[p]->getOrder();
+					result.order.push_back(p);
+				}
+
+				std::sort(result.order.begin(), result.order.end(), [&keys](size_t a, size_t b) {
+					return keys[a] < keys[b] || (keys[a] == keys[b] && a < b);
+				});
+
+				for (size_t i = 0; i < n; ++i) {
+					const size_t p = result.order[i];
+					canonical[p] = (i > 0 && keys[p] == keys[result.order[i - 1]]) ? canonical[result.order[i - 1]] : p;
+				}
+
+				result.order.erase(std::remove_if(result.order.begin(), result.order.end(), [&canonical](size_t p) {
+					return canonical[p] != p;
+				}), result.order.end());
+
+				// Counting sort by receiving port.
+				std::vector<size_t> &offsets = result.offsets, &sources = result.sources;
+				offsets.assign(n + 1, 0);
+				sources.resize(this->edges.size());
+
+				for (auto& edge : this->edges)
+					++offsets[canonical[edge.second] + 1];
+				for (size_t p = 0; p < n; ++p)
+					offsets[p + 1] += offsets[p];
+				{
+					std::vector<size_t> fill(offsets.begin(), offsets.end() - 1);
+					for (auto& edge : this->edges)
+						sources[fill[canonical[edge.second]]++] = canonical[edge.first];
+				}
+				result.arrivalOffsets = offsets;
+				result.arrivals = sources;
+
+				// Sort and deduplicate every group in place, then check the limit of its component.
+				size_t write = 0;
+				for (size_t p = 0, begin = 0; p < n; ++p) {
+					const size_t end = offsets[p + 1];
+					const auto first = sources.begin() + begin, last = sources.begin() + end;
+
+					offsets[p] = write;
+					if (begin == end) continue;
+
+					std::sort(first, last, [&keys](size_t a, size_t b) { return keys[a] < keys[b]; });
+					const size_t unique = std::unique(first, last) - first;
+
+					const Component &to = *this->ports[p];
+					size_t inputs = to.getInputs().size();
+
+					for (size_t e = begin; e < begin + unique; ++e) {
+						inputs += to.getInputs().empty() || to.getInputs().count(this->ports[sources[e]]) == 0;
+						sources[write++] = sources[e];
+					}
+
+					if (inputs > to.getMaxInputs())
+						throw Exceptions::Exception("[ERROR] The component at port " + std::to_string(p)
+												  + " would get " + std::to_string(inputs) + " inputs, but accepts at most "
+												  + std::to_string(to.getMaxInputs()) + "!");
+					begin = end;
+				}
+				offsets[n] = write;
+				sources.resize(write);
+
+				return result;
+			}
+
+		public:
+			/**	\brief	Default constructor
+			 */
+			SynchrotronBuilder() {}
+
+			/**	\brief	Constructor with ports 0 up to components.size().
+			 */
+			explicit SynchrotronBuilder(const std::vector<Component*>& components) : ports(components) {}
+
+			/**	\brief	Add a component as the next port.
+			 *
+			 *	\return	size_t
+			 *		Returns the port index of component.
+			 */
+			inline size_t add(Component& component) {
+				this->ports.push_back(&component);
+				return this->ports.size() - 1;
+			}
+
+			/**	\brief	Add components as the next ports.
+			 *
+			 *	\return	size_t
+			 *		Returns the port index of the first component.
+			 */
+			size_t add(const std::vector<Component*>& components) {
+				const size_t first = this->ports.size();
+				this->ports.insert(this->ports.end(), components.begin(), components.end());
+				return first;
+			}
+
+			/**	\brief	Reserve room for the given amount of edges.
+			 */
+			inline void reserve(size_t edges) {
+				this->edges.reserve(edges);
+			}
+
+			/**	\brief	Connect port from as an input of port to (on commit()).
+			 */
+			inline void connect(size_t from, size_t to) {
+				this->edges.push_back(Edge(from, to));
+			}
+
+			/**	\brief	Connect every edge in edgeList (on commit()).
+			 */
+			void connect(const std::vector<Edge>& edgeList) {
+				this->edges.insert(this->edges.end(), edgeList.begin(), edgeList.end());
+			}
+
+			/**	\brief	Connect every edge in edgeList (on commit()).
+			 */
+			void connect(std::initializer_list<Edge> edgeList) {
+				this->edges.insert(this->edges.end(), edgeList.begin(), edgeList.end());
+			}
+
+			/**	\brief	Check every pending edge without connecting anything.
+			 *
+			 *	\exception	Exceptions::Exception
+			 *		Throws exception if a port index is out of range or a component would exceed getMaxInputs().
+			 */
+			inline void validate(void) const {
+				this->plan();
+			}
+
+			/**	\brief	**[Thread safe]** Connect all pending edges and clear them (the ports are kept).
+			 *
+			 *		Every component is locked once while its own sets are merged. New inputs are added
+			 *		to the ports in edge order (see SynchrotronComponent::port()). On an exception
+			 *		nothing is connected and the pending edges are kept.
+			 *
+			 *	\exception	Exceptions::Exception
+			 *		Throws exception if a port index is out of range or a component would exceed getMaxInputs().
+			 */
+			void commit(void) {
+				const Plan plan = this->plan();
+				const size_t n = this->ports.size();
+				std::vector<Component*> connections;
+				std::vector<size_t> outOffsets(n + 1, 0), targets(plan.sources.size()), appended(n, 0);
+
+				// Inputs, per receiving component.
+				for (auto p : plan.order) {
+					if (plan.offsets[p] == plan.offsets[p + 1]) continue;
+
+					connections.clear();
+					for (size_t e = plan.offsets[p]; e < plan.offsets[p + 1]; ++e)
+						connections.push_back(this->ports[plan.sources[e]]);
+
+					Component &to = *this->ports[p];
+					LockBlock<Component> lock(&to);
+
+					for (size_t e = plan.arrivalOffsets[p]; e < plan.arrivalOffsets[p + 1]; ++e) {
+						const size_t source = plan.arrivals[e];
+						if (appended[source] == p + 1 || to.signalInput.count(this->ports[source])) continue;
+
+						appended[source] = p + 1;
+						to.ports.push_back(this->ports[source]);
+					}
+
+					to.signalInput.insert(connections.begin(), connections.end());
+					++to.inputsVersion;
+				}
+
+				// Outputs, per input: visiting the receiving components in creation order keeps every group sorted.
+				for (auto source : plan.sources)
+					++outOffsets[source + 1];
+				for (size_t p = 0; p < n; ++p)
+					outOffsets[p + 1] += outOffsets[p];
+				{
+					std::vector<size_t> fill(outOffsets.begin(), outOffsets.end() - 1);
+					for (auto p : plan.order)
+						for (size_t e = plan.offsets[p]; e < plan.offsets[p + 1]; ++e)
+							targets[fill[plan.sources[e]]++] = p;
+				}
+
+				for (auto p : plan.order) {
+					if (outOffsets[p] == outOffsets[p + 1]) continue;
+
+					connections.clear();
+					for (size_t e = outOffsets[p]; e < outOffsets[p + 1]; ++e)
+						connections.push_back(this->ports[targets[e]]);
+
+					LockBlock<Component> lock(this->ports[p]);
+					this->ports[p]->slotOutput.insert(connections.begin(), connections.end());
+				}
+
+				this->edges.clear();
+			}
+
+			/**	\brief	Returns the component at port.
+			 */
+			inline Component& operator[](size_t port) const {
+				return *this->ports[port];
+			}
+
+			/**	\brief	Returns the amount of ports.
+			 */
+			inline size_t getPortCount(void) const {
+				return this->ports.size();
+			}
+
+			/**	\brief	Returns the amount of pending edges.
+			 */
+			inline size_t getEdgeCount(void) const {
+				return this->edges.size();
+			}
+	};
+}
+
+#endif // SYNCHROTRONBUILDER_HPP
@@ -8,67 +8,239 @@
 #include <iostream> // For testing for now
 
 #include <bitset>
-#include <set>
+#include <vector>
+#include <unordered_set>
 #include <initializer_list>
 #include <mutex>
+#include <atomic>
+#include <limits>
+#include <algorithm>
+
+#include "FlatSet.hpp"
+#include "NativeBitset.hpp"
+#include "Exceptions.hpp"
 
 namespace Synchrotron {
 
-    /** \brief Mutex class to lock the current working thread.
+	/**	\brief	**NullLock** : Lock policy without any synchronization (single-threaded simulations).
+	 */
+	class NullLock {
+		public:
+			inline void lock()		{}
+			inline void unlock()	{}
+	};
+
+	/**	\brief	**SpinLock** : Lock policy busy-waiting on an atomic flag (short, rarely contended sections).
+	 */
+	class SpinLock {
+		private:
+			std::atomic_flag flag;
+		public:
+			SpinLock()				{ flag.clear();	}
+			inline void lock()		{ while (flag.test_and_set(std::memory_order_acquire)) ; }
+			inline void unlock()	{ flag.clear(std::memory_order_release); }
+	};
+
+	/**	\brief	**MutexLock** : Lock policy using a `std::mutex`.
+	 */
+	class MutexLock {
+		private:
+			std::mutex m_mutex;
+		public:
+			inline void lock()		{ m_mutex.lock();	}
+			inline void unlock()	{ m_mutex.unlock();	}
+	};
+
+	/**	\brief	The lock policy used by SynchrotronComponent, SynchrotronComponentFixedInput and Memory by default.
 	 *
-	 *	Includes a `static size_t` with an increment when a new instance is created.
-	 *	This is used in a custom compare method `Mutex::compare`.
+	 *			Define as `SpinLock` or `MutexLock` before including this file for threaded builds.
+	 */
+	#ifndef SYNCHROTRON_LOCK_POLICY
+		#define	SYNCHROTRON_LOCK_POLICY	NullLock
+	#endif
+
+	/**	\brief	Activity counters of one SynchrotronComponent.
+	 *
+	 *			Only counted when SYNCHROTRON_STATISTICS is defined before including this file;
+	 *			otherwise components carry no counters and getActivity() always returns zeros.
+	 */
+	struct ActivityCounters {
+		size_t	ticks;		///< The amount of tick()s issued through update().
+		size_t	emits;		///< The amount of emit()s.
+		size_t	changes;	///< The amount of update()s that changed the state.
+		size_t	toggles;	///< The total amount of bits flipped by those changes.
+
+		ActivityCounters() : ticks(0), emits(0), changes(0), toggles(0) {}
+
+		ActivityCounters& operator+=(const ActivityCounters& other) {
+			this->ticks		+= other.ticks;
+			this->emits		+= other.emits;
+			this->changes	+= other.changes;
+			this->toggles	+= other.toggles;
+			return *this;
+		}
+	};
+
+    /** \brief Ordered class giving every instance a unique id.
+	 *
+	 *	Includes a `static std::atomic<size_t>` with an increment when a new instance is created,
+	 *	so components can be created from several threads at once.
+	 *	This is used in a custom compare method `Ordered::compare`.
      */
-	class Mutex {
+	class Ordered {
 		protected:
-			static size_t mutex_id;
+			static std::atomic<size_t> mutex_id;
 		private:
 			const size_t idx;
-			std::mutex m_mutex;
 		public:
-			Mutex() : idx(mutex_id++)		{}
-			Mutex(const Mutex&) : Mutex()	{}
-			virtual ~Mutex()				{}
-			virtual void lock()				{ m_mutex.lock();	}
-			virtual void unlock()			{ m_mutex.unlock();	}
+			Ordered() : idx(mutex_id.fetch_add(1, std::memory_order_relaxed))	{}
+			Ordered(const Ordered&) : Ordered()	{}
+			virtual ~Ordered()					{}
+
+			/**	\brief	Returns the creation index (the order of `Ordered::compare`).
+			 */
+			inline size_t getOrder() const		{ return this->idx; }
 
 			struct compare {
-				inline bool operator() (const Mutex* lhs, const Mutex* rhs) const {
+				inline bool operator() (const Ordered* lhs, const Ordered* rhs) const {
 					return lhs->idx < rhs->idx;
 				}
 			};
 	};
 
-	/**	\brief	Default `Mutex::mutex_id` to 0.
+	/**	\brief	Default `Ordered::mutex_id` to 0.
 	 */
-	size_t Mutex::mutex_id = 0;
+	std::atomic<size_t> Ordered::mutex_id(0);
+
+    /** \brief Mutex class to lock the current working thread.
+	 *
+	 *	The locking itself is delegated to lock_policy (stored without overhead for NullLock).
+	 *
+	 *	\tparam	lock_policy
+	 *		NullLock, SpinLock or MutexLock.
+     */
+	template <class lock_policy = SYNCHROTRON_LOCK_POLICY>
+	class Mutex : public Ordered, private lock_policy {
+		public:
+			Mutex()							{}
+			Mutex(const Mutex&) : Mutex()	{}
+			inline void lock()				{ lock_policy::lock();		}
+			inline void unlock()			{ lock_policy::unlock();	}
+	};
 
 	/**	\brief
 	 *		Creating a new LockBlock(this) locks the current thread,
 	 *		while leaving the scope conveniently unlocks the thread.
+	 *
+	 *	\tparam	lockable
+	 *		Any class with lock() and unlock() (e.g. a Mutex).
 	 */
+	template <class lockable>
 	class LockBlock {
 		public:
-			Mutex *m_mutex;
-			LockBlock(Mutex *mtx)
+			lockable *m_mutex;
+			LockBlock(lockable *mtx)
 				: m_mutex(mtx)		{ m_mutex->lock();		}
 			~LockBlock()			{ m_mutex->unlock();	}
 	};
 
+	template <size_t bit_width, class lock_policy = SYNCHROTRON_LOCK_POLICY> class SynchrotronComponent;
+	template <size_t bit_width, class lock_policy> class SynchrotronGraph;
+	template <size_t bit_width, class lock_policy> class SynchrotronBuilder;
+
+	/** \brief
+	 *	Propagator is the interface for engines that take over the flow of data between SynchrotronComponents.
+	 *
+	 *	When a Propagator is attached to a SynchrotronComponent, its emit() will hand itself
+	 *	to Propagator::propagate() instead of directly calling tick() on every output.
+	 *
+	 *	\tparam	bit_width
+	 *		This template argument specifies the width of the components it propagates.
+	 *	\tparam	lock_policy
+	 *		The lock policy of the components it propagates.
+	 */
+	template <size_t bit_width, class lock_policy = SYNCHROTRON_LOCK_POLICY>
+	class Propagator {
+		public:
+			/**	\brief	Default destructor
+			 */
+			virtual ~Propagator() {}
+
+			/**	\brief	Called by source.emit() when source changed its state.
+			 *
+			 *	\param	source
+			 *		The SynchrotronComponent whose outputs need to be updated.
+			 */
+			virtual void propagate(SynchrotronComponent<bit_width, lock_policy>& source) = 0;
+	};
+
+	/** \brief
+	 *	DiscardPropagator drops every emit(); used while a component computes its next state (see SynchrotronComponent::evaluateNext()).
+	 */
+	template <size_t bit_width, class lock_policy = SYNCHROTRON_LOCK_POLICY>
+	class DiscardPropagator : public Propagator<bit_width, lock_policy> {
+		public:
+			void propagate(SynchrotronComponent<bit_width, lock_policy>&) {}
+	};
+
+	/** \brief
+	 *	Probe is the interface for observers of a SynchrotronComponent's state (e.g. a waveform writer).
+	 *
+	 *	Unlike an output, an attached Probe is not ticked and does not change the outputs or their order:
+	 *	emit() only hands the component to Probe::sample() before propagating.
+	 *
+	 *	\tparam	bit_width
+	 *		This template argument specifies the width of the components it observes.
+	 *	\tparam	lock_policy
+	 *		The lock policy of the components it observes.
+	 */
+	template <size_t bit_width, class lock_policy = SYNCHROTRON_LOCK_POLICY>
+	class Probe {
+		public:
+			/**	\brief	Default destructor
+			 */
+			virtual ~Probe() {}
+
+			/**	\brief	Called by source.emit() with the (possibly changed) state of source.
+			 *
+			 *	\param	source
+			 *		The SynchrotronComponent that emitted.
+			 */
+			virtual void sample(const SynchrotronComponent<bit_width, lock_policy>& source) = 0;
+
+			/**	\brief	Called with a state of source that holds from the given simulated time on,
+			 *			for changes that are not emitted (e.g. the falling edge of a Clock).
+			 *
+			 *		By default the same as sample(source), ignoring time.
+			 *
+			 *	\param	source
+			 *		The SynchrotronComponent that changed.
+			 *	\param	time
+			 *		The simulated time of the change.
+			 */
+			virtual void sample(const SynchrotronComponent<bit_width, lock_policy>& source, unsigned long long time) {
+				(void) time;
+				this->sample(source);
+			}
+	};
+
 	/** \brief
 	 *	SynchrotronComponent is the base for all components,
 	 *	offering in and output connections to other SynchrotronComponent.
 	 *
 	 *	\tparam	bit_width
 	 *		This template argument specifies the width of the internal bitset state.
+	 *	\tparam	lock_policy
+	 *		This template argument specifies how addInput() etc. are synchronized (NullLock, SpinLock or MutexLock).
      */
-	template <size_t bit_width>
-	class SynchrotronComponent : public Mutex {
+	template <size_t bit_width, class lock_policy>
+	class SynchrotronComponent : public Mutex<lock_policy> {
 		protected:
 			/**	\brief
 			 *		The current internal state of bits in this component (default output).
+			 *		Held in one machine word (NativeBitset) when bit_width <= 64.
 			 */
-			std::bitset<bit_width> state;
+			std::StateBitset<bit_width> state;
 
 		private:
 			/**	\brief
@@ -76,14 +248,72 @@ namespace Synchrotron {
 			 *
 			 *		Emit this.signal to subscribers in slotOutput.
 			 */
-			std::set<SynchrotronComponent*, Mutex::compare> slotOutput;
+			FlatSet<SynchrotronComponent*, Ordered::compare> slotOutput;
 
 			/**	\brief
 			 *	**Signals == inputs**
 			 *
 			 *		Receive tick()s from these subscriptions in signalInput.
 			 */
-			std::set<SynchrotronComponent*, Mutex::compare> signalInput;
+			FlatSet<SynchrotronComponent*, Ordered::compare> signalInput;
+
+			/**	\brief
+			 *	**Ports == inputs in connection order**
+			 *
+			 *		The same components as signalInput, in the order they were connected (see port()).
+			 */
+			std::vector<SynchrotronComponent*> ports;
+
+			/**	\brief
+			 *		The Propagator handling emit() for this SynchrotronComponent (nullptr for recursive tick()s).
+			 */
+			Propagator<bit_width, lock_policy> *propagator;
+
+			/**	\brief
+			 *		The Probe observing this SynchrotronComponent's emit()s (nullptr if none).
+			 */
+			Probe<bit_width, lock_policy> *probe;
+
+			/**	\brief
+			 *		Whether this SynchrotronComponent is evaluated and emits (see setEnabled()).
+			 */
+			bool enabled;
+
+			/**	\brief
+			 *		Whether an emit() was dropped while disabled (see setEnabled()).
+			 */
+			bool missedEmit;
+
+			/**	\brief
+			 *		Whether a SynchrotronGraph created this component (not one of its members) in its blocks.
+			 */
+			bool arenaCreated;
+
+			/**	\brief
+			 *		The amount of evaluations and committed changes so far (see getUpdateCount()).
+			 */
+			size_t updates;
+
+			/**	\brief
+			 *		The amount of changes to the inputs so far (see getInputsVersion()).
+			 */
+			size_t inputsVersion;
+
+			#ifdef SYNCHROTRON_STATISTICS
+				/**	\brief
+				 *		The activity of this SynchrotronComponent.
+				 */
+				ActivityCounters activity;
+
+				/**	\brief	Count a state change from before to the current state.
+				 */
+				inline void countChange(const std::StateBitset<bit_width>& before) {
+					if (before == this->state) return;
+
+					++this->activity.changes;
+					this->activity.toggles += (before ^ this->state).count();
+				}
+			#endif
 
             /**	\brief	Connect a new slot s:
              *		* Add s to this SynchrotronComponent's outputs.
@@ -96,7 +326,10 @@ namespace Synchrotron {
 				//LockBlock lock(this);
 
 				this->slotOutput.insert(s);
-				s->signalInput.insert(this);
+				if (s->signalInput.insert(this)) {
+					s->ports.push_back(this);
+					++s->inputsVersion;
+				}
 			}
 
             /**	\brief	Disconnect a slot s:
@@ -110,16 +343,39 @@ namespace Synchrotron {
 				//LockBlock lock(this);
 
 				this->slotOutput.erase(s);
-				s->signalInput.erase(this);
+				if (s->signalInput.erase(this)) {
+					s->erasePort(this);
+					++s->inputsVersion;
+				}
+			}
+
+			/**	\brief	Remove input from the ports, keeping the order of the others.
+			 */
+			inline void erasePort(SynchrotronComponent* input) {
+				auto pos = std::find(this->ports.begin(), this->ports.end(), input);
+				if (pos != this->ports.end()) this->ports.erase(pos);
+			}
+
+			/**	\brief	Drop all connections without unlinking this from the other side,
+			 *			for when every connected SynchrotronComponent is destroyed together (see SynchrotronGraph).
+			 */
+			inline void forgetConnections(void) {
+				this->slotOutput.clear();
+				this->signalInput.clear();
+				this->ports.clear();
+				++this->inputsVersion;
 			}
 
+			friend class SynchrotronGraph<bit_width, lock_policy>;
+			friend class SynchrotronBuilder<bit_width, lock_policy>;
+
 		public:
             /** \brief	Default constructor
              *
              *	\param	initial_value
 			 *		The initial state of the internal bitset.
              */
-			SynchrotronComponent(size_t initial_value = 0) : state(initial_value) {}
+			SynchrotronComponent(size_t initial_value = 0) : state(initial_value), propagator(nullptr), probe(nullptr), enabled(true), missedEmit(false), arenaCreated(false), updates(0), inputsVersion(0) {}
 
 			/**	\brief **[Thread safe]**
 			 *	Copy constructor
@@ -134,8 +390,8 @@ namespace Synchrotron {
 			SynchrotronComponent(const SynchrotronComponent& sc, bool duplicateAll_IO = false) : SynchrotronComponent() {
 				//LockBlock lock(this);
 
-				// Copy subscriptions
-				for(auto& sender : sc.signalInput) {
+				// Copy subscriptions (in port order)
+				for(auto& sender : sc.ports) {
 					this->addInput(*sender);
 				}
 
@@ -169,11 +425,13 @@ namespace Synchrotron {
 			 *		When called, will disconnect all in and output connections to this SynchrotronComponent.
              */
 			~SynchrotronComponent() {
-				LockBlock lock(this);
+				LockBlock<SynchrotronComponent> lock(this);
 
 				// Disconnect all Slots
 				for(auto& connection : this->slotOutput) {
 					connection->signalInput.erase(this);
+					connection->erasePort(this);
+					++connection->inputsVersion;
 					//delete connection; //?
 				}
 
@@ -184,6 +442,7 @@ namespace Synchrotron {
 
 				this->slotOutput.clear();
 				this->signalInput.clear();
+				this->ports.clear();
 			}
 
             /**	\brief	Gets this SynchrotronComponent's bit width.
@@ -218,24 +477,119 @@ namespace Synchrotron {
 				return this->state;
 			}
 
+			/**	\brief	Gets this SynchrotronComponent's state in its native representation.
+             *
+             *	\return	const std::StateBitset<bit_width>&
+             *      Returns the internal state (a NativeBitset for bit_width <= 64), without conversion.
+             */
+			inline const std::StateBitset<bit_width>& getNativeState() const {
+				return this->state;
+			}
+
+			/**	\brief	Gets the SynchrotronComponent's max inputs.
+			 *
+			 *	\return	size_t
+			 *      Returns the maximum amount of inputs (unlimited, unless a derived class limits it).
+			 */
+			virtual inline size_t getMaxInputs() const {
+				return std::numeric_limits<size_t>::max();
+			}
+
 			/**	\brief	Gets the SynchrotronComponent's input connections.
 			 *
-			 *	\return	std::set<SynchrotronComponent*>&
-			 *      Returns a reference set to this SynchrotronComponent's inputs.
+			 *	\return	FlatSet<SynchrotronComponent*>&
+			 *      Returns a reference set to this SynchrotronComponent's inputs (contiguous, sorted by creation).
 			 */
-			const std::set<SynchrotronComponent*, Mutex::compare>& getInputs() const {
+			const FlatSet<SynchrotronComponent*, Ordered::compare>& getInputs() const {
 				return this->signalInput;
 			}
 
+			/**	\brief	Gets the input connected as port i: the (i + 1)-th input in connection order.
+			 *
+			 *		Non-commutative components read their operands through ports, so `SUBTRACT({&a, &b})`
+			 *		is a - b whatever the creation order of a and b. Disconnecting an input shifts the later ports.
+			 *
+			 *	\param	i
+			 *		The port index, less than getPorts().size().
+			 *	\return	SynchrotronComponent&
+			 *      Returns the input at port i.
+			 *	\exception	Exceptions::OutOfBoundsException
+			 *		Throws exception if there is no port i (only with THROW_EXCEPTIONS).
+			 */
+			inline SynchrotronComponent& port(size_t i) const {
+				#ifdef THROW_EXCEPTIONS
+					if (i >= this->ports.size())
+						throw Exceptions::OutOfBoundsException(int(i));
+				#endif
+				return *this->ports[i];
+			}
+
+			/**	\brief	Gets the SynchrotronComponent's input connections in connection order (see port()).
+			 *
+			 *	\return	std::vector<SynchrotronComponent*>&
+			 *      Returns a reference to this SynchrotronComponent's ports.
+			 */
+			const std::vector<SynchrotronComponent*>& getPorts() const {
+				return this->ports;
+			}
+
 			/**	\brief	Gets the SynchrotronComponent's output connections.
 			 *
-			 *	\return	std::set<SynchrotronComponent*>&
-			 *      Returns a reference set to this SynchrotronComponent's outputs.
+			 *	\return	FlatSet<SynchrotronComponent*>&
+			 *      Returns a reference set to this SynchrotronComponent's outputs (contiguous, sorted by creation).
 			 */
-			const std::set<SynchrotronComponent*, Mutex::compare>& getOutputs() const {
+			const FlatSet<SynchrotronComponent*, Ordered::compare>& getOutputs() const {
 				return this->slotOutput;
 			}
 
+			/**	\brief	Gets the Propagator handling this SynchrotronComponent's emit().
+			 *
+			 *	\return	Propagator<bit_width, lock_policy>*
+			 *      Returns the attached Propagator or nullptr if emit() ticks outputs directly.
+			 */
+			inline Propagator<bit_width, lock_policy>* getPropagator() const {
+				return this->propagator;
+			}
+
+			/**	\brief	Attach a Propagator to handle emit() for this SynchrotronComponent.
+			 *
+			 *	\param	p
+			 *		The Propagator to attach, or nullptr to revert to recursive tick()s.
+			 */
+			inline void setPropagator(Propagator<bit_width, lock_policy> *p) {
+				this->propagator = p;
+			}
+
+			/**	\brief	Gets the Probe observing this SynchrotronComponent.
+			 *
+			 *	\return	Probe<bit_width, lock_policy>*
+			 *      Returns the attached Probe or nullptr if there is none.
+			 */
+			inline Probe<bit_width, lock_policy>* getProbe() const {
+				return this->probe;
+			}
+
+			/**	\brief	Attach a Probe that samples every emit() of this SynchrotronComponent (replacing the previous one).
+			 *
+			 *	\param	p
+			 *		The Probe to attach, or nullptr to detach.
+			 */
+			inline void setProbe(Probe<bit_width, lock_policy> *p) {
+				this->probe = p;
+			}
+
+			/**	\brief	Reserve room for the given amount of connections, before connecting many at once.
+			 *
+			 *	\param	inputs
+			 *		The expected amount of inputs.
+			 *	\param	outputs
+			 *		The expected amount of outputs.
+			 */
+			inline void reserveConnections(size_t inputs, size_t outputs) {
+				this->signalInput.reserve(inputs);
+				this->slotOutput.reserve(outputs);
+			}
+
             /**	\brief	**[Thread safe]** Adds/Connects a new input to this SynchrotronComponent.
              *
              *	**Ensures both way connection will be made:**
@@ -245,7 +599,7 @@ namespace Synchrotron {
              *		The SynchrotronComponent to connect as input.
              */
 			virtual void addInput(SynchrotronComponent& input) {
-				LockBlock lock(this);
+				LockBlock<SynchrotronComponent> lock(this);
 
 				// deprecated? //if (!this->hasSameWidth(input)) return false;
 				input.connectSlot(this);
@@ -272,7 +626,7 @@ namespace Synchrotron {
              *		The SynchrotronComponent to disconnect as input.
              */
 			void removeInput(SynchrotronComponent& input) {
-				LockBlock lock(this);
+				LockBlock<SynchrotronComponent> lock(this);
 
 				input.disconnectSlot(this);
 			}
@@ -286,7 +640,7 @@ namespace Synchrotron {
              *		The SynchrotronComponent to connect as output.
              */
 			void addOutput(SynchrotronComponent& output) {
-				LockBlock lock(this);
+				LockBlock<SynchrotronComponent> lock(this);
 
 				// deprecated? //if (!this->hasSameWidth(*output)) return false;
 				this->connectSlot(&output);
@@ -313,7 +667,7 @@ namespace Synchrotron {
              *		The SynchrotronComponent to disconnect as output.
              */
 			void removeOutput(SynchrotronComponent& output) {
-				LockBlock lock(this);
+				LockBlock<SynchrotronComponent> lock(this);
 
 				this->disconnectSlot(&output);
 			}
@@ -325,12 +679,12 @@ namespace Synchrotron {
              */
 			virtual void tick() {
 				//LockBlock lock(this);
-				std::bitset<bit_width> prevState = this->state;
+				const std::StateBitset<bit_width> prevState = this->state;
 
 				//std::cout << "Ticked\n";
 				for(auto& connection : this->signalInput) {
 					// Change this line to change the logic applied on the states:
-					this->state |= ((SynchrotronComponent*) connection)->getState();
+					this->state |= ((SynchrotronComponent*) connection)->getNativeState();
 				}
 
 				// Directly emit changes to subscribers on change
@@ -338,9 +692,194 @@ namespace Synchrotron {
 					this->emit();
 			}
 
+			/**	\brief	The tickInput() method will be called instead of tick() when only source (one of the inputs) emitted.
+			 *
+			 *		Components that can update their state from one changed input in less time than
+			 *		tick() (e.g. gates with a summary of their inputs) re-implement this; the default calls tick().
+			 *
+			 *	\param	source
+			 *		The input that emitted.
+			 */
+			virtual void tickInput(const SynchrotronComponent& /*source*/) {
+				this->tick();
+			}
+
+			/**	\brief	tick() this SynchrotronComponent, counting its activity if SYNCHROTRON_STATISTICS is defined.
+			 *
+			 *		Every propagation engine (and the recursive emit()) ticks components through here.
+			 */
+			inline void update() {
+				// Almost always enabled, so this check costs a well-predicted branch.
+				if (!this->enabled) return;
+
+				++this->updates;
+				#ifdef SYNCHROTRON_STATISTICS
+					const std::StateBitset<bit_width> before = this->state;
+					++this->activity.ticks;
+					this->tick();
+					this->countChange(before);
+				#else
+					this->tick();
+				#endif
+			}
+
+			/**	\brief	update() after only source (one of the inputs) emitted: calls tickInput(source) instead of tick().
+			 *
+			 *		Used by the recursive emit(); engines that may change several inputs at once call update().
+			 */
+			inline void update(const SynchrotronComponent& source) {
+				if (!this->enabled) return;
+
+				++this->updates;
+				#ifdef SYNCHROTRON_STATISTICS
+					const std::StateBitset<bit_width> before = this->state;
+					++this->activity.ticks;
+					this->tickInput(source);
+					this->countChange(before);
+				#else
+					this->tickInput(source);
+				#endif
+			}
+
+			/**	\brief	Returns the activity of this SynchrotronComponent (all zeros without SYNCHROTRON_STATISTICS).
+			 */
+			inline ActivityCounters getActivity() const {
+				#ifdef SYNCHROTRON_STATISTICS
+					return this->activity;
+				#else
+					return ActivityCounters();
+				#endif
+			}
+
+			/**	\brief	Reset the activity counters.
+			 */
+			inline void resetActivity() {
+				#ifdef SYNCHROTRON_STATISTICS
+					this->activity = ActivityCounters();
+				#endif
+			}
+
+			/**	\brief	Enable or disable this SynchrotronComponent.
+			 *
+			 *		A disabled component skips tick() (in every propagation engine and evaluateNext())
+			 *		and emits nothing, so nothing downstream of it is evaluated either; its state holds.
+			 *		Enabling it evaluates it with its current inputs, counted like an update(), and emits once
+			 *		if its state changed or an emit() was dropped while it was disabled (e.g. by setState()).
+			 *
+			 *	\param	enable
+			 *		Whether to enable this component.
+			 */
+			void setEnabled(bool enable) {
+				if (enable == this->enabled) return;
+
+				this->enabled = enable;
+				if (!enable) return;
+
+				const std::StateBitset<bit_width> before = this->state;
+				const bool missed = this->missedEmit;
+				this->missedEmit = false;
+
+				if (!this->signalInput.empty())
+					this->commit(this->evaluateNext());
+				if (missed && this->state == before)
+					this->emit();
+			}
+
+			/**	\brief	Returns whether this SynchrotronComponent is enabled (see setEnabled()).
+			 */
+			inline bool isEnabled() const {
+				return this->enabled;
+			}
+
+			/**	\brief	Returns a number that changes whenever an input is connected or disconnected.
+			 */
+			inline size_t getInputsVersion() const {
+				return this->inputsVersion;
+			}
+
+			/**	\brief	Returns the amount of evaluations (update(), evaluateNext()) and commit()ted changes
+			 *			of this SynchrotronComponent so far.
+			 *
+			 *		Every input that changes has its outputs evaluated, by update() or, in two-phase engines,
+			 *		by evaluateNext(), so an unchanged count means no input has changed since
+			 *		and the state was not replaced (see Clock quiescence tracking).
+			 */
+			inline size_t getUpdateCount() const {
+				return this->updates;
+			}
+
+			/**	\brief	Whether tick() depends on more than the states of the inputs and this component
+			 *			(e.g. a state machine stepping on every clock edge, or an operation set from outside).
+			 *
+			 *		Such components are never skipped as quiescent. Override to return true.
+			 */
+			virtual inline bool hasHiddenState() const {
+				return false;
+			}
+
+			/**	\brief	Two-phase evaluation, phase 1: compute the state tick() would produce without changing the visible state.
+			 *
+			 *		tick() runs with its emit()s discarded and the current state is restored afterwards,
+			 *		so every component evaluated in the same phase still reads the old state of this one.
+			 *		Only the state is double-buffered; other side effects of tick() (e.g. flags) happen immediately.
+			 *
+			 *	\return	std::StateBitset<bit_width>
+			 *		Returns the next state, to be passed to commit().
+			 */
+			std::StateBitset<bit_width> evaluateNext() {
+				static DiscardPropagator<bit_width, lock_policy> discard;
+				const std::StateBitset<bit_width> current = this->state;
+
+				if (!this->enabled) return current;
+				++this->updates;
+				Propagator<bit_width, lock_policy> *attached = this->propagator;
+				Probe<bit_width, lock_policy> *observer = this->probe;
+
+				// The next state is not visible yet, so the probe must not sample it either.
+				this->propagator = &discard;
+				this->probe = nullptr;
+				try {
+					#ifdef SYNCHROTRON_STATISTICS
+						++this->activity.ticks;
+					#endif
+					this->tick();
+				} catch (...) {
+					this->state = current;
+					this->propagator = attached;
+					this->probe = observer;
+					throw;
+				}
+
+				const std::StateBitset<bit_width> next = this->state;
+				this->state = current;
+				this->propagator = attached;
+				this->probe = observer;
+				return next;
+			}
+
+			/**	\brief	Two-phase evaluation, phase 2: make next the visible state and emit() if it changed.
+			 *
+			 *	\param	next
+			 *		The state computed by evaluateNext().
+			 */
+			inline void commit(const std::StateBitset<bit_width>& next) {
+				if (next == this->state) return;
+
+				++this->updates;
+				#ifdef SYNCHROTRON_STATISTICS
+					const std::StateBitset<bit_width> before = this->state;
+					this->state = next;
+					this->countChange(before);
+				#else
+					this->state = next;
+				#endif
+				this->emit();
+			}
+
 			/**	\brief	The emit() method will be called after a tick() completes to ensure the flow of new data.
 			 *
-			 *	Loops over all outputs and calls tick().
+			 *	Loops over all outputs and calls tick(),
+			 *	or hands this to the attached Propagator when there is one.
 			 *
              *	\return	virtual void
              *		This method can be re-implemented by a derived class.
@@ -348,13 +887,67 @@ namespace Synchrotron {
 			virtual inline void emit() {
 				//LockBlock lock(this);
 
+				if (!this->enabled) {
+					this->missedEmit = true;
+					return;
+				}
+
+				#ifdef SYNCHROTRON_STATISTICS
+					++this->activity.emits;
+				#endif
+
+				if (this->probe)
+					this->probe->sample(*this);
+
+				if (this->propagator) {
+					this->propagator->propagate(*this);
+					return;
+				}
+
 				for(auto& connection : this->slotOutput) {
-					connection->tick();
+					connection->update(*this);
 				}
 				//std::cout << "Emitted\n";
 			}
 	};
 
+	/**	\brief	Collect every SynchrotronComponent connected (through in- and outputs) to the given roots.
+	 *
+	 *	\tparam	bit_width
+	 *		The width of the components in the graph.
+	 *	\param	roots
+	 *		Any iterable of SynchrotronComponent<bit_width>* (nullptrs are skipped).
+	 *
+	 *	\return	std::vector<SynchrotronComponent<bit_width>*>
+	 *		Returns every component in the graph, each exactly once.
+	 */
+	template <size_t bit_width, class Iterable>
+	std::vector<SynchrotronComponent<bit_width>*> collectGraph(const Iterable& roots) {
+		std::vector<SynchrotronComponent<bit_width>*> nodes, stack;
+		std::unordered_set<const SynchrotronComponent<bit_width>*> seen;
+
+		for (auto root : roots) {
+			if (root && seen.insert(root).second)
+				stack.push_back(root);
+		}
+
+		while (!stack.empty()) {
+			SynchrotronComponent<bit_width> *node = stack.back();
+			stack.pop_back();
+			nodes.push_back(node);
+
+			for (auto& connection : node->getInputs())
+				if (seen.insert(connection).second)
+					stack.push_back(connection);
+
+			for (auto& connection : node->getOutputs())
+				if (seen.insert(connection).second)
+					stack.push_back(connection);
+		}
+
+		return nodes;
+	}
+
 }
 
 
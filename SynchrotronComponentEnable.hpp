@@ -1,27 +1,72 @@
 #ifndef SYNCHROTRONCOMPONENTENABLE_HPP
 #define SYNCHROTRONCOMPONENTENABLE_HPP
 
+#include <memory>
+
 #include "SynchrotronComponentFixedInput.hpp"
 #include "Exceptions.hpp"
 using namespace Synchrotron;
 
 namespace Synchrotron {
 
-	class SynchrotronComponentEnable : public SynchrotronComponentFixedInput<1u, 1u> {
+	/** \brief	**SynchrotronComponentEnable** : SynchrotronComponentFixedInput with an enable line.
+	 *
+	 *		As the enable of a register or bus driver: while the 1-bit enable line is 0, this component
+	 *		is disabled (see SynchrotronComponent::setEnabled()): it is not evaluated and emits nothing,
+	 *		so nothing downstream of it is evaluated either. When the line returns to 1,
+	 *		this component is evaluated with its current inputs and emits once.
+	 *		Without an enable line the component is always enabled (unless setEnabled() is used directly).
+	 *
+	 *	\tparam	bit_width
+	 *		This template argument specifies the width of the in and output connections.
+	 *	\tparam	max_inputs
+	 *		This template argument specifies the maximum amount of input connections.
+	 *	\tparam	lock_policy
+	 *		This template argument specifies how addInput() etc. are synchronized (NullLock, SpinLock or MutexLock).
+	 */
+	template <size_t bit_width, size_t max_inputs = 1u, class lock_policy = SYNCHROTRON_LOCK_POLICY>
+	class SynchrotronComponentEnable : public SynchrotronComponentFixedInput<bit_width, max_inputs, lock_policy> {
+		private:
+			/**	\brief	The 1-bit component receiving the enable line, forwarding its state to setEnabled().
+			 */
+			class EnableInput : public SynchrotronComponentFixedInput<1u, 1u, lock_policy> {
+				private:
+					SynchrotronComponentEnable *target;
+
+				public:
+					explicit EnableInput(SynchrotronComponentEnable *target) : target(target) {}
+
+					void tick(void) {
+						this->state = this->getInput().getNativeState();
+						this->target->setEnabled(this->state.any());
+					}
+			};
+
+			/**	\brief	The receiver of the enable line (only allocated once a line is set).
+			 */
+			std::unique_ptr<EnableInput> enableInput;
+
 		public:
 			/**
 			 *	Default constructor
 			 */
-			SynchrotronComponentEnable(size_t initial_value = 0) : SynchrotronComponentFixedInput<1u, 1u>(initial_value) {}
+			SynchrotronComponentEnable(size_t initial_value = 0) : SynchrotronComponentFixedInput<bit_width, max_inputs, lock_policy>(initial_value) {}
 
-			/**	Copy constructor
+			/**	Copy constructor (the enable line is not copied)
 			 *	\param	other
 			 *		SynchrotronComponent to copy from
 			 *	\param	duplicateAll_IO
 			 *		Specifies whether to only copy inputs (false) or outputs as well (true).
 			 */
-			SynchrotronComponentEnable(const SynchrotronComponent<1u>& other, bool duplicateAll_IO = false)
-				: SynchrotronComponentFixedInput<1u, 1u>(other, duplicateAll_IO) {}
+			SynchrotronComponentEnable(const SynchrotronComponent<bit_width, lock_policy>& other, bool duplicateAll_IO = false)
+				: SynchrotronComponentFixedInput<bit_width, max_inputs, lock_policy>(other, duplicateAll_IO) {}
+
+			/**	Copy constructor (the enable line is not copied)
+			 *	\param	other
+			 *		SynchrotronComponentEnable to copy the inputs from
+			 */
+			SynchrotronComponentEnable(const SynchrotronComponentEnable& other)
+				: SynchrotronComponentEnable(static_cast<const SynchrotronComponent<bit_width, lock_policy>&>(other)) {}
 
 			/**	\brief
 			 *	Connection constructor
@@ -33,22 +78,42 @@ namespace Synchrotron {
 			 *	\param	outputList
 			 *		The list of SynchrotronComponents to connect as output.
 			 */
-			SynchrotronComponentEnable(	std::initializer_list<SynchrotronComponent<1u>*> inputList,
-										std::initializer_list<SynchrotronComponent<1u>*> outputList = {} )
-									: SynchrotronComponentFixedInput<1u, 1u>(inputList, outputList) {}
+			SynchrotronComponentEnable(	std::initializer_list<SynchrotronComponent<bit_width, lock_policy>*> inputList,
+										std::initializer_list<SynchrotronComponent<bit_width, lock_policy>*> outputList = {} )
+									: SynchrotronComponentFixedInput<bit_width, max_inputs, lock_policy>(inputList, outputList) {}
 
 			/**
 			 *	Default destructor
 			 */
 			~SynchrotronComponentEnable() {}
 
-			void setEnable(SynchrotronComponent& input) {
-				this->enable = &input;
+			/**	\brief	Connect the enable line, replacing the previous one, and apply its current state.
+			 *
+			 *	\param	input
+			 *		The 1-bit component driving the enable (1 = enabled).
+			 */
+			void setEnable(SynchrotronComponent<1u, lock_policy>& input) {
+				this->clearEnable();
+				this->enableInput.reset(new EnableInput(this));
+				this->enableInput->addInput(input);
+				this->enableInput->tick();
 			}
 
-//			void setEnable(SynchrotronComponent& input) {
-//				this->enable = &input;
-//			}
+			/**	\brief	Disconnect the enable line and enable this component.
+			 */
+			void clearEnable(void) {
+				if (!this->enableInput) return;
+
+				this->enableInput.reset();
+				this->setEnabled(true);
+			}
+
+			/**	\brief	Returns the enable line, or nullptr if there is none.
+			 */
+			const SynchrotronComponent<1u, lock_policy>* getEnable(void) const {
+				return this->enableInput && !this->enableInput->getInputs().empty()
+					 ? &this->enableInput->port(0) : nullptr;
+			}
 	};
 }
 
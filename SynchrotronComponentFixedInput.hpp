@@ -14,14 +14,16 @@ namespace Synchrotron {
 	 *		This template argument specifies the width of the in and output connections.
 	 *	\tparam	max_inputs
 	 *		This template argument specifies the maximum amount of input connections.
+	 *	\tparam	lock_policy
+	 *		This template argument specifies how addInput() etc. are synchronized (NullLock, SpinLock or MutexLock).
 	 */
-	template <size_t bit_width, size_t max_inputs>
-	class SynchrotronComponentFixedInput : public SynchrotronComponent<bit_width> {
+	template <size_t bit_width, size_t max_inputs, class lock_policy = SYNCHROTRON_LOCK_POLICY>
+	class SynchrotronComponentFixedInput : public SynchrotronComponent<bit_width, lock_policy> {
 		public:
 			/**
 			 *	Default constructor
 			 */
-			SynchrotronComponentFixedInput(size_t initial_value = 0) : SynchrotronComponent<bit_width>(initial_value) {}
+			SynchrotronComponentFixedInput(size_t initial_value = 0) : SynchrotronComponent<bit_width, lock_policy>(initial_value) {}
 
 			/**	\brief **[Thread safe]**
 			 *	Copy constructor
@@ -33,11 +35,11 @@ namespace Synchrotron {
 			 *	\param	duplicateAll_IO
 			 *		Specifies whether to only copy inputs (false) or outputs as well (true).
 			 */
-			SynchrotronComponentFixedInput(const SynchrotronComponent<bit_width>& sc, bool duplicateAll_IO = false) : SynchrotronComponentFixedInput<bit_width, max_inputs>() {
+			SynchrotronComponentFixedInput(const SynchrotronComponent<bit_width, lock_policy>& sc, bool duplicateAll_IO = false) : SynchrotronComponentFixedInput<bit_width, max_inputs, lock_policy>() {
 				//LockBlock lock(this);
 
-				// Copy subscriptions
-				for(auto& sender : sc.getInputs()) {
+				// Copy subscriptions (in port order)
+				for(auto& sender : sc.getPorts()) {
 					this->addInput(*sender);
 				}
 
@@ -59,9 +61,9 @@ namespace Synchrotron {
 			 *	\param	outputList
 			 *		The list of SynchrotronComponents to connect as output.
 			 */
-			SynchrotronComponentFixedInput(	std::initializer_list<SynchrotronComponent<bit_width>*> inputList,
-											std::initializer_list<SynchrotronComponent<bit_width>*> outputList = {} )
-									: SynchrotronComponentFixedInput<bit_width, max_inputs>() {
+			SynchrotronComponentFixedInput(	std::initializer_list<SynchrotronComponent<bit_width, lock_policy>*> inputList,
+											std::initializer_list<SynchrotronComponent<bit_width, lock_policy>*> outputList = {} )
+									: SynchrotronComponentFixedInput<bit_width, max_inputs, lock_policy>() {
 				this->addInput(inputList);
 				this->addOutput(outputList);
 			}
@@ -85,8 +87,8 @@ namespace Synchrotron {
 			 *	\return	SynchrotronComponent&
 			 *      Returns a reference set to this SynchrotronComponent's input.
 			 */
-			const SynchrotronComponent<bit_width>& getInput() const {
-				return **this->getInputs().begin();
+			const SynchrotronComponent<bit_width, lock_policy>& getInput() const {
+				return this->port(0);
 			}
 
 			/**	\brief	**[Thread safe]** Adds/Connects a new input to this SynchrotronComponent.
@@ -99,7 +101,7 @@ namespace Synchrotron {
 			 *	\exception	Exceptions::Exception
 			 *		Throws exception if getInputs() already contains max_inputs.
 			 */
-			void addInput(SynchrotronComponent<bit_width>& input) {
+			void addInput(SynchrotronComponent<bit_width, lock_policy>& input) {
 				if (this->getInputs().size() >= max_inputs) {
 					#ifdef THROW_EXCEPTIONS
 						throw Exceptions::Exception("[SynchrotronComponentFixedInput] This component already has its required inputs!");
@@ -107,7 +109,7 @@ namespace Synchrotron {
 					return;
 				}
 
-				SynchrotronComponent<bit_width>::addInput(input);
+				SynchrotronComponent<bit_width, lock_policy>::addInput(input);
 			}
 
 			/**	\brief	Adds/Connects a list of new inputs to this SynchrotronComponent.
@@ -117,7 +119,7 @@ namespace Synchrotron {
 			 *	\param	inputList
 			 *		The list of SynchrotronComponents to connect as input.
 			 */
-			void addInput(std::initializer_list<SynchrotronComponent<bit_width>*> inputList) {
+			void addInput(std::initializer_list<SynchrotronComponent<bit_width, lock_policy>*> inputList) {
 				for(auto connection : inputList)
 					this->addInput(*connection);
 			}
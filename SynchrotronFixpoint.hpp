@@ -0,0 +1,481 @@
+/**
+*	Evaluation of SynchrotronComponent graphs with feedback loops.
+*/
+#ifndef SYNCHROTRONFIXPOINT_HPP
+#define SYNCHROTRONFIXPOINT_HPP
+
+#include <vector>
+#include <algorithm>
+#include <unordered_map>
+#include <initializer_list>
+
+#include "SynchrotronComponent.hpp"
+#include "Exceptions.hpp"
+
+namespace Synchrotron {
+
+	/**	\brief	Split every SynchrotronComponent connected to roots into strongly connected components.
+	 *
+	 *			Iterative Tarjan's algorithm, so deep graphs do not exhaust the stack.
+	 *
+	 *	\tparam	bit_width
+	 *		The width of the components in the graph.
+	 *	\param	roots
+	 *		Any iterable of SynchrotronComponent<bit_width>*; everything connected to them is included.
+	 *
+	 *	\return	std::vector<std::vector<SynchrotronComponent<bit_width>*>>
+	 *		Returns the strongly connected components in topological order (inputs before outputs),
+	 *		each sorted by creation order. A component that is not part of a loop forms one on its own.
+	 */
+	template <size_t bit_width, class Iterable>
+	std::vector<std::vector<SynchrotronComponent<bit_width>*>> stronglyConnected(const Iterable& roots) {
+		std::vector<SynchrotronComponent<bit_width>*> nodes = collectGraph<bit_width>(roots);
+		std::unordered_map<const SynchrotronComponent<bit_width>*, size_t> id;
+		std::vector<size_t> order(nodes.size(), 0), low(nodes.size(), 0), stack;
+		std::vector<char> onStack(nodes.size(), 0);
+		std::vector<std::pair<size_t, size_t>> call;	// (node, index of the next output to visit)
+		std::vector<std::vector<SynchrotronComponent<bit_width>*>> sccs;
+		size_t counter = 0;
+
+		for (size_t i = 0; i < nodes.size(); ++i)
+			id[nodes[i]] = i;
+
+		for (size_t root = 0; root < nodes.size(); ++root) {
+			if (order[root]) continue;
+
+			call.emplace_back(root, 0);
+			order[root] = low[root] = ++counter;
+			stack.push_back(root);
+			onStack[root] = 1;
+
+			while (!call.empty()) {
+				const size_t v = call.back().first;
+				const auto& outputs = nodes[v]->getOutputs();
+
+				if (call.back().second < outputs.size()) {
+					const size_t w = id[outputs[call.back().second++]];
+
+					if (!order[w]) {
+						order[w] = low[w] = ++counter;
+						stack.push_back(w);
+						onStack[w] = 1;
+						call.emplace_back(w, 0);
+					} else if (onStack[w] && order[w] < low[v]) {
+						low[v] = order[w];
+					}
+					continue;
+				}
+
+				call.pop_back();
+				if (!call.empty() && low[v] < low[call.back().first])
+					low[call.back().first] = low[v];
+
+				if (low[v] == order[v]) {
+					std::vector<SynchrotronComponent<bit_width>*> scc;
+					size_t w;
+
+					do {
+						w = stack.back();
+						stack.pop_back();
+						onStack[w] = 0;
+						scc.push_back(nodes[w]);
+					} while (w != v);
+
+					std::sort(scc.begin(), scc.end(), Ordered::compare());
+					sccs.push_back(scc);
+				}
+			}
+		}
+
+		// Tarjan finds every strongly connected component after all components it leads to.
+		std::reverse(sccs.begin(), sccs.end());
+		return sccs;
+	}
+
+	/**	\brief	Returns whether the strongly connected component scc is a feedback loop
+	 *			(more than one component, or one component that is its own input).
+	 */
+	template <size_t bit_width>
+	inline bool isLoop(const std::vector<SynchrotronComponent<bit_width>*>& scc) {
+		return scc.size() > 1 || (scc.size() == 1 && scc.front()->getInputs().count(scc.front()));
+	}
+
+	/**	\brief	Find every feedback loop in the graph connected to roots.
+	 *
+	 *	\return	std::vector<std::vector<SynchrotronComponent<bit_width>*>>
+	 *		Returns the components of each loop, in topological order of the loops.
+	 */
+	template <size_t bit_width, class Iterable>
+	std::vector<std::vector<SynchrotronComponent<bit_width>*>> findLoops(const Iterable& roots) {
+		std::vector<std::vector<SynchrotronComponent<bit_width>*>> loops;
+
+		for (auto& scc : stronglyConnected<bit_width>(roots))
+			if (isLoop<bit_width>(scc))
+				loops.push_back(scc);
+
+		return loops;
+	}
+
+	/**	\brief	Find every feedback loop in the graph connected to roots.
+	 */
+	template <size_t bit_width>
+	std::vector<std::vector<SynchrotronComponent<bit_width>*>> findLoops(std::initializer_list<SynchrotronComponent<bit_width>*> roots) {
+		return findLoops<bit_width, std::initializer_list<SynchrotronComponent<bit_width>*>>(roots);
+	}
+
+	/** \brief	**SynchrotronFixpointNetlist** : Scheduled evaluation of a graph that may contain feedback loops.
+	 *
+	 *	compile() splits the graph into strongly connected components and orders them topologically.
+	 *	Like SynchrotronNetlist, this netlist is attached as Propagator to every component, so emit()
+	 *	only marks the fan-out dirty. Components outside of loops are then tick()ed once, in order;
+	 *	the components of a loop (e.g. a latch of cross-coupled NORGates) are tick()ed repeatedly until
+	 *	none of them changes anymore (the fixpoint) or the iteration limit is reached.
+	 *	A loop that hits the limit oscillates: it is recorded (see getOscillations()) and left in its
+	 *	current state, or an exception is thrown when setThrowOnOscillation() is enabled.
+	 *
+	 *	The netlist does not own its components and must be released (or destroyed) before them.
+	 *
+	 *	\tparam	bit_width
+	 *		This template argument specifies the width of the components in the graph.
+	 */
+	template <size_t bit_width>
+	class SynchrotronFixpointNetlist : public Propagator<bit_width> {
+		public:
+			/**	\brief	A loop that did not settle within the iteration limit.
+			 */
+			struct Oscillation {
+				std::vector<SynchrotronComponent<bit_width>*>	loop;		///< The components of the loop.
+				size_t											iterations;	///< The iterations done before giving up.
+			};
+
+		private:
+			/**	\brief	All components, grouped per strongly connected component (block) in topological order.
+			 */
+			std::vector<SynchrotronComponent<bit_width>*> schedule;
+
+			/**	\brief	Offset of the first component of each block in schedule (blocks + 1 entries).
+			 */
+			std::vector<size_t> blockOffsets;
+
+			/**	\brief	Whether each block is a feedback loop.
+			 */
+			std::vector<char> loop;
+
+			/**	\brief	The block of each schedule position.
+			 */
+			std::vector<size_t> blockOf;
+
+			/**	\brief	Position of each component in schedule.
+			 */
+			std::unordered_map<const SynchrotronComponent<bit_width>*, size_t> index;
+
+			/**	\brief	Offset of the fan-out of each schedule position in fanout (CSR, schedule.size() + 1 entries).
+			 */
+			std::vector<size_t> fanoutOffsets;
+
+			/**	\brief	Schedule positions of the outputs of each component (CSR).
+			 */
+			std::vector<size_t> fanout;
+
+			/**	\brief	Whether the component on each schedule position awaits a tick().
+			 */
+			std::vector<char> dirty;
+
+			/**	\brief	The range of blocks that may contain dirty components.
+			 */
+			size_t firstDirty, lastDirty;
+
+			/**	\brief	Whether the schedule is currently being evaluated (propagate() only marks components).
+			 */
+			bool propagating;
+
+			/**	\brief	The maximum amount of passes over a loop before it is considered oscillating.
+			 */
+			size_t iterationLimit;
+
+			/**	\brief	Whether an oscillating loop throws instead of only being recorded.
+			 */
+			bool throwOnOscillation;
+
+			/**	\brief	The loops that did not settle.
+			 */
+			std::vector<Oscillation> oscillations;
+
+			/**	\brief	Statistics: tick()s issued and passes over loops.
+			 */
+			size_t evaluations, iterations;
+
+			/**	\brief	Mark the component on schedule position pos to be tick()ed.
+			 */
+			inline void markDirty(size_t pos) {
+				const size_t block = this->blockOf[pos];
+
+				this->dirty[pos] = 1;
+				if (block < this->firstDirty)	this->firstDirty = block;
+				if (block > this->lastDirty)	this->lastDirty  = block;
+			}
+
+			/**	\brief	Reset the dirty range to empty.
+			 */
+			inline void clearDirtyRange(void) {
+				this->firstDirty = this->loop.size();
+				this->lastDirty  = 0;
+			}
+
+			/**	\brief	tick() every dirty component of block once.
+			 *
+			 *	\return	bool
+			 *		Returns whether any component was tick()ed.
+			 */
+			bool pass(size_t block) {
+				bool ticked = false;
+
+				for (size_t pos = this->blockOffsets[block]; pos < this->blockOffsets[block + 1]; ++pos) {
+					if (!this->dirty[pos]) continue;
+
+					this->dirty[pos] = 0;
+					++this->evaluations;
+					ticked = true;
+					this->schedule[pos]->update();
+				}
+
+				return ticked;
+			}
+
+			/**	\brief	Iterate the loop in block until it settles or the iteration limit is reached.
+			 *
+			 *	\exception	Exceptions::Exception
+			 *		Throws exception if the loop oscillates and setThrowOnOscillation() is enabled.
+			 */
+			void settle(size_t block) {
+				size_t passes = 0;
+
+				while (this->pass(block)) {
+					++this->iterations;
+
+					if (++passes < this->iterationLimit) continue;
+
+					// Still changing after the last allowed pass: give up on this loop.
+					bool settled = true;
+					for (size_t pos = this->blockOffsets[block]; pos < this->blockOffsets[block + 1]; ++pos) {
+						if (this->dirty[pos]) settled = false;
+						this->dirty[pos] = 0;
+					}
+
+					if (settled) return;
+
+					this->oscillations.push_back(Oscillation {
+						std::vector<SynchrotronComponent<bit_width>*>(this->schedule.begin() + this->blockOffsets[block],
+																	  this->schedule.begin() + this->blockOffsets[block + 1]),
+						passes
+					});
+
+					if (this->throwOnOscillation)
+						throw Exceptions::Exception("[ERROR] SynchrotronFixpointNetlist: feedback loop did not settle (oscillation)!");
+					return;
+				}
+			}
+
+			/**	\brief	Evaluate every dirty block in topological order until none are left.
+			 */
+			void drain(void) {
+				this->propagating = true;
+
+				try {
+					while (this->firstDirty <= this->lastDirty && this->firstDirty < this->loop.size()) {
+						const size_t block = this->firstDirty;
+
+						if (this->loop[block])	this->settle(block);
+						else					this->pass(block);
+
+						// Every component of block is clean now; later marks lie in later blocks.
+						if (this->firstDirty <= block) this->firstDirty = block + 1;
+					}
+				} catch (...) {
+					std::fill(this->dirty.begin(), this->dirty.end(), 0);
+					this->clearDirtyRange();
+					this->propagating = false;
+					throw;
+				}
+
+				this->clearDirtyRange();
+				this->propagating = false;
+			}
+
+		public:
+			/**	\brief	Constructor (empty netlist).
+			 *
+			 *	\param	iterationLimit
+			 *		The maximum amount of passes over a loop before it is considered oscillating.
+			 */
+			explicit SynchrotronFixpointNetlist(size_t iterationLimit = 64)
+				: firstDirty(0), lastDirty(0), propagating(false), iterationLimit(iterationLimit ? iterationLimit : 1),
+				  throwOnOscillation(false), evaluations(0), iterations(0) {}
+
+			SynchrotronFixpointNetlist(const SynchrotronFixpointNetlist&) = delete;
+			SynchrotronFixpointNetlist& operator=(const SynchrotronFixpointNetlist&) = delete;
+
+			/**	\brief	Default destructor
+			 *
+			 *			Detaches this netlist from all of its components.
+			 */
+			~SynchrotronFixpointNetlist() {
+				this->release();
+			}
+
+			/**	\brief	Split the graph connected to roots into loops and take over its propagation.
+			 *
+			 *			Any previously compiled graph is released first.
+			 *
+			 *	\param	roots
+			 *		Any components of the graph; everything connected to them is included.
+			 */
+			template <class Iterable>
+			void compile(const Iterable& roots) {
+				this->release();
+
+				this->blockOffsets.assign(1, 0);
+				for (auto& scc : stronglyConnected<bit_width>(roots)) {
+					this->loop.push_back(isLoop<bit_width>(scc));
+
+					for (auto node : scc) {
+						this->index[node] = this->schedule.size();
+						this->schedule.push_back(node);
+						this->blockOf.push_back(this->loop.size() - 1);
+					}
+
+					this->blockOffsets.push_back(this->schedule.size());
+				}
+
+				// Fan-out as schedule positions (CSR).
+				this->fanoutOffsets.assign(1, 0);
+				for (auto node : this->schedule) {
+					for (auto& connection : node->getOutputs())
+						this->fanout.push_back(this->index[connection]);
+					this->fanoutOffsets.push_back(this->fanout.size());
+				}
+
+				this->dirty.assign(this->schedule.size(), 0);
+				this->clearDirtyRange();
+
+				for (auto node : this->schedule)
+					node->setPropagator(this);
+			}
+
+			/**	\brief	Split the graph connected to roots into loops and take over its propagation.
+			 *
+			 *	\param	roots
+			 *		Any components of the graph; everything connected to them is included.
+			 */
+			void compile(std::initializer_list<SynchrotronComponent<bit_width>*> roots) {
+				this->compile<std::initializer_list<SynchrotronComponent<bit_width>*>>(roots);
+			}
+
+			/**	\brief	Detach from all components (they revert to recursive emit()s) and clear the schedule.
+			 */
+			void release(void) {
+				for (auto node : this->schedule)
+					if (node->getPropagator() == this)
+						node->setPropagator(nullptr);
+
+				this->schedule.clear();
+				this->blockOffsets.clear();
+				this->loop.clear();
+				this->blockOf.clear();
+				this->index.clear();
+				this->fanoutOffsets.clear();
+				this->fanout.clear();
+				this->dirty.clear();
+				this->clearDirtyRange();
+			}
+
+			/**	\brief	Called by source.emit(): mark the outputs of source and evaluate them in order.
+			 *
+			 *	\param	source
+			 *		The SynchrotronComponent that changed.
+			 */
+			void propagate(SynchrotronComponent<bit_width>& source) {
+				auto it = this->index.find(&source);
+
+				if (it == this->index.end()) {
+					// Not part of this netlist (anymore): fall back to a direct tick() of the outputs.
+					for (auto& connection : source.getOutputs())
+						connection->update();
+					return;
+				}
+
+				for (size_t f = this->fanoutOffsets[it->second]; f < this->fanoutOffsets[it->second + 1]; ++f)
+					this->markDirty(this->fanout[f]);
+
+				if (!this->propagating)
+					this->drain();
+			}
+
+			/**	\brief	tick() every component with inputs, settling every loop.
+			 */
+			void evaluate(void) {
+				for (size_t pos = 0; pos < this->schedule.size(); ++pos)
+					if (!this->schedule[pos]->getInputs().empty())
+						this->markDirty(pos);
+
+				if (!this->propagating)
+					this->drain();
+			}
+
+			/**	\brief	Returns the amount of components in the netlist.
+			 */
+			inline size_t size(void) const {
+				return this->schedule.size();
+			}
+
+			/**	\brief	Returns the amount of feedback loops in the netlist.
+			 */
+			inline size_t getLoopCount(void) const {
+				return size_t(std::count(this->loop.begin(), this->loop.end(), 1));
+			}
+
+			/**	\brief	Returns the maximum amount of passes over a loop.
+			 */
+			inline size_t getIterationLimit(void) const {
+				return this->iterationLimit;
+			}
+
+			/**	\brief	Set the maximum amount of passes over a loop before it is considered oscillating.
+			 */
+			inline void setIterationLimit(size_t limit) {
+				this->iterationLimit = limit ? limit : 1;
+			}
+
+			/**	\brief	Set whether an oscillating loop throws an Exceptions::Exception (after being recorded).
+			 */
+			inline void setThrowOnOscillation(bool enable) {
+				this->throwOnOscillation = enable;
+			}
+
+			/**	\brief	Returns the loops that did not settle since the last clearOscillations().
+			 */
+			inline const std::vector<Oscillation>& getOscillations(void) const {
+				return this->oscillations;
+			}
+
+			/**	\brief	Forget the recorded oscillations.
+			 */
+			inline void clearOscillations(void) {
+				this->oscillations.clear();
+			}
+
+			/**	\brief	Returns the total amount of tick()s issued by this netlist.
+			 */
+			inline size_t getEvaluationCount(void) const {
+				return this->evaluations;
+			}
+
+			/**	\brief	Returns the total amount of passes over loops.
+			 */
+			inline size_t getIterationCount(void) const {
+				return this->iterations;
+			}
+	};
+}
+
+#endif // SYNCHROTRONFIXPOINT_HPP
@@ -0,0 +1,243 @@
+/**
+*	Arena owning a whole SynchrotronComponent graph.
+*/
+#ifndef SYNCHROTRONGRAPH_HPP
+#define SYNCHROTRONGRAPH_HPP
+
+#include <cstddef>
+#include <vector>
+#include <memory>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
+#include <functional>
+#include <initializer_list>
+
+#include "SynchrotronComponent.hpp"
+
+namespace Synchrotron {
+
+	/** \brief	**SynchrotronGraph** : Allocates SynchrotronComponents from contiguous blocks and destroys them all at once.
+	 *
+	 *	Components are constructed in place in large blocks (no allocation per component) and
+	 *	live until clear() or the destruction of the graph. Connections between two components
+	 *	of the same graph are then dropped without unlinking them from the other side,
+	 *	so tearing down a graph costs one destructor call per component instead of
+	 *	a locked set erase per edge end. Connections to components outside the graph
+	 *	(and to the members of composite components such as an ALUnit) are properly disconnected. Creating components in one graph from several threads is not thread safe.
+	 *
+	 *	\tparam	bit_width
+	 *		This template argument specifies the width of the components in the graph.
+	 *	\tparam	lock_policy
+	 *		The lock_policy of the components in the graph.
+	 */
+	template <size_t bit_width, class lock_policy = SYNCHROTRON_LOCK_POLICY>
+	class SynchrotronGraph {
+		public:
+			typedef SynchrotronComponent<bit_width, lock_policy> Component;
+
+		private:
+			/**	\brief	One contiguous block of component storage.
+			 */
+			struct Block {
+				char	*memory;	///< The start of the block.
+				size_t	size;		///< The size of the block in bytes.
+				size_t	used;		///< The bytes in use from the start.
+			};
+
+			/**	\brief	A component and the destructor of its most derived type.
+			 */
+			struct Entry {
+				Component	*component;
+				void		(*destroy)(void*);
+			};
+
+			/**	\brief	The storage blocks, in allocation order.
+			 */
+			std::vector<Block> blocks;
+
+			/**	\brief	Every component, in creation order.
+			 */
+			std::vector<Entry> entries;
+
+			/**	\brief	The size of a new block in bytes.
+			 */
+			size_t blockSize;
+
+			/**	\brief	Returns size bytes aligned to alignment from the current block (a new one if it is full).
+			 */
+			void* allocate(size_t size, size_t alignment) {
+				if (!this->blocks.empty()) {
+					Block &block = this->blocks.back();
+					const size_t start = (block.used + alignment - 1) / alignment * alignment;
+
+					if (start + size <= block.size) {
+						block.used = start + size;
+						return block.memory + start;
+					}
+				}
+
+				// operator new memory is aligned for every fundamental type.
+				const size_t bytes = std::max(this->blockSize, size);
+				this->blocks.push_back({ static_cast<char*>(::operator new(bytes)), bytes, size });
+				return this->blocks.back().memory;
+			}
+
+			/**	\brief	The [begin, end) addresses of a block.
+			 */
+			typedef std::pair<const char*, const char*> Range;
+
+			/**	\brief	Whether component was created in one of the ranges (sorted by begin).
+			 *
+			 *		Member components of a composite (e.g. the instructions of an ALUnit) live in a block as well,
+			 *		but their owner destroys them with normal unlinking, so they count as outside the graph.
+			 */
+			static bool owns(const std::vector<Range>& ranges, const Component *component) {
+				if (!component->arenaCreated) return false;
+
+				const char *p = reinterpret_cast<const char*>(component);
+				auto it = std::upper_bound(ranges.begin(), ranges.end(), p, [](const char *value, const Range& range) {
+					return std::less<const char*>()(value, range.first);
+				});
+
+				return it != ranges.begin() && std::less<const char*>()(p, (--it)->second);
+			}
+
+			/**	\brief	Destroys the given object as T.
+			 */
+			template <class T>
+			static void destroyAs(void *object) {
+				static_cast<T*>(object)->~T();
+			}
+
+		public:
+			/**	\brief	Default constructor
+			 *
+			 *	\param	blockSize
+			 *		The size of each storage block in bytes.
+			 */
+			explicit SynchrotronGraph(size_t blockSize = 1u << 16) : blockSize(blockSize) {}
+
+			/**	\brief	Destroys every component (see clear()).
+			 */
+			~SynchrotronGraph() {
+				this->clear();
+			}
+
+			SynchrotronGraph(const SynchrotronGraph&) = delete;
+			SynchrotronGraph& operator=(const SynchrotronGraph&) = delete;
+
+			/**	\brief	Construct a new component of type T in this graph.
+			 *
+			 *	\tparam	T
+			 *		A SynchrotronComponent<bit_width, lock_policy> or derived class.
+			 *	\param	args
+			 *		The arguments for the constructor of T.
+			 *
+			 *	\return	T*
+			 *		Returns the new component, owned by this graph (never delete it).
+			 */
+			template <class T, class... Args>
+			T* create(Args&&... args) {
+				static_assert(std::is_base_of<Component, T>::value, "SynchrotronGraph can only hold SynchrotronComponents of its bit_width.");
+
+				void *memory = this->allocate(sizeof(T), alignof(T));
+				T *component = new (memory) T(std::forward<Args>(args)...);
+				static_cast<Component*>(component)->arenaCreated = true;
+
+				this->entries.push_back({ component, &SynchrotronGraph::destroyAs<T> });
+				return component;
+			}
+
+			/**	\brief	Construct a new component of type T in this graph, connected to inputList.
+			 *
+			 *	\return	T*
+			 *		Returns the new component, owned by this graph (never delete it).
+			 */
+			template <class T>
+			T* create(std::initializer_list<Component*> inputList) {
+				T *component = this->create<T>();
+				component->addInput(inputList);
+				return component;
+			}
+
+			/**	\brief	Destroy every component and release all blocks.
+			 *
+			 *		Connections to components outside this graph, including the members of composite components
+			 *		in it, are disconnected first; connections between created components are dropped
+			 *		without touching the other side.
+			 */
+			void clear(void) {
+				std::vector<Range> ranges;
+				std::vector<std::pair<Component*, Component*>> outsideInputs, outsideOutputs;
+
+				for (auto& block : this->blocks)
+					ranges.push_back(Range(block.memory, block.memory + block.used));
+				std::sort(ranges.begin(), ranges.end(), [](const Range& a, const Range& b) {
+					return std::less<const char*>()(a.first, b.first);
+				});
+
+				// Only the edges leaving the graph are unlinked (in practice none or few).
+				for (auto& entry : this->entries) {
+					for (auto connection : entry.component->getInputs())
+						if (!owns(ranges, connection)) outsideInputs.push_back(std::make_pair(entry.component, connection));
+					for (auto connection : entry.component->getOutputs())
+						if (!owns(ranges, connection)) outsideOutputs.push_back(std::make_pair(entry.component, connection));
+				}
+
+				for (auto& edge : outsideInputs)
+					edge.first->removeInput(*edge.second);
+				for (auto& edge : outsideOutputs)
+					edge.first->removeOutput(*edge.second);
+
+				for (auto& entry : this->entries)
+					entry.component->forgetConnections();
+
+				for (auto it = this->entries.rbegin(); it != this->entries.rend(); ++it)
+					it->destroy(it->component);
+
+				for (auto& block : this->blocks)
+					::operator delete(block.memory);
+
+				this->entries.clear();
+				this->blocks.clear();
+			}
+
+			/**	\brief	Returns the amount of components in this graph.
+			 */
+			inline size_t size(void) const {
+				return this->entries.size();
+			}
+
+			/**	\brief	Returns component i (in creation order).
+			 */
+			inline Component& operator[](size_t i) const {
+				return *this->entries[i].component;
+			}
+
+			/**	\brief	Returns every component, in creation order.
+			 */
+			std::vector<Component*> getComponents(void) const {
+				std::vector<Component*> components;
+
+				components.reserve(this->entries.size());
+				for (auto& entry : this->entries)
+					components.push_back(entry.component);
+
+				return components;
+			}
+
+			/**	\brief	Returns the amount of bytes reserved for components.
+			 */
+			size_t getReservedBytes(void) const {
+				size_t bytes = 0;
+
+				for (auto& block : this->blocks)
+					bytes += block.size;
+
+				return bytes;
+			}
+	};
+}
+
+#endif // SYNCHROTRONGRAPH_HPP
@@ -0,0 +1,357 @@
+/**
+*	Levelized evaluation of a finished SynchrotronComponent graph.
+*/
+#ifndef SYNCHROTRONNETLIST_HPP
+#define SYNCHROTRONNETLIST_HPP
+
+#include <vector>
+#include <algorithm>
+#include <unordered_map>
+#include <initializer_list>
+
+#include "SynchrotronComponent.hpp"
+#include "Exceptions.hpp"
+
+namespace Synchrotron {
+
+	/**	\brief	Sort every SynchrotronComponent connected to roots topologically into levels.
+	 *
+	 *			Sources (no inputs) are level 0, every other component is one level above its deepest input.
+	 *
+	 *	\tparam	bit_width
+	 *		The width of the components in the graph.
+	 *	\param	roots
+	 *		Any iterable of SynchrotronComponent<bit_width>*; everything connected to them is included.
+	 *	\param	levelOffsets
+	 *		Receives the offset of the first component of each level in the result (levels + 1 entries).
+	 *
+	 *	\return	std::vector<SynchrotronComponent<bit_width>*>
+	 *		Returns every component sorted by level, in topological order within a level.
+	 *	\exception	Exceptions::Exception
+	 *		Throws exception if the graph contains a combinational loop (it cannot be levelized).
+	 */
+	template <size_t bit_width, class Iterable>
+	std::vector<SynchrotronComponent<bit_width>*> levelize(const Iterable& roots, std::vector<size_t>& levelOffsets) {
+		std::vector<SynchrotronComponent<bit_width>*> nodes = collectGraph<bit_width>(roots);
+		std::unordered_map<const SynchrotronComponent<bit_width>*, size_t> id;
+		std::vector<size_t> inDegree(nodes.size()), level(nodes.size(), 0), ready;
+		size_t levels = nodes.empty() ? 0 : 1;
+
+		for (size_t i = 0; i < nodes.size(); ++i) {
+			id[nodes[i]] = i;
+			inDegree[i]  = nodes[i]->getInputs().size();
+			if (!inDegree[i]) ready.push_back(i);
+		}
+
+		// Kahn's algorithm: a component is ready when all of its inputs are placed.
+		for (size_t r = 0; r < ready.size(); ++r) {
+			const size_t i = ready[r];
+
+			for (auto& connection : nodes[i]->getOutputs()) {
+				const size_t o = id[connection];
+
+				if (level[o] < level[i] + 1) {
+					level[o] = level[i] + 1;
+					if (level[o] + 1 > levels) levels = level[o] + 1;
+				}
+
+				if (!--inDegree[o]) ready.push_back(o);
+			}
+		}
+
+		if (ready.size() != nodes.size())
+			throw Exceptions::Exception("[ERROR] Cannot levelize a graph with combinational loops!");
+
+		// Counting sort on level, keeping the topological order within a level.
+		levelOffsets.assign(levels + 1, 0);
+		for (size_t i = 0; i < nodes.size(); ++i)
+			++levelOffsets[level[i] + 1];
+		for (size_t l = 0; l < levels; ++l)
+			levelOffsets[l + 1] += levelOffsets[l];
+
+		std::vector<size_t> fill(levelOffsets.begin(), levelOffsets.end());
+		std::vector<SynchrotronComponent<bit_width>*> sorted(nodes.size());
+
+		for (size_t r = 0; r < ready.size(); ++r)
+			sorted[fill[level[ready[r]]]++] = nodes[ready[r]];
+
+		return sorted;
+	}
+
+	/** \brief	**SynchrotronNetlist** : Compiled, levelized schedule of a SynchrotronComponent graph.
+	 *
+	 *	compile() collects every SynchrotronComponent reachable from the given roots,
+	 *	sorts them topologically into levels (sources are level 0, every other component
+	 *	is one level above its deepest input) and stores them in one flat schedule array.
+	 *
+	 *	Every component in the netlist gets this netlist attached as its Propagator,
+	 *	so an emit() no longer recurses through tick() but marks the fan-out as dirty.
+	 *	The dirty components are then tick()ed in schedule order, which guarantees that
+	 *	each component is evaluated at most once per input change and only after all of its inputs settled.
+	 *
+	 *	The netlist does not own its components and must be released (or destroyed) before them.
+	 *
+	 *	\tparam	bit_width
+	 *		This template argument specifies the width of the components in the graph.
+	 */
+	template <size_t bit_width>
+	class SynchrotronNetlist : public Propagator<bit_width> {
+		private:
+			/**	\brief	All components sorted by level (the flat schedule).
+			 */
+			std::vector<SynchrotronComponent<bit_width>*> schedule;
+
+			/**	\brief	Offset of the first component of each level in schedule (levels + 1 entries).
+			 */
+			std::vector<size_t> levelOffsets;
+
+			/**	\brief	Position of each component in schedule.
+			 */
+			std::unordered_map<const SynchrotronComponent<bit_width>*, size_t> index;
+
+			/**	\brief	Offset of the fan-out of each schedule position in fanout (CSR, schedule.size() + 1 entries).
+			 */
+			std::vector<size_t> fanoutOffsets;
+
+			/**	\brief	Schedule positions of the outputs of each component (CSR).
+			 */
+			std::vector<size_t> fanout;
+
+			/**	\brief	Whether the component on each schedule position awaits a tick().
+			 */
+			std::vector<char> dirty;
+
+			/**	\brief	The range of schedule positions that may contain dirty components.
+			 */
+			size_t firstDirty, lastDirty;
+
+			/**	\brief	Whether the schedule is currently being evaluated (propagate() only marks components).
+			 */
+			bool propagating;
+
+			/**	\brief	The total amount of tick()s issued by this netlist.
+			 */
+			size_t evaluations;
+
+			/**	\brief	Mark the component on schedule position pos to be tick()ed.
+			 */
+			inline void markDirty(size_t pos) {
+				this->dirty[pos] = 1;
+				if (pos < this->firstDirty)	this->firstDirty = pos;
+				if (pos > this->lastDirty)	this->lastDirty  = pos;
+			}
+
+			/**	\brief	Reset the dirty range to empty.
+			 */
+			inline void clearDirtyRange(void) {
+				this->firstDirty = this->schedule.size();
+				this->lastDirty  = 0;
+			}
+
+			/**	\brief	tick() every dirty component in schedule order until none are left.
+			 *
+			 *			Components marked during a tick() always lie further in the schedule,
+			 *			unless they are changed from outside the graph; the scan then restarts from there.
+			 */
+			void drain(void) {
+				this->propagating = true;
+
+				try {
+					while (this->firstDirty <= this->lastDirty && this->firstDirty < this->schedule.size()) {
+						const size_t pos = this->firstDirty++;
+
+						if (!this->dirty[pos]) continue;
+
+						this->dirty[pos] = 0;
+						++this->evaluations;
+						this->schedule[pos]->update();
+					}
+				} catch (...) {
+					std::fill(this->dirty.begin(), this->dirty.end(), 0);
+					this->clearDirtyRange();
+					this->propagating = false;
+					throw;
+				}
+
+				this->clearDirtyRange();
+				this->propagating = false;
+			}
+
+		public:
+			/**	\brief	Default constructor (empty netlist).
+			 */
+			SynchrotronNetlist()
+				: firstDirty(0), lastDirty(0), propagating(false), evaluations(0) {}
+
+			/**	\brief	Compile constructor
+			 *
+			 *	\param	roots
+			 *		Any components of the graph; everything connected to them is included.
+			 */
+			SynchrotronNetlist(std::initializer_list<SynchrotronComponent<bit_width>*> roots)
+				: SynchrotronNetlist() {
+				this->compile(roots);
+			}
+
+			SynchrotronNetlist(const SynchrotronNetlist&) = delete;
+			SynchrotronNetlist& operator=(const SynchrotronNetlist&) = delete;
+
+			/**	\brief	Default destructor
+			 *
+			 *			Detaches this netlist from all of its components.
+			 */
+			~SynchrotronNetlist() {
+				this->release();
+			}
+
+			/**	\brief	Levelize the graph connected to roots and take over its propagation.
+			 *
+			 *			Any previously compiled graph is released first.
+			 *
+			 *	\param	roots
+			 *		Any components of the graph; everything connected to them is included.
+			 *	\exception	Exceptions::Exception
+			 *		Throws exception if the graph contains a combinational loop (it cannot be levelized).
+			 */
+			template <class Iterable>
+			void compile(const Iterable& roots) {
+				this->release();
+
+				this->schedule = levelize<bit_width>(roots, this->levelOffsets);
+
+				for (size_t pos = 0; pos < this->schedule.size(); ++pos)
+					this->index[this->schedule[pos]] = pos;
+
+				// Fan-out as schedule positions (CSR).
+				this->fanoutOffsets.assign(1, 0);
+				for (auto node : this->schedule) {
+					for (auto& connection : node->getOutputs())
+						this->fanout.push_back(this->index[connection]);
+					this->fanoutOffsets.push_back(this->fanout.size());
+				}
+
+				this->dirty.assign(this->schedule.size(), 0);
+				this->clearDirtyRange();
+
+				for (auto node : this->schedule)
+					node->setPropagator(this);
+			}
+
+			/**	\brief	Levelize the graph connected to roots and take over its propagation.
+			 *
+			 *	\param	roots
+			 *		Any components of the graph; everything connected to them is included.
+			 */
+			void compile(std::initializer_list<SynchrotronComponent<bit_width>*> roots) {
+				this->compile<std::initializer_list<SynchrotronComponent<bit_width>*>>(roots);
+			}
+
+			/**	\brief	Detach from all components (they revert to recursive emit()s) and clear the schedule.
+			 */
+			void release(void) {
+				for (auto node : this->schedule)
+					if (node->getPropagator() == this)
+						node->setPropagator(nullptr);
+
+				this->schedule.clear();
+				this->levelOffsets.clear();
+				this->index.clear();
+				this->fanoutOffsets.clear();
+				this->fanout.clear();
+				this->dirty.clear();
+				this->clearDirtyRange();
+			}
+
+			/**	\brief	Called by source.emit(): mark the outputs of source and evaluate them in schedule order.
+			 *
+			 *	\param	source
+			 *		The SynchrotronComponent that changed.
+			 */
+			void propagate(SynchrotronComponent<bit_width>& source) {
+				auto it = this->index.find(&source);
+
+				if (it == this->index.end()) {
+					// Not part of this netlist (anymore): fall back to a direct tick() of the outputs.
+					for (auto& connection : source.getOutputs())
+						connection->update();
+					return;
+				}
+
+				for (size_t f = this->fanoutOffsets[it->second]; f < this->fanoutOffsets[it->second + 1]; ++f)
+					this->markDirty(this->fanout[f]);
+
+				if (!this->propagating)
+					this->drain();
+			}
+
+			/**	\brief	tick() every non-source component exactly once, in schedule order.
+			 */
+			void evaluate(void) {
+				for (size_t pos = this->getLevelBegin(1); pos < this->schedule.size(); ++pos)
+					this->markDirty(pos);
+
+				if (!this->propagating)
+					this->drain();
+			}
+
+			/**	\brief	Returns the amount of components in the netlist.
+			 */
+			inline size_t size(void) const {
+				return this->schedule.size();
+			}
+
+			/**	\brief	Returns the amount of levels in the netlist (longest path + 1).
+			 */
+			inline size_t getLevelCount(void) const {
+				return this->levelOffsets.empty() ? 0 : this->levelOffsets.size() - 1;
+			}
+
+			/**	\brief	Returns the schedule position of the first component on the given level.
+			 */
+			inline size_t getLevelBegin(size_t level) const {
+				return level < this->levelOffsets.size() ? this->levelOffsets[level] : this->schedule.size();
+			}
+
+			/**	\brief	Returns the schedule position one past the last component on the given level.
+			 */
+			inline size_t getLevelEnd(size_t level) const {
+				return this->getLevelBegin(level + 1);
+			}
+
+			/**	\brief	Returns the flat schedule, sorted by level.
+			 */
+			inline const std::vector<SynchrotronComponent<bit_width>*>& getSchedule(void) const {
+				return this->schedule;
+			}
+
+			/**	\brief	Returns the level of the given component.
+			 *
+			 *	\exception	Exceptions::Exception
+			 *		Throws exception if the component is not part of this netlist.
+			 */
+			size_t getLevel(const SynchrotronComponent<bit_width>& component) const {
+				auto it = this->index.find(&component);
+
+				if (it == this->index.end())
+					throw Exceptions::Exception("[ERROR] Component is not part of this SynchrotronNetlist!");
+
+				size_t level = 0;
+				while (this->levelOffsets[level + 1] <= it->second) ++level;
+				return level;
+			}
+
+			/**	\brief	Returns the total amount of tick()s issued by this netlist.
+			 */
+			inline size_t getEvaluationCount(void) const {
+				return this->evaluations;
+			}
+
+			/**	\brief	Reset the tick() counter.
+			 */
+			inline void resetEvaluationCount(void) {
+				this->evaluations = 0;
+			}
+	};
+}
+
+#endif // SYNCHROTRONNETLIST_HPP
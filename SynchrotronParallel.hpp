@@ -0,0 +1,564 @@
+/**
+*	Multi-threaded, level-parallel evaluation of a finished SynchrotronComponent graph.
+*/
+#ifndef SYNCHROTRONPARALLEL_HPP
+#define SYNCHROTRONPARALLEL_HPP
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <exception>
+#include <algorithm>
+#include <unordered_map>
+#include <initializer_list>
+
+#include "SynchrotronComponent.hpp"
+#include "SynchrotronNetlist.hpp"
+#include "Exceptions.hpp"
+
+namespace Synchrotron {
+
+	/** \brief	**WorkStealingPool** : Fixed set of worker threads executing index ranges with work stealing.
+	 *
+	 *	run() splits a range in chunks, deals them round-robin over the queues of the workers
+	 *	(the calling thread is worker 0) and blocks until every chunk is done, which makes every
+	 *	run() a barrier. A worker takes chunks from the back of its own queue and, once that is empty,
+	 *	steals from the front of the other queues, so uneven chunks still keep every thread busy.
+	 */
+	class WorkStealingPool {
+		private:
+			/**	\brief	A half-open range of indices to process.
+			 */
+			struct Chunk {
+				size_t begin, end;
+			};
+
+			/**	\brief	The chunk queue of one worker.
+			 */
+			struct Queue {
+				std::mutex			lock;
+				std::deque<Chunk>	chunks;
+			};
+
+			/**	\brief	The worker threads (the caller of run() is worker 0 and is not in here).
+			 */
+			std::vector<std::thread> threads;
+
+			/**	\brief	One queue per worker, including the caller of run().
+			 */
+			std::vector<std::unique_ptr<Queue>> queues;
+
+			/**	\brief	The job of the current run().
+			 */
+			std::function<void(size_t, size_t)> job;
+
+			/**	\brief	Guards generation, stopping and error; wake and done wait on it.
+			 */
+			std::mutex control;
+			std::condition_variable wake, done;
+
+			/**	\brief	Incremented by every run() to wake the workers.
+			 */
+			size_t generation;
+
+			/**	\brief	Whether the workers should exit.
+			 */
+			bool stopping;
+
+			/**	\brief	The amount of chunks of the current run() that are not finished yet.
+			 */
+			std::atomic<size_t> remaining;
+
+			/**	\brief	The amount of chunks taken from another worker's queue.
+			 */
+			std::atomic<size_t> steals;
+
+			/**	\brief	The first exception thrown by the job in the current run().
+			 */
+			std::exception_ptr error;
+
+			/**	\brief	Take a chunk from the back of the own queue, or steal one from the front of another.
+			 */
+			bool take(size_t worker, Chunk& chunk) {
+				{
+					Queue &own = *this->queues[worker];
+					std::lock_guard<std::mutex> lock(own.lock);
+
+					if (!own.chunks.empty()) {
+						chunk = own.chunks.back();
+						own.chunks.pop_back();
+						return true;
+					}
+				}
+
+				for (size_t i = 1; i < this->queues.size(); ++i) {
+					Queue &victim = *this->queues[(worker + i) % this->queues.size()];
+					std::lock_guard<std::mutex> lock(victim.lock);
+
+					if (!victim.chunks.empty()) {
+						chunk = victim.chunks.front();
+						victim.chunks.pop_front();
+						++this->steals;
+						return true;
+					}
+				}
+
+				return false;
+			}
+
+			/**	\brief	Execute chunks until every queue is empty.
+			 */
+			void work(size_t worker) {
+				Chunk chunk;
+
+				while (this->take(worker, chunk)) {
+					try {
+						this->job(chunk.begin, chunk.end);
+					} catch (...) {
+						std::lock_guard<std::mutex> lock(this->control);
+						if (!this->error) this->error = std::current_exception();
+					}
+
+					if (--this->remaining == 0) {
+						std::lock_guard<std::mutex> lock(this->control);
+						this->done.notify_all();
+					}
+				}
+			}
+
+			/**	\brief	The loop of a worker thread: wait for a new generation and help out.
+			 */
+			void loop(size_t worker) {
+				size_t seen = 0;
+
+				for (;;) {
+					{
+						std::unique_lock<std::mutex> lock(this->control);
+						this->wake.wait(lock, [&]() { return this->stopping || this->generation != seen; });
+
+						if (this->stopping) return;
+						seen = this->generation;
+					}
+
+					this->work(worker);
+				}
+			}
+
+		public:
+			/**	\brief	Constructor
+			 *
+			 *	\param	workers
+			 *		The amount of threads to start besides the caller of run() (0 runs everything on the caller).
+			 */
+			explicit WorkStealingPool(size_t workers = std::max(1u, std::thread::hardware_concurrency()) - 1)
+				: generation(0), stopping(false), remaining(0), steals(0)
+			{
+				for (size_t i = 0; i <= workers; ++i)
+					this->queues.emplace_back(new Queue());
+
+				for (size_t i = 1; i <= workers; ++i)
+					this->threads.emplace_back(&WorkStealingPool::loop, this, i);
+			}
+
+			WorkStealingPool(const WorkStealingPool&) = delete;
+			WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+			/**	\brief	Default destructor
+			 *
+			 *			Stops and joins all worker threads.
+			 */
+			~WorkStealingPool() {
+				{
+					std::lock_guard<std::mutex> lock(this->control);
+					this->stopping = true;
+				}
+				this->wake.notify_all();
+
+				for (auto& thread : this->threads)
+					thread.join();
+			}
+
+			/**	\brief	Call job(b, e) for chunks [b, e) covering [begin, end) on all workers and wait for them.
+			 *
+			 *	\param	begin
+			 *		The first index.
+			 *	\param	end
+			 *		One past the last index.
+			 *	\param	grain
+			 *		The maximum amount of indices per chunk.
+			 *	\param	job
+			 *		The function to call for every chunk; it is called concurrently.
+			 *	\exception
+			 *		Rethrows the first exception thrown by job, after all chunks finished.
+			 */
+			void run(size_t begin, size_t end, size_t grain, const std::function<void(size_t, size_t)>& job) {
+				if (begin >= end) return;
+				if (!grain) grain = 1;
+
+				this->job = job;
+				this->remaining = (end - begin + grain - 1) / grain;
+
+				size_t worker = 0;
+				for (size_t b = begin; b < end; b += grain) {
+					Queue &queue = *this->queues[worker];
+					std::lock_guard<std::mutex> lock(queue.lock);
+
+					queue.chunks.push_back(Chunk{ b, std::min(b + grain, end) });
+					worker = (worker + 1) % this->queues.size();
+				}
+
+				{
+					std::lock_guard<std::mutex> lock(this->control);
+					++this->generation;
+				}
+				this->wake.notify_all();
+
+				this->work(0);
+
+				std::exception_ptr failure;
+				{
+					std::unique_lock<std::mutex> lock(this->control);
+					this->done.wait(lock, [&]() { return this->remaining == 0; });
+					failure.swap(this->error);
+				}
+
+				if (failure)
+					std::rethrow_exception(failure);
+			}
+
+			/**	\brief	Returns the amount of workers, including the caller of run().
+			 */
+			inline size_t getWorkerCount(void) const {
+				return this->queues.size();
+			}
+
+			/**	\brief	Returns the amount of chunks that were stolen from another worker's queue.
+			 */
+			inline size_t getStealCount(void) const {
+				return this->steals;
+			}
+	};
+
+	/** \brief	**SynchrotronParallelNetlist** : Levelized evaluation with every level split over a WorkStealingPool.
+	 *
+	 *	Like SynchrotronNetlist, compile() levelizes the graph and attaches this as Propagator of every component,
+	 *	so emit() marks the fan-out dirty instead of recursing. The dirty components are then tick()ed level by level:
+	 *	components on one level only read the states of lower levels, so a level is split over the pool
+	 *	with a barrier before the next level starts. Levels with less dirty components than the threshold
+	 *	are evaluated on the calling thread, where the pool would cost more than it gains.
+	 *
+	 *	tick() of components in the same level run concurrently, so they must only change their own state
+	 *	(which holds for every CPUComponent). The graph must not be changed during evaluation.
+	 *	The netlist does not own its components and must be released (or destroyed) before them.
+	 *
+	 *	\tparam	bit_width
+	 *		This template argument specifies the width of the components in the graph.
+	 */
+	template <size_t bit_width>
+	class SynchrotronParallelNetlist : public Propagator<bit_width> {
+		private:
+			/**	\brief	All components sorted by level (the flat schedule).
+			 */
+			std::vector<SynchrotronComponent<bit_width>*> schedule;
+
+			/**	\brief	Offset of the first component of each level in schedule (levels + 1 entries).
+			 */
+			std::vector<size_t> levelOffsets;
+
+			/**	\brief	The level of each schedule position.
+			 */
+			std::vector<size_t> levelOf;
+
+			/**	\brief	Position of each component in schedule.
+			 */
+			std::unordered_map<const SynchrotronComponent<bit_width>*, size_t> index;
+
+			/**	\brief	Offset of the fan-out of each schedule position in fanout (CSR, schedule.size() + 1 entries).
+			 */
+			std::vector<size_t> fanoutOffsets;
+
+			/**	\brief	Schedule positions of the outputs of each component (CSR).
+			 */
+			std::vector<size_t> fanout;
+
+			/**	\brief	Whether the component on each schedule position awaits a tick() (set from any worker).
+			 */
+			std::unique_ptr<std::atomic<char>[]> dirty;
+
+			/**	\brief	The amount of dirty components on each level.
+			 */
+			std::unique_ptr<std::atomic<size_t>[]> pending;
+
+			/**	\brief	The pool the levels are split over.
+			 */
+			WorkStealingPool pool;
+
+			/**	\brief	Levels with less dirty components than this are evaluated on the calling thread.
+			 */
+			size_t threshold;
+
+			/**	\brief	Whether the schedule is currently being evaluated (propagate() only marks components).
+			 */
+			bool propagating;
+
+			/**	\brief	Statistics: tick()s issued, levels evaluated on the pool and on the calling thread.
+			 */
+			std::atomic<size_t> evaluations;
+			size_t parallelLevels, serialLevels;
+
+			/**	\brief	Mark the component on schedule position pos to be tick()ed.
+			 */
+			inline void markDirty(size_t pos) {
+				if (!this->dirty[pos].exchange(1, std::memory_order_relaxed))
+					this->pending[this->levelOf[pos]].fetch_add(1, std::memory_order_relaxed);
+			}
+
+			/**	\brief	tick() every dirty component in schedule positions [begin, end).
+			 */
+			void evaluateRange(size_t begin, size_t end) {
+				size_t ticks = 0;
+
+				for (size_t pos = begin; pos < end; ++pos) {
+					if (!this->dirty[pos].exchange(0, std::memory_order_relaxed)) continue;
+
+					++ticks;
+					this->schedule[pos]->update();
+				}
+
+				this->evaluations.fetch_add(ticks, std::memory_order_relaxed);
+			}
+
+			/**	\brief	Evaluate the levels from level on, each level split over the pool if big enough.
+			 */
+			void drain(size_t level) {
+				const size_t workers = this->pool.getWorkerCount();
+				this->propagating = true;
+
+				try {
+					for (; level < this->getLevelCount(); ++level) {
+						const size_t count = this->pending[level].exchange(0, std::memory_order_relaxed);
+						const size_t begin = this->levelOffsets[level], end = this->levelOffsets[level + 1];
+
+						if (!count) continue;
+
+						if (workers < 2 || count < this->threshold) {
+							++this->serialLevels;
+							this->evaluateRange(begin, end);
+						} else {
+							++this->parallelLevels;
+							this->pool.run(begin, end, std::max<size_t>(64, (end - begin) / (4 * workers)),
+										   [this](size_t b, size_t e) { this->evaluateRange(b, e); });
+						}
+					}
+				} catch (...) {
+					for (size_t pos = 0; pos < this->schedule.size(); ++pos)
+						this->dirty[pos] = 0;
+					for (size_t l = 0; l < this->getLevelCount(); ++l)
+						this->pending[l] = 0;
+					this->propagating = false;
+					throw;
+				}
+
+				this->propagating = false;
+			}
+
+		public:
+			/**	\brief	Constructor (empty netlist).
+			 *
+			 *	\param	threshold
+			 *		Levels with less dirty components than this are evaluated on the calling thread.
+			 *	\param	workers
+			 *		The amount of threads to start besides the calling thread.
+			 */
+			explicit SynchrotronParallelNetlist(size_t threshold = 1024,
+												size_t workers = std::max(1u, std::thread::hardware_concurrency()) - 1)
+				: pool(workers), threshold(threshold), propagating(false), evaluations(0), parallelLevels(0), serialLevels(0) {}
+
+			SynchrotronParallelNetlist(const SynchrotronParallelNetlist&) = delete;
+			SynchrotronParallelNetlist& operator=(const SynchrotronParallelNetlist&) = delete;
+
+			/**	\brief	Default destructor
+			 *
+			 *			Detaches this netlist from all of its components.
+			 */
+			~SynchrotronParallelNetlist() {
+				this->release();
+			}
+
+			/**	\brief	Levelize the graph connected to roots and take over its propagation.
+			 *
+			 *			Any previously compiled graph is released first.
+			 *
+			 *	\param	roots
+			 *		Any components of the graph; everything connected to them is included.
+			 *	\exception	Exceptions::Exception
+			 *		Throws exception if the graph contains a combinational loop (it cannot be levelized).
+			 */
+			template <class Iterable>
+			void compile(const Iterable& roots) {
+				this->release();
+
+				this->schedule = levelize<bit_width>(roots, this->levelOffsets);
+				this->levelOf.resize(this->schedule.size());
+
+				for (size_t level = 0; level < this->getLevelCount(); ++level)
+					for (size_t pos = this->levelOffsets[level]; pos < this->levelOffsets[level + 1]; ++pos)
+						this->levelOf[pos] = level;
+
+				for (size_t pos = 0; pos < this->schedule.size(); ++pos)
+					this->index[this->schedule[pos]] = pos;
+
+				// Fan-out as schedule positions (CSR).
+				this->fanoutOffsets.assign(1, 0);
+				for (auto node : this->schedule) {
+					for (auto& connection : node->getOutputs())
+						this->fanout.push_back(this->index[connection]);
+					this->fanoutOffsets.push_back(this->fanout.size());
+				}
+
+				this->dirty.reset(new std::atomic<char>[this->schedule.size()]);
+				this->pending.reset(new std::atomic<size_t>[this->getLevelCount()]);
+				for (size_t pos = 0; pos < this->schedule.size(); ++pos)
+					this->dirty[pos] = 0;
+				for (size_t level = 0; level < this->getLevelCount(); ++level)
+					this->pending[level] = 0;
+
+				for (auto node : this->schedule)
+					node->setPropagator(this);
+			}
+
+			/**	\brief	Levelize the graph connected to roots and take over its propagation.
+			 *
+			 *	\param	roots
+			 *		Any components of the graph; everything connected to them is included.
+			 */
+			void compile(std::initializer_list<SynchrotronComponent<bit_width>*> roots) {
+				this->compile<std::initializer_list<SynchrotronComponent<bit_width>*>>(roots);
+			}
+
+			/**	\brief	Detach from all components (they revert to recursive emit()s) and clear the schedule.
+			 */
+			void release(void) {
+				for (auto node : this->schedule)
+					if (node->getPropagator() == this)
+						node->setPropagator(nullptr);
+
+				this->schedule.clear();
+				this->levelOffsets.clear();
+				this->levelOf.clear();
+				this->index.clear();
+				this->fanoutOffsets.clear();
+				this->fanout.clear();
+				this->dirty.reset();
+				this->pending.reset();
+			}
+
+			/**	\brief	Called by source.emit(): mark the outputs of source and evaluate them level by level.
+			 *
+			 *			May be called concurrently by the components of one level.
+			 *
+			 *	\param	source
+			 *		The SynchrotronComponent that changed.
+			 */
+			void propagate(SynchrotronComponent<bit_width>& source) {
+				auto it = this->index.find(&source);
+
+				if (it == this->index.end()) {
+					// Not part of this netlist (anymore): fall back to a direct tick() of the outputs.
+					for (auto& connection : source.getOutputs())
+						connection->update();
+					return;
+				}
+
+				for (size_t f = this->fanoutOffsets[it->second]; f < this->fanoutOffsets[it->second + 1]; ++f)
+					this->markDirty(this->fanout[f]);
+
+				if (!this->propagating)
+					this->drain(this->levelOf[it->second] + 1);
+			}
+
+			/**	\brief	tick() every non-source component exactly once, level by level.
+			 */
+			void evaluate(void) {
+				for (size_t pos = this->getLevelBegin(1); pos < this->schedule.size(); ++pos)
+					this->markDirty(pos);
+
+				if (!this->propagating)
+					this->drain(1);
+			}
+
+			/**	\brief	Returns the amount of components in the netlist.
+			 */
+			inline size_t size(void) const {
+				return this->schedule.size();
+			}
+
+			/**	\brief	Returns the amount of levels in the netlist (longest path + 1).
+			 */
+			inline size_t getLevelCount(void) const {
+				return this->levelOffsets.empty() ? 0 : this->levelOffsets.size() - 1;
+			}
+
+			/**	\brief	Returns the schedule position of the first component on the given level.
+			 */
+			inline size_t getLevelBegin(size_t level) const {
+				return level < this->levelOffsets.size() ? this->levelOffsets[level] : this->schedule.size();
+			}
+
+			/**	\brief	Returns the amount of threads evaluating a level (including the calling thread).
+			 */
+			inline size_t getWorkerCount(void) const {
+				return this->pool.getWorkerCount();
+			}
+
+			/**	\brief	Returns the dirty component count from which a level is split over the pool.
+			 */
+			inline size_t getThreshold(void) const {
+				return this->threshold;
+			}
+
+			/**	\brief	Set the dirty component count from which a level is split over the pool.
+			 */
+			inline void setThreshold(size_t threshold) {
+				this->threshold = threshold;
+			}
+
+			/**	\brief	Returns the total amount of tick()s issued by this netlist.
+			 */
+			inline size_t getEvaluationCount(void) const {
+				return this->evaluations;
+			}
+
+			/**	\brief	Returns the amount of levels that were split over the pool.
+			 */
+			inline size_t getParallelLevelCount(void) const {
+				return this->parallelLevels;
+			}
+
+			/**	\brief	Returns the amount of levels that were evaluated on the calling thread.
+			 */
+			inline size_t getSerialLevelCount(void) const {
+				return this->serialLevels;
+			}
+
+			/**	\brief	Returns the amount of chunks stolen between the threads.
+			 */
+			inline size_t getStealCount(void) const {
+				return this->pool.getStealCount();
+			}
+
+			/**	\brief	Reset all statistics.
+			 */
+			inline void resetStatistics(void) {
+				this->evaluations = 0;
+				this->parallelLevels = this->serialLevels = 0;
+			}
+	};
+}
+
+#endif // SYNCHROTRONPARALLEL_HPP
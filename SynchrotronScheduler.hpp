@@ -0,0 +1,265 @@
+/**
+*	Iterative, queue driven propagation for SynchrotronComponent graphs.
+*/
+#ifndef SYNCHROTRONSCHEDULER_HPP
+#define SYNCHROTRONSCHEDULER_HPP
+
+#include <vector>
+#include <unordered_map>
+#include <initializer_list>
+
+#include "SynchrotronComponent.hpp"
+#include "Exceptions.hpp"
+
+namespace Synchrotron {
+
+	/** \brief	**SynchrotronScheduler** : Event-queue engine replacing the recursive emit() -> tick() chain.
+	 *
+	 *	Every attached component hands its emit() to the scheduler, which pushes the component's
+	 *	outputs on a de-duplicated work queue and drains that queue iteratively.
+	 *	The queue is processed in waves: the components ticked in one wave fill the queue of the next one,
+	 *	and a component is queued at most once per wave. Stack use is therefore bounded,
+	 *	regardless of the depth of the graph.
+	 *
+	 *	In two-phase mode (setTwoPhase()) every wave is a delta cycle: all components of the wave first compute
+	 *	their next state from the current states (SynchrotronComponent::evaluateNext()) and then commit them together.
+	 *	No component of a wave sees a state that was changed in the same wave,
+	 *	so the result no longer depends on the order of the components within the wave.
+	 *
+	 *	Components that get connected to the graph after attach() are picked up when they are first queued.
+	 *	The scheduler does not own its components and must be released (or destroyed) before them.
+	 *
+	 *	\tparam	bit_width
+	 *		This template argument specifies the width of the components in the graph.
+	 */
+	template <size_t bit_width>
+	class SynchrotronScheduler : public Propagator<bit_width> {
+		private:
+			/**	\brief	The wave in which each known component was last queued (0 if never).
+			 */
+			std::unordered_map<SynchrotronComponent<bit_width>*, size_t> queuedInWave;
+
+			/**	\brief	The components to tick() in the current wave.
+			 */
+			std::vector<SynchrotronComponent<bit_width>*> current;
+
+			/**	\brief	The components to tick() in the next wave (the work queue).
+			 */
+			std::vector<SynchrotronComponent<bit_width>*> next;
+
+			/**	\brief	The number of the wave that is being filled by enqueue().
+			 */
+			size_t nextWave;
+
+			/**	\brief	The next states computed in the first phase of a two-phase wave.
+			 */
+			std::vector<std::StateBitset<bit_width>> nextStates;
+
+			/**	\brief	Whether the queue is currently being drained (propagate() only enqueues).
+			 */
+			bool propagating;
+
+			/**	\brief	Whether waves are evaluated in two phases (evaluate all, then commit all).
+			 */
+			bool twoPhase;
+
+			/**	\brief	Statistics: total emit()s handled, tick()s issued, waves processed and the largest wave.
+			 */
+			size_t emits, ticks, waves, peakWave;
+
+			/**	\brief	Start handling emit() for component (if not already known).
+			 *
+			 *	\return	size_t&
+			 *		Returns the wave in which component was last queued.
+			 */
+			inline size_t& track(SynchrotronComponent<bit_width> *component) {
+				auto it = this->queuedInWave.find(component);
+
+				if (it == this->queuedInWave.end()) {
+					component->setPropagator(this);
+					it = this->queuedInWave.emplace(component, 0).first;
+				}
+
+				return it->second;
+			}
+
+			/**	\brief	Queue component for a tick() in the next wave, unless it already is.
+			 */
+			inline void enqueue(SynchrotronComponent<bit_width> *component) {
+				size_t &wave = this->track(component);
+
+				if (wave == this->nextWave) return;
+
+				wave = this->nextWave;
+				this->next.push_back(component);
+			}
+
+			/**	\brief	Process waves until the work queue is empty.
+			 */
+			void drain(void) {
+				this->propagating = true;
+
+				try {
+					while (!this->next.empty()) {
+						this->current.swap(this->next);
+						++this->nextWave;
+						++this->waves;
+
+						if (this->current.size() > this->peakWave)
+							this->peakWave = this->current.size();
+
+						if (this->twoPhase) {
+							this->nextStates.clear();
+
+							for (auto component : this->current) {
+								++this->ticks;
+								this->nextStates.push_back(component->evaluateNext());
+							}
+
+							for (size_t i = 0; i < this->current.size(); ++i)
+								this->current[i]->commit(this->nextStates[i]);
+						} else {
+							for (auto component : this->current) {
+								++this->ticks;
+								component->update();
+							}
+						}
+
+						this->current.clear();
+					}
+				} catch (...) {
+					this->current.clear();
+					this->next.clear();
+					++this->nextWave;
+					this->propagating = false;
+					throw;
+				}
+
+				this->propagating = false;
+			}
+
+		public:
+			/**	\brief	Default constructor (nothing attached).
+			 */
+			SynchrotronScheduler()
+				: nextWave(1), propagating(false), twoPhase(false), emits(0), ticks(0), waves(0), peakWave(0) {}
+
+			/**	\brief	Attach constructor
+			 *
+			 *	\param	roots
+			 *		Any components of the graph; everything connected to them is attached.
+			 */
+			SynchrotronScheduler(std::initializer_list<SynchrotronComponent<bit_width>*> roots)
+				: SynchrotronScheduler() {
+				this->attach(roots);
+			}
+
+			SynchrotronScheduler(const SynchrotronScheduler&) = delete;
+			SynchrotronScheduler& operator=(const SynchrotronScheduler&) = delete;
+
+			/**	\brief	Default destructor
+			 *
+			 *			Detaches this scheduler from all of its components.
+			 */
+			~SynchrotronScheduler() {
+				this->release();
+			}
+
+			/**	\brief	Take over propagation for every component connected to roots.
+			 *
+			 *	\param	roots
+			 *		Any components of the graph; everything connected to them is attached.
+			 */
+			template <class Iterable>
+			void attach(const Iterable& roots) {
+				for (auto component : collectGraph<bit_width>(roots))
+					this->track(component);
+			}
+
+			/**	\brief	Take over propagation for every component connected to roots.
+			 *
+			 *	\param	roots
+			 *		Any components of the graph; everything connected to them is attached.
+			 */
+			void attach(std::initializer_list<SynchrotronComponent<bit_width>*> roots) {
+				this->attach<std::initializer_list<SynchrotronComponent<bit_width>*>>(roots);
+			}
+
+			/**	\brief	Detach from all components (they revert to recursive emit()s).
+			 */
+			void release(void) {
+				for (auto& entry : this->queuedInWave)
+					if (entry.first->getPropagator() == this)
+						entry.first->setPropagator(nullptr);
+
+				this->queuedInWave.clear();
+				this->current.clear();
+				this->next.clear();
+			}
+
+			/**	\brief	Called by source.emit(): queue the outputs of source and drain the queue.
+			 *
+			 *	\param	source
+			 *		The SynchrotronComponent that changed.
+			 */
+			void propagate(SynchrotronComponent<bit_width>& source) {
+				++this->emits;
+
+				for (auto& connection : source.getOutputs())
+					this->enqueue(connection);
+
+				if (!this->propagating)
+					this->drain();
+			}
+
+			/**	\brief	Enable or disable two-phase (evaluate, then commit) waves.
+			 */
+			inline void setTwoPhase(bool enable) {
+				this->twoPhase = enable;
+			}
+
+			/**	\brief	Returns whether waves are evaluated in two phases.
+			 */
+			inline bool isTwoPhase(void) const {
+				return this->twoPhase;
+			}
+
+			/**	\brief	Returns the amount of components handled by this scheduler.
+			 */
+			inline size_t size(void) const {
+				return this->queuedInWave.size();
+			}
+
+			/**	\brief	Returns the total amount of emit()s handled.
+			 */
+			inline size_t getEmitCount(void) const {
+				return this->emits;
+			}
+
+			/**	\brief	Returns the total amount of tick()s issued.
+			 */
+			inline size_t getTickCount(void) const {
+				return this->ticks;
+			}
+
+			/**	\brief	Returns the total amount of waves processed.
+			 */
+			inline size_t getWaveCount(void) const {
+				return this->waves;
+			}
+
+			/**	\brief	Returns the largest amount of components ticked in one wave.
+			 */
+			inline size_t getPeakWaveSize(void) const {
+				return this->peakWave;
+			}
+
+			/**	\brief	Reset all statistics.
+			 */
+			inline void resetStatistics(void) {
+				this->emits = this->ticks = this->waves = this->peakWave = 0;
+			}
+	};
+}
+
+#endif // SYNCHROTRONSCHEDULER_HPP
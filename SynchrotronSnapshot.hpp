@@ -0,0 +1,186 @@
+/**
+*	Lock-free published snapshots of simulation state for concurrent observers.
+*/
+#ifndef SYNCHROTRONSNAPSHOT_HPP
+#define SYNCHROTRONSNAPSHOT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <bitset>
+
+#include "SynchrotronComponent.hpp"
+
+namespace Synchrotron {
+
+	/** \brief	**SynchrotronSnapshot** : Double-buffered, sequence-locked (seqlock) array of published states.
+	 *
+	 *	One writer (the simulation thread) publishes a complete set of values with publish();
+	 *	any number of reader threads copy the last complete set with read(). Neither side ever
+	 *	takes a lock: the writer never waits for readers, and a reader only retries when the
+	 *	writer overwrote the buffer it was copying, which with two buffers takes two publications
+	 *	during a single copy.
+	 *
+	 *	Every value is stored as a relaxed `std::atomic<uint64_t>`, so a publication costs
+	 *	plain stores and two sequence updates.
+	 *
+	 *	\tparam	bit_width
+	 *		This template argument specifies the width of the published states (up to 64).
+	 */
+	template <size_t bit_width>
+	class SynchrotronSnapshot {
+		static_assert(bit_width <= 64, "SynchrotronSnapshot stores one 64-bit word per state.");
+
+		private:
+			/**	\brief	One copy of all values, guarded by its own sequence (odd while being written).
+			 */
+			struct Buffer {
+				std::atomic<size_t>						sequence;
+				std::unique_ptr<std::atomic<uint64_t>[]>	words;
+			};
+
+			/**	\brief	The amount of values.
+			 */
+			size_t length;
+
+			/**	\brief	The two buffers, publication v is written to buffers[v & 1].
+			 */
+			Buffer buffers[2];
+
+			/**	\brief	The amount of completed publications.
+			 */
+			std::atomic<size_t> version;
+
+		public:
+			/**	\brief	Writes the values of one publication (see publish()).
+			 */
+			class Writer {
+				private:
+					std::atomic<uint64_t> *words;
+
+				public:
+					explicit Writer(std::atomic<uint64_t> *words) : words(words) {}
+
+					/**	\brief	Set value i of the publication.
+					 */
+					inline void set(size_t i, uint64_t value) {
+						this->words[i].store(value, std::memory_order_relaxed);
+					}
+
+					/**	\brief	Set value i of the publication.
+					 */
+					inline void set(size_t i, const std::bitset<bit_width>& value) {
+						this->set(i, uint64_t(value.to_ullong()));
+					}
+			};
+
+			/**	\brief	Default constructor
+			 *
+			 *	\param	size
+			 *		The amount of values in every publication (all zero before the first one).
+			 */
+			explicit SynchrotronSnapshot(size_t size = 0) : version(0) {
+				this->resize(size);
+			}
+
+			SynchrotronSnapshot(const SynchrotronSnapshot&) = delete;
+			SynchrotronSnapshot& operator=(const SynchrotronSnapshot&) = delete;
+
+			/**	\brief	Change the amount of values and clear them.
+			 *
+			 *		**Not thread safe:** only call this while no thread reads or publishes.
+			 */
+			void resize(size_t size) {
+				this->length = size;
+
+				for (auto& buffer : this->buffers) {
+					buffer.sequence.store(0, std::memory_order_relaxed);
+					buffer.words.reset(new std::atomic<uint64_t>[size]);
+					for (size_t i = 0; i < size; ++i)
+						buffer.words[i].store(0, std::memory_order_relaxed);
+				}
+
+				this->version.store(0, std::memory_order_release);
+			}
+
+			/**	\brief	**[Writer thread only]** Publish a new set of values.
+			 *
+			 *	\param	fill
+			 *		Called as fill(Writer&); must set every value (values it skips keep
+			 *		those of the publication before the previous one).
+			 */
+			template <class Function>
+			void publish(Function fill) {
+				const size_t next = this->version.load(std::memory_order_relaxed) + 1;
+				Buffer &buffer = this->buffers[next & 1];
+
+				buffer.sequence.store(2 * next - 1, std::memory_order_relaxed);
+				std::atomic_thread_fence(std::memory_order_release);
+
+				Writer writer(buffer.words.get());
+				fill(writer);
+
+				buffer.sequence.store(2 * next, std::memory_order_release);
+				this->version.store(next, std::memory_order_release);
+			}
+
+			/**	\brief	**[Thread safe]** Try to copy the last publication once.
+			 *
+			 *	\param	out
+			 *		Receives size() values (resized if needed).
+			 *	\param	published
+			 *		Receives the publication number of the copy (0 before the first publication).
+			 *
+			 *	\return	bool
+			 *		Returns false if the writer overwrote the buffer during the copy (out is then inconsistent).
+			 */
+			bool tryRead(std::vector<uint64_t>& out, size_t& published) const {
+				const size_t current = this->version.load(std::memory_order_acquire);
+				const Buffer &buffer = this->buffers[current & 1];
+				const size_t before = buffer.sequence.load(std::memory_order_acquire);
+
+				if (before & 1) return false;
+
+				out.resize(this->length);
+				for (size_t i = 0; i < this->length; ++i)
+					out[i] = buffer.words[i].load(std::memory_order_relaxed);
+
+				std::atomic_thread_fence(std::memory_order_acquire);
+				published = before / 2;
+
+				return buffer.sequence.load(std::memory_order_relaxed) == before;
+			}
+
+			/**	\brief	**[Thread safe]** Copy the last publication (retries until the copy is consistent).
+			 *
+			 *	\param	out
+			 *		Receives size() values (resized if needed).
+			 *
+			 *	\return	size_t
+			 *		Returns the publication number of the copy (0 before the first publication).
+			 */
+			size_t read(std::vector<uint64_t>& out) const {
+				size_t published = 0;
+
+				while (!this->tryRead(out, published)) ;
+
+				return published;
+			}
+
+			/**	\brief	**[Thread safe]** Returns the amount of completed publications.
+			 */
+			inline size_t getVersion(void) const {
+				return this->version.load(std::memory_order_acquire);
+			}
+
+			/**	\brief	Returns the amount of values in every publication.
+			 */
+			inline size_t size(void) const {
+				return this->length;
+			}
+	};
+}
+
+#endif // SYNCHROTRONSNAPSHOT_HPP
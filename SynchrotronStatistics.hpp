@@ -0,0 +1,171 @@
+/**
+*	Activity report of SynchrotronComponent graphs (see SYNCHROTRON_STATISTICS).
+*/
+#ifndef SYNCHROTRONSTATISTICS_HPP
+#define SYNCHROTRONSTATISTICS_HPP
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <initializer_list>
+
+#include "SynchrotronComponent.hpp"
+#include "utils.hpp"
+
+namespace Synchrotron {
+
+	/** \brief	**SynchrotronActivityReport** : Aggregates the ActivityCounters of every component in a graph.
+	 *
+	 *	The counters are only collected when SYNCHROTRON_STATISTICS is defined before including
+	 *	SynchrotronComponent.hpp; otherwise the report is empty (all zeros).
+	 *	The report is a snapshot: construct a new one to see later activity.
+	 *
+	 *	\tparam	bit_width
+	 *		This template argument specifies the width of the components in the graph.
+	 */
+	template <size_t bit_width>
+	class SynchrotronActivityReport {
+		public:
+			/**	\brief	The activity of all components of one type.
+			 */
+			struct TypeEntry {
+				std::string			type;		///< The demangled type name (e.g. `ANDGate<8>`).
+				size_t				components;	///< The amount of components of this type.
+				ActivityCounters	activity;	///< The summed activity.
+			};
+
+			/**	\brief	The activity of one component.
+			 */
+			struct NodeEntry {
+				const SynchrotronComponent<bit_width>	*component;
+				std::string								type;
+				ActivityCounters						activity;
+			};
+
+		private:
+			/**	\brief	Every component, hottest (most ticks) first.
+			 */
+			std::vector<NodeEntry> nodes;
+
+			/**	\brief	The activity per type, hottest first.
+			 */
+			std::vector<TypeEntry> types;
+
+			/**	\brief	The activity of the whole graph.
+			 */
+			ActivityCounters total;
+
+			/**	\brief	Order by ticks, then emits (descending).
+			 */
+			static inline bool hotter(const ActivityCounters& a, const ActivityCounters& b) {
+				return a.ticks != b.ticks ? a.ticks > b.ticks : a.emits > b.emits;
+			}
+
+			/**	\brief	Collect the activity of every component connected to roots.
+			 */
+			template <class Iterable>
+			void collect(const Iterable& roots) {
+				std::map<std::string, TypeEntry> byType;
+
+				for (auto component : collectGraph<bit_width>(roots)) {
+					const NodeEntry node = { component, std::type2name(*component), component->getActivity() };
+					TypeEntry &entry = byType[node.type];
+
+					entry.type = node.type;
+					++entry.components;
+					entry.activity += node.activity;
+					this->total += node.activity;
+					this->nodes.push_back(node);
+				}
+
+				for (auto& entry : byType)
+					this->types.push_back(entry.second);
+
+				std::stable_sort(this->nodes.begin(), this->nodes.end(),
+								 [](const NodeEntry& a, const NodeEntry& b) { return hotter(a.activity, b.activity); });
+				std::stable_sort(this->types.begin(), this->types.end(),
+								 [](const TypeEntry& a, const TypeEntry& b) { return hotter(a.activity, b.activity); });
+			}
+
+		public:
+			/**	\brief	Collect the activity of every component connected to roots.
+			 *
+			 *	\param	roots
+			 *		Any iterable of SynchrotronComponent<bit_width>*; everything connected to them is included.
+			 */
+			template <class Iterable>
+			explicit SynchrotronActivityReport(const Iterable& roots) {
+				this->collect(roots);
+			}
+
+			/**	\brief	Collect the activity of every component connected to roots.
+			 */
+			explicit SynchrotronActivityReport(std::initializer_list<SynchrotronComponent<bit_width>*> roots) {
+				this->collect(roots);
+			}
+
+			/**	\brief	Returns the activity per component type, hottest first.
+			 */
+			inline const std::vector<TypeEntry>& getTypes(void) const {
+				return this->types;
+			}
+
+			/**	\brief	Returns every component, hottest first.
+			 */
+			inline const std::vector<NodeEntry>& getNodes(void) const {
+				return this->nodes;
+			}
+
+			/**	\brief	Returns the activity of the whole graph.
+			 */
+			inline const ActivityCounters& getTotal(void) const {
+				return this->total;
+			}
+
+			/**	\brief	Print the activity per type and the hottest components.
+			 *
+			 *	\param	os
+			 *		The stream to print to.
+			 *	\param	hottest
+			 *		The amount of components to list.
+			 */
+			void print(std::ostream& os, size_t hottest = 10) const {
+				auto row = [&os](const std::string& name, const std::string& count, const ActivityCounters& a) {
+					os << std::left  << std::setw(32) << name
+					   << std::right << std::setw(8)  << count
+					   << std::setw(12) << a.ticks << std::setw(12) << a.emits
+					   << std::setw(12) << a.changes << std::setw(12) << a.toggles << std::endl;
+				};
+
+				#ifndef SYNCHROTRON_STATISTICS
+					os << "[WARNING] Compiled without SYNCHROTRON_STATISTICS: no activity was counted." << std::endl;
+				#endif
+
+				os << std::left  << std::setw(32) << "Type"
+				   << std::right << std::setw(8)  << "Count"
+				   << std::setw(12) << "Ticks" << std::setw(12) << "Emits"
+				   << std::setw(12) << "Changes" << std::setw(12) << "Toggles" << std::endl;
+
+				for (auto& entry : this->types)
+					row(entry.type, std::to_string(entry.components), entry.activity);
+				row("Total", std::to_string(this->nodes.size()), this->total);
+
+				os << std::endl << "Hottest components:" << std::endl;
+				for (size_t i = 0; i < hottest && i < this->nodes.size(); ++i)
+					row(this->nodes[i].type, "#" + std::to_string(this->nodes[i].component->getOrder()), this->nodes[i].activity);
+			}
+	};
+
+	/**	\brief	Reset the activity counters of every component connected to roots.
+	 */
+	template <size_t bit_width, class Iterable>
+	void resetActivity(const Iterable& roots) {
+		for (auto component : collectGraph<bit_width>(roots))
+			component->resetActivity();
+	}
+}
+
+#endif // SYNCHROTRONSTATISTICS_HPP
@@ -0,0 +1,259 @@
+/**
+*	Reusable, hierarchical circuit definitions that are instantiated as flat SynchrotronComponent graphs.
+*/
+#ifndef SYNCHROTRONSUBCIRCUIT_HPP
+#define SYNCHROTRONSUBCIRCUIT_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <initializer_list>
+
+#include "SynchrotronComponent.hpp"
+#include "SynchrotronGraph.hpp"
+#include "SynchrotronBuilder.hpp"
+#include "Exceptions.hpp"
+
+namespace Synchrotron {
+
+	/** \brief	**SynchrotronSubcircuit** : Definition of a composite component (e.g. a full adder) built from gates
+	 *			and other subcircuits, that can be instantiated many times.
+	 *
+	 *	A definition has numbered input ports, gates and output ports, connected through Signals:
+	 *	every input port and every gate output is one Signal. Adding an instance of another subcircuit
+	 *	copies its gates into this definition right away, so a definition is always flat, however deep
+	 *	the hierarchy it was built from.
+	 *
+	 *	instantiate() then creates the gates in a SynchrotronGraph and connects them in bulk (see
+	 *	SynchrotronBuilder), directly to the given input components. An instance is therefore just
+	 *	its gates: there is no component at its boundary, so it costs neither a virtual call nor
+	 *	an extra emit() per signal crossing it, exactly like the same gates wired by hand.
+	 *	Inputs are connected in the order given to add(), so non-commutative gates get their operands right.
+	 *
+	 *	\tparam	bit_width
+	 *		This template argument specifies the width of the components.
+	 *	\tparam	lock_policy
+	 *		The lock_policy of the components.
+	 */
+	template <size_t bit_width, class lock_policy = SYNCHROTRON_LOCK_POLICY>
+	class SynchrotronSubcircuit {
+		public:
+			typedef SynchrotronComponent<bit_width, lock_policy>	Component;
+			typedef SynchrotronGraph<bit_width, lock_policy>		Graph;
+
+			/**	\brief	A signal of the definition: input port i is Signal i, gate g is Signal getInputCount() + g.
+			 */
+			typedef size_t Signal;
+
+		private:
+			/**	\brief	One gate: how to create it and its inputs (in gateInputs).
+			 */
+			struct Gate {
+				Component*	(*create)(Graph&);
+				size_t		firstInput, inputCount;
+			};
+
+			size_t				inputs;
+			std::vector<Gate>	gates;
+			std::vector<Signal>	gateInputs;
+			std::vector<Signal>	outputs;
+
+			template <class T>
+			static Component* createIn(Graph& graph) {
+				return graph.template create<T>();
+			}
+
+			/**	\brief	Throw unless signal exists in this definition.
+			 */
+			inline void check(Signal signal) const {
+				if (signal >= this->getSignalCount())
+					throw Exceptions::Exception("[ERROR] Subcircuit signal " + std::to_string(signal) + " does not exist (only "
+											  + std::to_string(this->getSignalCount()) + " signals)!");
+			}
+
+			/**	\brief	Add a gate created by create, reading signals.
+			 */
+			template <class Iterable>
+			Signal addGate(Component* (*create)(Graph&), const Iterable& signals) {
+				Gate gate = { create, this->gateInputs.size(), 0 };
+
+				for (auto signal : signals) {
+					this->check(signal);
+					this->gateInputs.push_back(signal);
+					++gate.inputCount;
+				}
+
+				this->gates.push_back(gate);
+				return this->inputs + this->gates.size() - 1;
+			}
+
+		public:
+			/**	\brief	Default constructor
+			 *
+			 *	\param	inputCount
+			 *		The amount of input ports (Signals 0 up to inputCount).
+			 */
+			explicit SynchrotronSubcircuit(size_t inputCount = 0) : inputs(inputCount) {}
+
+			/**	\brief	Returns the Signal of input port i.
+			 *
+			 *	\exception	Exceptions::OutOfBoundsException
+			 *		Throws exception if there is no input port i.
+			 */
+			inline Signal input(size_t i) const {
+				if (i >= this->inputs)
+					throw Exceptions::OutOfBoundsException(int(i));
+				return i;
+			}
+
+			/**	\brief	Add a gate of type T reading signals (in port order).
+			 *
+			 *	\tparam	T
+			 *		A default constructible SynchrotronComponent<bit_width, lock_policy> or derived class.
+			 *	\return	Signal
+			 *		Returns the output of the gate.
+			 *	\exception	Exceptions::Exception
+			 *		Throws exception if a signal does not exist.
+			 */
+			template <class T>
+			Signal add(std::initializer_list<Signal> signals) {
+				return this->addGate(&SynchrotronSubcircuit::createIn<T>, signals);
+			}
+
+			/**	\brief	Add a gate of type T reading signals (in port order).
+			 */
+			template <class T>
+			Signal add(const std::vector<Signal>& signals) {
+				return this->addGate(&SynchrotronSubcircuit::createIn<T>, signals);
+			}
+
+			/**	\brief	Add an instance of sub: its gates are copied into this definition.
+			 *
+			 *	\param	sub
+			 *		The subcircuit to instance (may be this definition itself).
+			 *	\param	signals
+			 *		The signals for the input ports of sub.
+			 *	\return	std::vector<Signal>
+			 *		Returns the signals of the output ports of sub.
+			 *	\exception	Exceptions::Exception
+			 *		Throws exception if the amount of signals does not match sub or a signal does not exist.
+			 */
+			std::vector<Signal> add(const SynchrotronSubcircuit& sub, const std::vector<Signal>& signals) {
+				if (signals.size() != sub.inputs)
+					throw Exceptions::Exception("[ERROR] Subcircuit instance needs " + std::to_string(sub.inputs)
+											  + " input signals, got " + std::to_string(signals.size()) + "!");
+				for (auto signal : signals)
+					this->check(signal);
+
+				// Copies first, so instancing this definition into itself only copies what was there before.
+				const std::vector<Gate> subGates(sub.gates);
+				const std::vector<Signal> subInputs(sub.gateInputs), subOutputs(sub.outputs);
+				std::vector<Signal> map(signals), result;
+				std::vector<Signal> gateSignals;
+
+				map.reserve(sub.inputs + subGates.size());
+				for (auto& gate : subGates) {
+					gateSignals.clear();
+					for (size_t e = gate.firstInput; e < gate.firstInput + gate.inputCount; ++e)
+						gateSignals.push_back(map[subInputs[e]]);
+					map.push_back(this->addGate(gate.create, gateSignals));
+				}
+
+				for (auto output : subOutputs)
+					result.push_back(map[output]);
+
+				return result;
+			}
+
+			/**	\brief	Add an instance of sub: its gates are copied into this definition.
+			 */
+			std::vector<Signal> add(const SynchrotronSubcircuit& sub, std::initializer_list<Signal> signals) {
+				return this->add(sub, std::vector<Signal>(signals));
+			}
+
+			/**	\brief	Make signal the next output port.
+			 *
+			 *	\exception	Exceptions::Exception
+			 *		Throws exception if signal does not exist.
+			 */
+			SynchrotronSubcircuit& output(Signal signal) {
+				this->check(signal);
+				this->outputs.push_back(signal);
+				return *this;
+			}
+
+			/**	\brief	Make every signal in signals the next output port.
+			 */
+			SynchrotronSubcircuit& output(const std::vector<Signal>& signals) {
+				for (auto signal : signals)
+					this->output(signal);
+				return *this;
+			}
+
+			/**	\brief	Create the gates of this definition in graph, connected to inputList.
+			 *
+			 *	\param	graph
+			 *		The graph that owns the new gates.
+			 *	\param	inputList
+			 *		The components for the input ports (any components, in or outside graph).
+			 *	\return	std::vector<Component*>
+			 *		Returns the components of the output ports (gates, or input components passed through).
+			 *	\exception	Exceptions::Exception
+			 *		Throws exception if the amount of inputs does not match, or a gate would exceed its getMaxInputs().
+			 */
+			std::vector<Component*> instantiate(Graph& graph, const std::vector<Component*>& inputList) const {
+				if (inputList.size() != this->inputs)
+					throw Exceptions::Exception("[ERROR] Subcircuit needs " + std::to_string(this->inputs)
+											  + " inputs, got " + std::to_string(inputList.size()) + "!");
+
+				std::vector<Component*> signals(inputList), result;
+				signals.reserve(this->getSignalCount());
+				for (auto& gate : this->gates)
+					signals.push_back(gate.create(graph));
+
+				SynchrotronBuilder<bit_width, lock_policy> builder(signals);
+				builder.reserve(this->gateInputs.size());
+				for (size_t g = 0; g < this->gates.size(); ++g)
+					for (size_t e = this->gates[g].firstInput; e < this->gates[g].firstInput + this->gates[g].inputCount; ++e)
+						builder.connect(this->gateInputs[e], this->inputs + g);
+				builder.commit();
+
+				for (auto output : this->outputs)
+					result.push_back(signals[output]);
+
+				return result;
+			}
+
+			/**	\brief	Create the gates of this definition in graph, connected to inputList.
+			 */
+			std::vector<Component*> instantiate(Graph& graph, std::initializer_list<Component*> inputList) const {
+				return this->instantiate(graph, std::vector<Component*>(inputList));
+			}
+
+			/**	\brief	Returns the amount of input ports.
+			 */
+			inline size_t getInputCount(void) const {
+				return this->inputs;
+			}
+
+			/**	\brief	Returns the amount of output ports.
+			 */
+			inline size_t getOutputCount(void) const {
+				return this->outputs.size();
+			}
+
+			/**	\brief	Returns the amount of gates of one instance.
+			 */
+			inline size_t getGateCount(void) const {
+				return this->gates.size();
+			}
+
+			/**	\brief	Returns the amount of signals (input ports and gates).
+			 */
+			inline size_t getSignalCount(void) const {
+				return this->inputs + this->gates.size();
+			}
+	};
+}
+
+#endif // SYNCHROTRONSUBCIRCUIT_HPP
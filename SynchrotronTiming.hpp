@@ -0,0 +1,601 @@
+/**
+*	Timing-aware, event driven simulation of SynchrotronComponent graphs with per-type propagation delays.
+*/
+#ifndef SYNCHROTRONTIMING_HPP
+#define SYNCHROTRONTIMING_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <vector>
+#include <limits>
+#include <typeinfo>
+#include <typeindex>
+#include <unordered_map>
+#include <initializer_list>
+
+#include "SynchrotronComponent.hpp"
+#include "BitsetKernels.hpp"
+#include "Exceptions.hpp"
+
+namespace Synchrotron {
+
+	/**	\brief	Simulated time in picoseconds.
+	 */
+	typedef unsigned long long SimTime;
+
+	/** \brief	**DelayTable** : The propagation delay of every component type.
+	 *
+	 *		Delays are looked up by the dynamic type of a component (e.g. `ANDGate<8>`),
+	 *		types without an entry get the default delay.
+	 */
+	class DelayTable {
+		private:
+			std::unordered_map<std::type_index, SimTime> delays;
+			SimTime fallback;
+
+		public:
+			/**	\brief	Default constructor
+			 *
+			 *	\param	fallback
+			 *		The delay of types without an entry, in picoseconds (1 = a unit delay model).
+			 */
+			explicit DelayTable(SimTime fallback = 1) : fallback(fallback) {}
+
+			/**	\brief	Set the delay of every component of type Component.
+			 *
+			 *	\param	delay
+			 *		The delay in picoseconds.
+			 */
+			template <class Component>
+			DelayTable& set(SimTime delay) {
+				return this->set(typeid(Component), delay);
+			}
+
+			/**	\brief	Set the delay of every component of the given type.
+			 */
+			DelayTable& set(const std::type_info& type, SimTime delay) {
+				this->delays[std::type_index(type)] = delay;
+				return *this;
+			}
+
+			/**	\brief	Set the delay of types without an entry.
+			 */
+			inline void setDefault(SimTime delay) {
+				this->fallback = delay;
+			}
+
+			/**	\brief	Returns the delay of types without an entry.
+			 */
+			inline SimTime getDefault(void) const {
+				return this->fallback;
+			}
+
+			/**	\brief	Returns the delay of component (by its dynamic type).
+			 */
+			template <class Component>
+			SimTime get(const Component& component) const {
+				auto it = this->delays.find(std::type_index(typeid(component)));
+				return it == this->delays.end() ? this->fallback : it->second;
+			}
+	};
+
+	/** \brief	**TimingWheel** : Hierarchical timing wheel, a priority queue of events by SimTime.
+	 *
+	 *		The 64-bit time is split in 8 digits of 8 bits, one wheel level of 256 slots per digit.
+	 *		An event is stored on the level of the highest digit in which its time differs from now(),
+	 *		in the slot of that digit. Level 0 therefore holds events of the current 256 ps window
+	 *		by exact time; when it runs empty, the first occupied slot of the lowest occupied level above
+	 *		is cascaded into the levels below. Every event is moved at most once per level, so
+	 *		scheduling and popping cost O(1) however many events are pending,
+	 *		and a bitmap per level finds the next occupied slot without scanning empty ones.
+	 *		Events of the same time are popped in scheduling order.
+	 *
+	 *	\tparam	T
+	 *		The event type.
+	 */
+	template <class T>
+	class TimingWheel {
+		public:
+			static const size_t digit_bits	= 8;
+			static const size_t slots		= size_t(1) << digit_bits;
+			static const size_t levels		= 64 / digit_bits;
+
+		private:
+			struct Entry {
+				SimTime	time;
+				T		value;
+			};
+
+			std::vector<Entry>	wheel[levels][slots];
+			uint64_t			occupied[levels][slots / 64];
+			std::vector<Entry>	cascading;
+
+			SimTime	current;
+			size_t	count;
+
+			static inline size_t digit(SimTime time, size_t level) {
+				return size_t(time >> (digit_bits * level)) & (slots - 1);
+			}
+
+			/**	\brief	Store entry on the level of the highest digit in which it differs from current.
+			 */
+			inline void insert(const Entry& entry) {
+				SimTime differs = (entry.time ^ this->current) >> digit_bits;
+				size_t level = 0;
+
+				while (differs) {
+					differs >>= digit_bits;
+					++level;
+				}
+
+				const size_t slot = digit(entry.time, level);
+				this->wheel[level][slot].push_back(entry);
+				this->occupied[level][slot / 64] |= uint64_t(1) << (slot % 64);
+			}
+
+			/**	\brief	Find the first occupied slot of level, starting at slot from.
+			 */
+			inline bool firstOccupied(size_t level, size_t from, size_t& slot) const {
+				size_t w = from / 64;
+				uint64_t bits = this->occupied[level][w] & (~uint64_t(0) << (from % 64));
+
+				while (true) {
+					if (bits) {
+						slot = w * 64 + std::lowestSetBit(bits);
+						return true;
+					}
+					if (++w == slots / 64) return false;
+					bits = this->occupied[level][w];
+				}
+			}
+
+			inline void release(size_t level, size_t slot) {
+				this->occupied[level][slot / 64] &= ~(uint64_t(1) << (slot % 64));
+			}
+
+		public:
+			/**	\brief	Default constructor (empty, now() is 0).
+			 */
+			TimingWheel() : current(0), count(0) {
+				std::memset(this->occupied, 0, sizeof(this->occupied));
+			}
+
+			/**	\brief	Schedule value at time.
+			 *
+			 *	\exception	Exceptions::Exception
+			 *		Throws exception if time lies before now() (only with THROW_EXCEPTIONS).
+			 */
+			inline void schedule(SimTime time, const T& value) {
+				#ifdef THROW_EXCEPTIONS
+					if (time < this->current)
+						throw Exceptions::Exception("[ERROR] Cannot schedule an event in the past!");
+				#endif
+				this->insert(Entry{ time, value });
+				++this->count;
+			}
+
+			/**	\brief	Advance now() to the earliest pending time, if it is not after limit,
+			 *			and move every event of that time to due.
+			 *
+			 *	\param	due
+			 *		Receives the events (must be empty).
+			 *	\param	limit
+			 *		The latest time to advance to.
+			 *
+			 *	\return	bool
+			 *		Returns false (and keeps now()) if no event is pending up to limit.
+			 */
+			bool pop(std::vector<T>& due, SimTime limit = std::numeric_limits<SimTime>::max()) {
+				size_t slot;
+
+				while (this->count) {
+					if (this->firstOccupied(0, digit(this->current, 0), slot)) {
+						const SimTime time = (this->current & ~SimTime(slots - 1)) | SimTime(slot);
+						if (time > limit) return false;
+
+						this->current = time;
+						for (auto& entry : this->wheel[0][slot])
+							due.push_back(entry.value);
+						this->wheel[0][slot].clear();
+						this->release(0, slot);
+
+						this->count -= due.size();
+						return true;
+					}
+
+					// The current window is empty: cascade the next occupied slot of the lowest occupied level.
+					size_t level = 1;
+					while (level < levels && !this->firstOccupied(level, 0, slot)) ++level;
+					if (level == levels) return false;
+
+					const size_t shift = digit_bits * level;
+					const SimTime above = level + 1 < levels ? this->current >> (shift + digit_bits) << (shift + digit_bits) : 0;
+					const SimTime start = above | (SimTime(slot) << shift);
+					if (start > limit) return false;
+
+					// The slot may start before limit while all of its events lie after it: then keep now().
+					if (limit < start + ((SimTime(1) << shift) - 1)) {
+						SimTime earliest = std::numeric_limits<SimTime>::max();
+						for (auto& entry : this->wheel[level][slot])
+							earliest = std::min(earliest, entry.time);
+						if (earliest > limit) return false;
+					}
+
+					this->current = start;
+					this->cascading.swap(this->wheel[level][slot]);
+					this->release(level, slot);
+					for (auto& entry : this->cascading)
+						this->insert(entry);
+					this->cascading.clear();
+				}
+
+				return false;
+			}
+
+			/**	\brief	Drop every pending event and return to time 0 (keeps the allocated slots).
+			 */
+			void clear(void) {
+				for (size_t level = 0; level < levels; ++level)
+					for (size_t slot = 0; slot < slots; ++slot)
+						this->wheel[level][slot].clear();
+				std::memset(this->occupied, 0, sizeof(this->occupied));
+				this->current = 0;
+				this->count = 0;
+			}
+
+			/**	\brief	Returns the time of the last popped events (every pending event lies at or after it).
+			 */
+			inline SimTime now(void) const {
+				return this->current;
+			}
+
+			/**	\brief	Returns the amount of pending events.
+			 */
+			inline size_t size(void) const {
+				return this->count;
+			}
+
+			/**	\brief	Returns whether no event is pending.
+			 */
+			inline bool empty(void) const {
+				return !this->count;
+			}
+	};
+
+	/** \brief	**SynchrotronTiming** : Event driven simulation with a propagation delay per component type.
+	 *
+	 *	compile() takes over the propagation of a graph, like SynchrotronScheduler. When a component changes
+	 *	at time t, each of its outputs computes its next state from the inputs at t
+	 *	(SynchrotronComponent::evaluateNext()) and the new state is committed at t + its delay (transport delay).
+	 *	The pending commits wait on a TimingWheel, so every intermediate state of a path with unequal delays
+	 *	is simulated: a component that changes more than once after one stimulus is counted as a glitch,
+	 *	and the time from the stimulus to its last change is its settling time.
+	 *
+	 *	A change from outside the graph (e.g. MemoryCell::setState()) is a stimulus at getTime().
+	 *	By default the graph is settled right away (see setAutoSettle()); otherwise runUntil() simulates
+	 *	up to a point in time, e.g. the next clock edge, and leaves the later events pending.
+	 *
+	 *	Components that get connected to the graph after compile() are updated without delay.
+	 *	The simulation does not own its components and must be released (or destroyed) before them.
+	 *
+	 *	\tparam	bit_width
+	 *		This template argument specifies the width of the components in the graph.
+	 */
+	template <size_t bit_width>
+	class SynchrotronTiming : public Propagator<bit_width> {
+		private:
+			/**	\brief	A pending commit: the next state of a node.
+			 */
+			struct Event {
+				size_t						node;
+				std::StateBitset<bit_width>	value;
+			};
+
+			/**	\brief	The components of the graph and the position of each.
+			 */
+			std::vector<SynchrotronComponent<bit_width>*> nodes;
+			std::unordered_map<const SynchrotronComponent<bit_width>*, size_t> index;
+
+			/**	\brief	The delay of each node.
+			 */
+			std::vector<SimTime> delays;
+
+			/**	\brief	The outputs of each node as positions (CSR, nodes.size() + 1 offsets).
+			 */
+			std::vector<size_t> fanoutOffsets, fanout;
+
+			/**	\brief	The stimulus in which each node changed last (0 if never).
+			 */
+			std::vector<size_t> changedIn;
+
+			TimingWheel<Event>	wheel;
+			std::vector<Event>	due;
+
+			/**	\brief	The current time, the time of the last stimulus and of the last change since.
+			 */
+			SimTime time, stimulus, lastChange;
+
+			/**	\brief	The number of the current stimulus.
+			 */
+			size_t stimuli;
+
+			/**	\brief	Whether events are being processed (propagate() only schedules).
+			 */
+			bool running;
+
+			/**	\brief	Whether every stimulus is settled right away.
+			 */
+			bool autoSettle;
+
+			/**	\brief	Statistics: processed events, changes and glitches.
+			 */
+			size_t events, changes, glitches;
+
+			/**	\brief	Schedule the next state of node at the current time + its delay.
+			 */
+			inline void schedule(size_t node) {
+				this->wheel.schedule(this->time + this->delays[node], Event{ node, this->nodes[node]->evaluateNext() });
+			}
+
+			/**	\brief	Process every event up to limit.
+			 */
+			void run(SimTime limit) {
+				this->running = true;
+
+				try {
+					while (this->wheel.pop(this->due, limit)) {
+						this->time = this->wheel.now();
+
+						for (auto& event : this->due) {
+							SynchrotronComponent<bit_width> *node = this->nodes[event.node];
+							++this->events;
+
+							if (event.value != node->getNativeState()) {
+								++this->changes;
+								if (this->changedIn[event.node] == this->stimuli)	++this->glitches;
+								else												this->changedIn[event.node] = this->stimuli;
+								this->lastChange = this->time;
+							}
+
+							node->commit(event.value);
+						}
+
+						this->due.clear();
+					}
+				} catch (...) {
+					this->due.clear();
+					this->wheel.clear();
+					this->running = false;
+					throw;
+				}
+
+				this->running = false;
+			}
+
+		public:
+			/**	\brief	Default constructor (nothing compiled).
+			 */
+			SynchrotronTiming()
+				: time(0), stimulus(0), lastChange(0), stimuli(0), running(false), autoSettle(true)
+				, events(0), changes(0), glitches(0) {}
+
+			/**	\brief	Compile constructor
+			 *
+			 *	\param	roots
+			 *		Any components of the graph; everything connected to them is included.
+			 *	\param	table
+			 *		The delay of each component type.
+			 */
+			SynchrotronTiming(std::initializer_list<SynchrotronComponent<bit_width>*> roots, const DelayTable& table = DelayTable())
+				: SynchrotronTiming() {
+				this->compile(roots, table);
+			}
+
+			SynchrotronTiming(const SynchrotronTiming&) = delete;
+			SynchrotronTiming& operator=(const SynchrotronTiming&) = delete;
+
+			/**	\brief	Default destructor
+			 *
+			 *			Detaches this simulation from all of its components.
+			 */
+			~SynchrotronTiming() {
+				this->release();
+			}
+
+			/**	\brief	Take over the propagation of the graph connected to roots, with the delays of table.
+			 *
+			 *			Any previously compiled graph is released first.
+			 *
+			 *	\param	roots
+			 *		Any components of the graph; everything connected to them is included.
+			 *	\param	table
+			 *		The delay of each component type.
+			 */
+			template <class Iterable>
+			void compile(const Iterable& roots, const DelayTable& table = DelayTable()) {
+				this->release();
+
+				this->nodes = collectGraph<bit_width>(roots);
+				for (size_t i = 0; i < this->nodes.size(); ++i) {
+					this->index[this->nodes[i]] = i;
+					this->delays.push_back(table.get(*this->nodes[i]));
+				}
+
+				this->fanoutOffsets.assign(1, 0);
+				for (auto node : this->nodes) {
+					for (auto& connection : node->getOutputs())
+						this->fanout.push_back(this->index[connection]);
+					this->fanoutOffsets.push_back(this->fanout.size());
+				}
+
+				this->changedIn.assign(this->nodes.size(), 0);
+
+				for (auto node : this->nodes)
+					node->setPropagator(this);
+			}
+
+			/**	\brief	Take over the propagation of the graph connected to roots, with the delays of table.
+			 */
+			void compile(std::initializer_list<SynchrotronComponent<bit_width>*> roots, const DelayTable& table = DelayTable()) {
+				this->compile<std::initializer_list<SynchrotronComponent<bit_width>*>>(roots, table);
+			}
+
+			/**	\brief	Detach from all components (they revert to recursive emit()s) and drop pending events.
+			 */
+			void release(void) {
+				for (auto node : this->nodes)
+					if (node->getPropagator() == this)
+						node->setPropagator(nullptr);
+
+				this->nodes.clear();
+				this->index.clear();
+				this->delays.clear();
+				this->fanoutOffsets.clear();
+				this->fanout.clear();
+				this->changedIn.clear();
+				this->wheel.clear();
+				this->time = this->stimulus = this->lastChange = 0;
+			}
+
+			/**	\brief	Called by source.emit(): schedule the next states of the outputs of source.
+			 *
+			 *	\param	source
+			 *		The SynchrotronComponent that changed.
+			 */
+			void propagate(SynchrotronComponent<bit_width>& source) {
+				auto it = this->index.find(&source);
+
+				if (it == this->index.end()) {
+					// Not part of this simulation (anymore): fall back to a direct tick() of the outputs.
+					for (auto& connection : source.getOutputs())
+						connection->update();
+					return;
+				}
+
+				if (!this->running) {
+					++this->stimuli;
+					this->stimulus = this->lastChange = this->time;
+				}
+
+				for (size_t f = this->fanoutOffsets[it->second]; f < this->fanoutOffsets[it->second + 1]; ++f)
+					this->schedule(this->fanout[f]);
+
+				if (!this->running && this->autoSettle)
+					this->settle();
+			}
+
+			/**	\brief	Process every pending event.
+			 *
+			 *	\return	SimTime
+			 *		Returns the settling time of the last stimulus (see getSettleTime()).
+			 */
+			SimTime settle(void) {
+				this->run(std::numeric_limits<SimTime>::max());
+				return this->getSettleTime();
+			}
+
+			/**	\brief	Process every event up to (and including) until and advance getTime() to it.
+			 *
+			 *	\return	bool
+			 *		Returns whether the graph settled (no events are pending).
+			 *	\exception	Exceptions::Exception
+			 *		Throws exception if until lies before getTime().
+			 */
+			bool runUntil(SimTime until) {
+				if (until < this->time)
+					throw Exceptions::Exception("[ERROR] Cannot run the timing simulation back in time!");
+
+				this->run(until);
+				this->time = until;
+				return this->wheel.empty();
+			}
+
+			/**	\brief	Settle every stimulus as soon as it happens (default), or only in settle() and runUntil().
+			 */
+			inline void setAutoSettle(bool enable) {
+				this->autoSettle = enable;
+			}
+
+			/**	\brief	Returns whether every stimulus is settled as soon as it happens.
+			 */
+			inline bool getAutoSettle(void) const {
+				return this->autoSettle;
+			}
+
+			/**	\brief	Returns the current simulated time in picoseconds.
+			 */
+			inline SimTime getTime(void) const {
+				return this->time;
+			}
+
+			/**	\brief	Returns the time from the last stimulus to the last change it caused so far.
+			 */
+			inline SimTime getSettleTime(void) const {
+				return this->lastChange - this->stimulus;
+			}
+
+			/**	\brief	Returns whether the last stimulus settled within one period of clock.
+			 *
+			 *	\param	clock
+			 *		Any object with `getPeriod()` in seconds, e.g. a CPUComponents::Clock.
+			 */
+			template <class TimeSource>
+			bool settlesWithin(const TimeSource& clock) const {
+				return this->wheel.empty()
+					&& this->getSettleTime() <= SimTime(std::llround(double(clock.getPeriod()) * 1e12));
+			}
+
+			/**	\brief	Returns the delay of component in this simulation.
+			 *
+			 *	\exception	Exceptions::Exception
+			 *		Throws exception if the component is not part of this simulation.
+			 */
+			SimTime getDelay(const SynchrotronComponent<bit_width>& component) const {
+				auto it = this->index.find(&component);
+
+				if (it == this->index.end())
+					throw Exceptions::Exception("[ERROR] Component is not part of this SynchrotronTiming!");
+
+				return this->delays[it->second];
+			}
+
+			/**	\brief	Returns the amount of components in the simulation.
+			 */
+			inline size_t size(void) const {
+				return this->nodes.size();
+			}
+
+			/**	\brief	Returns the amount of pending events.
+			 */
+			inline size_t getPendingCount(void) const {
+				return this->wheel.size();
+			}
+
+			/**	\brief	Returns the total amount of processed events.
+			 */
+			inline size_t getEventCount(void) const {
+				return this->events;
+			}
+
+			/**	\brief	Returns the total amount of events that changed a state.
+			 */
+			inline size_t getChangeCount(void) const {
+				return this->changes;
+			}
+
+			/**	\brief	Returns the total amount of changes of components that already changed after the same stimulus.
+			 */
+			inline size_t getGlitchCount(void) const {
+				return this->glitches;
+			}
+
+			/**	\brief	Reset all statistics.
+			 */
+			inline void resetStatistics(void) {
+				this->events = this->changes = this->glitches = 0;
+			}
+	};
+}
+
+#endif // SYNCHROTRONTIMING_HPP
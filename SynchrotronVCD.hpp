@@ -0,0 +1,363 @@
+/**
+*	Streaming Value Change Dump (VCD) waveforms of SynchrotronComponent states.
+*/
+#ifndef SYNCHROTRONVCD_HPP
+#define SYNCHROTRONVCD_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <memory>
+#include <fstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <utility>
+
+#include "SynchrotronComponent.hpp"
+#include "Exceptions.hpp"
+
+namespace Synchrotron {
+
+	/** \brief	**SynchrotronVCD** : Records the states of probed components to a VCD file while simulating.
+	 *
+	 *	Every probed component gets a Probe (see SynchrotronComponent::setProbe()), so it is observed
+	 *	without becoming an input of anything: its outputs and their order stay the same.
+	 *	On each emit() the probe compares the state with the last recorded one and only appends
+	 *	actual changes, timestamped with the simulated time of the clock given to setClock(),
+	 *	to a buffer. Full buffers are handed to a background thread that formats and writes them,
+	 *	so the simulation only waits when the writer falls a whole buffer behind.
+	 *
+	 *	Add every probe before the first change (or start()), since a VCD declares all signals up front;
+	 *	when probed components emit from several threads, call start() before they do.
+	 *	The probed components must outlive this writer (or be removed with remove() first).
+	 *
+	 *	\tparam	bit_width
+	 *		This template argument specifies the width of the probed components.
+	 *	\tparam	lock_policy
+	 *		The lock policy of the components; it also guards the buffer, so use SpinLock or MutexLock
+	 *		when probed components emit from several threads.
+	 */
+	template <size_t bit_width, class lock_policy = SYNCHROTRON_LOCK_POLICY>
+	class SynchrotronVCD {
+		public:
+			typedef SynchrotronComponent<bit_width, lock_policy> Component;
+
+		private:
+			/**	\brief	The Probe attached to one component: one VCD signal.
+			 */
+			class Channel : public Probe<bit_width, lock_policy> {
+				public:
+					SynchrotronVCD					*owner;
+					Component						*component;
+					std::string						name;
+					std::string						code;	///< The VCD identifier code.
+					std::StateBitset<bit_width>		last;	///< The last recorded state.
+
+					Channel(SynchrotronVCD *owner, Component *component, const std::string& name, const std::string& code)
+						: owner(owner), component(component), name(name), code(code), last(component->getNativeState()) {}
+
+					void sample(const Component& source) {
+						if (this->changed(source))
+							this->owner->record(*this, this->owner->now ? this->owner->now() : 0);
+					}
+
+					void sample(const Component& source, unsigned long long time) {
+						if (this->changed(source))
+							this->owner->record(*this, time);
+					}
+
+					/**	\brief	Whether the state of source differs from the last recorded one (then it becomes the last).
+					 */
+					bool changed(const Component& source) {
+						if (source.getNativeState() == this->last) return false;
+
+						// The header lists the values before this first change.
+						if (!this->owner->started) this->owner->start();
+						this->last = source.getNativeState();
+						return true;
+					}
+			};
+
+			/**	\brief	One recorded change.
+			 */
+			struct Change {
+				unsigned long long				time;
+				const Channel					*channel;
+				std::StateBitset<bit_width>		value;
+			};
+
+			std::string								filename;
+			std::ofstream							file;
+			std::string								timescale;
+			std::vector<std::unique_ptr<Channel>>	channels;
+
+			/**	\brief	Returns the simulated time (0 without setClock()).
+			 */
+			std::function<unsigned long long()>		now;
+
+			/**	\brief	The buffer being filled by the simulation and the one being written.
+			 */
+			std::vector<Change>		pending, writing;
+			size_t					capacity;
+			size_t					changes;
+			lock_policy				pendingLock;
+
+			std::thread				writer;
+			std::mutex				mutex;
+			std::condition_variable	wake, done;
+			bool					busy, stopping, started;
+
+			/**	\brief	The time of the last written timestamp (writer thread only).
+			 */
+			unsigned long long		written;
+
+			/**	\brief	The latest time recorded so far (guarded by pendingLock).
+			 */
+			unsigned long long		latest;
+
+			/**	\brief	Append a change of channel at time (called from its Probe).
+			 *
+			 *		Timestamps never go back: a change after one stamped later (e.g. a falling clock edge,
+			 *		half a period ahead) gets that later time.
+			 */
+			void record(const Channel& channel, unsigned long long time) {
+				LockBlock<lock_policy> lock(&this->pendingLock);
+				if (time < this->latest) time = this->latest;
+				this->latest = time;
+				this->pending.push_back(Change{ time, &channel, channel.last });
+				++this->changes;
+
+				if (this->pending.size() >= this->capacity)
+					this->handOff();
+			}
+
+			/**	\brief	Give the pending buffer to the writer thread (waits until it finished the previous one).
+			 */
+			void handOff(void) {
+				std::unique_lock<std::mutex> lock(this->mutex);
+				this->done.wait(lock, [this]() { return !this->busy; });
+
+				std::swap(this->pending, this->writing);
+				this->busy = true;
+				this->wake.notify_one();
+			}
+
+			/**	\brief	Wait until the writer thread finished its buffer.
+			 */
+			void drain(void) {
+				std::unique_lock<std::mutex> lock(this->mutex);
+				this->done.wait(lock, [this]() { return !this->busy; });
+			}
+
+			/**	\brief	The loop of the writer thread.
+			 */
+			void loop(void) {
+				std::unique_lock<std::mutex> lock(this->mutex);
+
+				while (true) {
+					this->wake.wait(lock, [this]() { return this->busy || this->stopping; });
+					if (!this->busy) return;
+
+					lock.unlock();
+					for (auto& change : this->writing) {
+						if (change.time != this->written) {
+							this->file << '#' << change.time << '\n';
+							this->written = change.time;
+						}
+						this->writeValue(change.value, change.channel->code);
+					}
+					this->writing.clear();
+					lock.lock();
+
+					this->busy = false;
+					this->done.notify_all();
+				}
+			}
+
+			/**	\brief	Write one value change: `0!` for 1-bit signals, `b101 !` otherwise (without leading zeros).
+			 */
+			void writeValue(const std::StateBitset<bit_width>& value, const std::string& code) {
+				char line[bit_width + 2];
+				size_t length = 0;
+
+				if (bit_width > 1) line[length++] = 'b';
+
+				size_t bit = bit_width - 1;
+				while (bit > 0 && !value.test(bit)) --bit;
+				for (size_t i = bit + 1; i-- > 0;)
+					line[length++] = value.test(i) ? '1' : '0';
+
+				if (bit_width > 1) line[length++] = ' ';
+
+				this->file.write(line, length);
+				this->file << code << '\n';
+			}
+
+			/**	\brief	Returns the VCD identifier code of signal i (base 94 over the printable characters).
+			 */
+			static std::string identifier(size_t i) {
+				std::string code;
+
+				do {
+					code += char('!' + i % 94);
+					i /= 94;
+				} while (i);
+
+				return code;
+			}
+
+		public:
+			/**	\brief	Default constructor
+			 *
+			 *	\param	filename
+			 *		The VCD file to write (truncated).
+			 *	\param	buffered
+			 *		The amount of changes per buffer handed to the writer thread.
+			 *	\param	timescale
+			 *		The unit of the timestamps (Clock::getSimulatedTime() is in nanoseconds).
+			 *
+			 *	\exception	Exceptions::FileWriteException
+			 *		Throws exception if the file cannot be opened.
+			 */
+			explicit SynchrotronVCD(const std::string& filename, size_t buffered = 4096, const std::string& timescale = "1 ns")
+				: filename(filename), file(filename, std::ios::out | std::ios::trunc), timescale(timescale)
+				, capacity(buffered ? buffered : 1), changes(0), busy(false), stopping(false), started(false), written(0), latest(0)
+			{
+				if (!this->file)
+					throw Exceptions::FileWriteException(filename);
+
+				this->pending.reserve(this->capacity);
+				this->writing.reserve(this->capacity);
+			}
+
+			SynchrotronVCD(const SynchrotronVCD&) = delete;
+			SynchrotronVCD& operator=(const SynchrotronVCD&) = delete;
+
+			/**	\brief	Default destructor: writes the remaining changes and detaches every probe.
+			 */
+			~SynchrotronVCD() {
+				try {
+					this->close();
+				} catch (...) {}
+			}
+
+			/**	\brief	Timestamp every change with the simulated time of clock (e.g. a CPUComponents::Clock).
+			 *
+			 *	\param	clock
+			 *		Any object with `getSimulatedTime()`; it must outlive this writer.
+			 */
+			template <class TimeSource>
+			void setClock(const TimeSource& clock) {
+				this->now = [&clock]() { return (unsigned long long) clock.getSimulatedTime(); };
+			}
+
+			/**	\brief	Probe component as a signal named name.
+			 *
+			 *	\exception	Exceptions::Exception
+			 *		Throws exception if recording already started or component already has a Probe.
+			 */
+			void add(Component& component, const std::string& name) {
+				if (this->started)
+					throw Exceptions::Exception("[ERROR] Cannot add VCD signal \"" + name + "\" after recording started!");
+				if (component.getProbe() != nullptr)
+					throw Exceptions::Exception("[ERROR] Component for VCD signal \"" + name + "\" already has a probe!");
+
+				std::string clean(name.empty() ? "signal" : name);
+				for (auto& c : clean)
+					if (c == ' ' || c == '\t' || c == '\n') c = '_';
+
+				this->channels.emplace_back(new Channel(this, &component, clean, identifier(this->channels.size())));
+				component.setProbe(this->channels.back().get());
+			}
+
+			/**	\brief	Stop probing component (its signal keeps its last value in the file).
+			 */
+			void remove(Component& component) {
+				for (auto& channel : this->channels)
+					if (channel->component == &component && component.getProbe() == channel.get()) {
+						component.setProbe(nullptr);
+						channel->component = nullptr;
+					}
+			}
+
+			/**	\brief	Write the header and the current values, and start the writer thread.
+			 *
+			 *		Called automatically on the first change. The current values are the initial ones,
+			 *		so they are stamped #0, whatever the simulated time of that change.
+			 */
+			void start(void) {
+				if (this->started) return;
+				this->started = true;
+
+				this->written = 0;
+				this->file << "$version ScottyCPU Synchrotron $end\n"
+						   << "$timescale " << this->timescale << " $end\n"
+						   << "$scope module synchrotron $end\n";
+				for (auto& channel : this->channels)
+					this->file << "$var wire " << bit_width << ' ' << channel->code << ' ' << channel->name << " $end\n";
+				this->file << "$upscope $end\n"
+						   << "$enddefinitions $end\n"
+						   << '#' << this->written << '\n'
+						   << "$dumpvars\n";
+				for (auto& channel : this->channels)
+					this->writeValue(channel->last, channel->code);
+				this->file << "$end\n";
+
+				this->writer = std::thread(&SynchrotronVCD::loop, this);
+			}
+
+			/**	\brief	Write every recorded change to the file (waits for the writer thread).
+			 */
+			void flush(void) {
+				if (!this->started) this->start();
+
+				{
+					LockBlock<lock_policy> lock(&this->pendingLock);
+					if (!this->pending.empty())
+						this->handOff();
+				}
+				this->drain();
+				this->file.flush();
+			}
+
+			/**	\brief	Flush, stop the writer thread, detach every probe and close the file.
+			 *
+			 *		Changes after close() are not recorded.
+			 */
+			void close(void) {
+				if (!this->file.is_open()) return;
+
+				for (auto& channel : this->channels)
+					if (channel->component && channel->component->getProbe() == channel.get())
+						channel->component->setProbe(nullptr);
+
+				this->flush();
+				{
+					std::lock_guard<std::mutex> lock(this->mutex);
+					this->stopping = true;
+				}
+				this->wake.notify_one();
+				this->writer.join();
+
+				this->file.close();
+				if (this->file.fail())
+					throw Exceptions::FileWriteException(this->filename);
+			}
+
+			/**	\brief	Returns the amount of signals.
+			 */
+			inline size_t getSignalCount(void) const {
+				return this->channels.size();
+			}
+
+			/**	\brief	Returns the amount of changes recorded so far.
+			 */
+			inline size_t getChangeCount(void) const {
+				return this->changes;
+			}
+	};
+}
+
+#endif // SYNCHROTRONVCD_HPP
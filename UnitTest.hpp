@@ -9,12 +9,30 @@
 #include <iostream>
 #include <cassert>	// Debug assertion
 #include <bitset>
+#include <thread>
+#include <fstream>
+#include <map>
+#include <random>
 #include "SignedBitset.hpp"
 #include "FloatingBitset.hpp"
+#include "NativeBitset.hpp"
 #include "Exceptions.hpp"
 #include "utils.hpp"
 
 #include "SynchrotronComponent.hpp"
+#include "SynchrotronNetlist.hpp"
+#include "SynchrotronScheduler.hpp"
+#include "SynchrotronTiming.hpp"
+#include "SynchrotronParallel.hpp"
+#include "SynchrotronFixpoint.hpp"
+#include "SynchrotronStatistics.hpp"
+#include "SynchrotronGraph.hpp"
+#include "SynchrotronBuilder.hpp"
+#include "SynchrotronSubcircuit.hpp"
+#include "SynchrotronSnapshot.hpp"
+#include "SynchrotronVCD.hpp"
+#include "SynchrotronComponentEnable.hpp"
+#include "ScottyCPU.hpp"
 
 #include "CPUComponents/ANDGate.hpp"
 #include "CPUComponents/NANDGate.hpp"
@@ -54,6 +72,11 @@
 
 #include "CPUFactory/SCAMParser.hpp"
 #include "CPUFactory/SCAMAssembler.hpp"
+#include "CPUFactory/BitSliceSimulator.hpp"
+#include "CPUFactory/LogicGraph.hpp"
+#include "CPUFactory/CodeGenerator.hpp"
+#include "CPUFactory/NetlistFile.hpp"
+#include "CPUFactory/TimingAnalysis.hpp"
 
 
 /**	\brief	Boolean used to check if statement threw an exception.
@@ -241,6 +264,50 @@ void testFloatingBitset(void) {
 }
 
 
+/**	\brief	Test NativeBitset class (native state for bit_width <= 64)
+ */
+void testNativeBitset(void) {
+	NativeBitset<4>		n_5(for_bit_5.to_ullong()),
+						n_trunc(0xF5),
+						n_from(for_bit_7);
+
+	assert(sizeof(NativeBitset<4>)				== sizeof(uint8_t));
+	assert(sizeof(NativeBitset<33>)				== sizeof(uint64_t));
+
+	assert(n_5									== for_bit_5);
+	assert(for_bit_5							== n_5);
+	assert(n_trunc								== for_bit_5);	// Truncated as std::bitset
+	assert(n_from.to_ullong()					== 7);
+	assert(std::bitset<4>(n_from)				== for_bit_7);
+	assert((~n_5)								== std::bitset<4>(~for_bit_5));
+	assert((n_5 << 1)							== (for_bit_5 << 1));
+	assert((n_5 << 4).none());
+	assert((n_5 >> 2)							== (for_bit_5 >> 2));
+	assert((n_5 & n_from)						== (for_bit_5 & for_bit_7));
+	assert((n_5 | NativeBitset<4>(for_bit_8))	== (for_bit_5 | for_bit_8));
+	assert((n_5 ^ n_from)						== (for_bit_5 ^ for_bit_7));
+	assert(n_5.count()							== 2);
+	assert(n_5.test(0) && !n_5[1]);
+	assert(NativeBitset<4>().set().all());
+	assert(NativeBitset<4>().set(3)				== for_bit_8);
+	assert(NativeBitset<4>(for_bit_8).set(3, false).none());
+	assert(n_5.to_string()						== for_bit_5.to_string());
+
+	NativeBitset<64> n_64;
+	n_64.set();
+	assert(n_64.to_ullong()						== ~0ull);
+	assert(n_64.count()							== 64);
+	assert((n_64 >> 63).to_ullong()				== 1);
+
+	// Wide components keep a std::bitset.
+	static_assert(std::is_same<StateBitset<4>,   NativeBitset<4>>::value,	"StateBitset<4> should be native.");
+	static_assert(std::is_same<StateBitset<128>, std::bitset<128>>::value,	"StateBitset<128> should be std::bitset.");
+
+	SynchrotronComponent<4>	s(for_bit_5.to_ulong());
+	assert(s.getNativeState()					== n_5);
+	assert(s.getState()							== for_bit_5);
+}
+
 /**	\brief
  *	SynchrotronComponent : Test SynchrotronComponent class.
  */
@@ -341,6 +408,1530 @@ void testSynchrotronComponent(void) {
 	delete s_pointed;
 }
 
+/**	\brief
+ *	Lock policies : Test components and Memory with every lock policy.
+ */
+void testLockPolicy(void) {
+	SynchrotronComponent<4, NullLock>	s_null(for_bit_5.to_ulong()),	r_null;
+	SynchrotronComponent<4, SpinLock>	s_spin(for_bit_5.to_ulong()),	r_spin;
+	SynchrotronComponent<4, MutexLock>	s_mutex(for_bit_5.to_ulong()),	r_mutex;
+
+	r_null.addInput(s_null);
+	r_spin.addInput(s_spin);
+	r_mutex.addInput(s_mutex);
+	s_null.emit();
+	s_spin.emit();
+	s_mutex.emit();
+	assert(r_null.getState()					== for_bit_5);
+	assert(r_spin.getState()					== for_bit_5);
+	assert(r_mutex.getState()					== for_bit_5);
+
+	// The default build carries no synchronization cost.
+	assert(sizeof(SynchrotronComponent<4, NullLock>)	<  sizeof(SynchrotronComponent<4, MutexLock>));
+	assert(sizeof(SynchrotronComponent<4>)				== sizeof(SynchrotronComponent<4, SYNCHROTRON_LOCK_POLICY>));
+
+	SynchrotronComponentFixedInput<4, 1u, SpinLock> f_spin;
+	f_spin.addInput(s_spin);
+	assert_error(f_spin.addInput(r_spin), Exceptions::Exception);
+	assert(f_spin.getInputs().size()			== 1);
+
+	Memory<4, 8, MutexLock>	m_mutex;
+	Memory<4, 8, SpinLock>	m_spin;
+	m_mutex.setData(for_bit_1, for_bit_7);
+	m_spin.setData(for_bit_1, for_bit_7);
+	assert(m_mutex.getData(for_bit_1)			== for_bit_7);
+	assert(m_spin.getData(for_bit_1)			== for_bit_7);
+}
+
+/**	\brief
+ *	SynchrotronNetlist : Test levelized evaluation.
+ */
+void testSynchrotronNetlist(void) {
+	// flow: src -> {a, b} -> c -> d
+	MemoryCell<4>			src;
+	SynchrotronComponent<4>	a( {&src} ),
+							b( {&src} ),
+							c( {&a, &b} ),
+							d( {&c} );
+
+	{
+		SynchrotronNetlist<4> netlist( {&d} );
+
+		assert(netlist.size()					== 5);
+		assert(netlist.getLevelCount()			== 4);
+		assert(netlist.getLevel(src)			== 0);
+		assert(netlist.getLevel(a)				== 1);
+		assert(netlist.getLevel(b)				== 1);
+		assert(netlist.getLevel(c)				== 2);
+		assert(netlist.getLevel(d)				== 3);
+		assert(src.getPropagator()				== &netlist);
+
+		src.setState(for_bit_1);	// Every component is tick()ed once, c is not revisited through b
+		assert(netlist.getEvaluationCount()		== 4);
+		assert(c.getState()						== for_bit_1);
+		assert(d.getState()						== for_bit_1);
+
+		netlist.resetEvaluationCount();
+		src.setState(for_bit_2);
+		assert(netlist.getEvaluationCount()		== 4);
+		assert(d.getState()						== for_bit_3);	// ORed: 0x1 | 0x2
+
+		netlist.resetEvaluationCount();
+		netlist.evaluate();
+		assert(netlist.getEvaluationCount()		== 4);
+		assert(d.getState()						== for_bit_3);
+	}	// netlist destructed => components revert to recursive emit()
+
+	assert(src.getPropagator()					== nullptr);
+	assert(d.getPropagator()					== nullptr);
+
+	// Gate network must give the same result as recursive evaluation.
+	MemoryCell<2>	x, y;
+	ANDGate<2>		and_2( {&x, &y} );
+	ORGate<2>		or_2( {&x, &y} );
+	XORGate<2>		xor_2( {&and_2, &or_2} );
+	NOTGate<2>		not_2( {&xor_2} );
+
+	x.setState(two_bit_1);
+	y.setState(two_bit_3);
+	std::bitset<2> recursive = not_2.getState();
+
+	x.setState(two_bit_0);
+	y.setState(two_bit_0);
+	{
+		SynchrotronNetlist<2> netlist( {&x} );
+
+		assert(netlist.getLevelCount()			== 4);
+		x.setState(two_bit_1);
+		y.setState(two_bit_3);
+		assert(not_2.getState()					== recursive);
+		assert(not_2.getState()					== two_bit_1);	// ~((01 & 11) ^ (01 | 11))
+	}
+
+	// Combinational loops cannot be levelized.
+	SynchrotronComponent<1>	loop_1, loop_2;
+	loop_1.addInput(loop_2);
+	loop_2.addInput(loop_1);
+
+	SynchrotronNetlist<1> loop_netlist;
+	assert_error(loop_netlist.compile( {&loop_1} ), Exceptions::Exception);
+	assert(loop_netlist.size()					== 0);
+	assert(loop_1.getPropagator()				== nullptr);
+}
+
+/**	\brief
+ *	SynchrotronScheduler : Test iterative event-queue propagation.
+ */
+void testSynchrotronScheduler(void) {
+	// flow: src -> {a, b} -> c
+	MemoryCell<4>			src;
+	SynchrotronComponent<4>	a( {&src} ),
+							b( {&src} ),
+							c( {&a, &b} );
+
+	{
+		SynchrotronScheduler<4> scheduler( {&src} );
+
+		assert(scheduler.size()					== 4);
+		assert(c.getPropagator()				== &scheduler);
+
+		src.setState(for_bit_5);	// wave 1: {a, b}, wave 2: {c} (queued once)
+		assert(scheduler.getWaveCount()			== 2);
+		assert(scheduler.getTickCount()			== 3);
+		assert(scheduler.getPeakWaveSize()		== 2);
+		assert(scheduler.getEmitCount()			== 4);	// src, a, b, c
+		assert(c.getState()						== for_bit_5);
+	}
+
+	assert(c.getPropagator()					== nullptr);
+
+	// A chain this long would overflow the stack with recursive emit()s.
+	const size_t chain_length = 50000;
+	std::vector<SynchrotronComponent<1>*> chain;
+	MemoryCell<1> head;
+
+	chain.push_back(&head);
+	for (size_t i = 0; i < chain_length; ++i)
+		chain.push_back(new SynchrotronComponent<1>( {chain.back()} ));
+
+	{
+		SynchrotronScheduler<1> scheduler( {&head} );
+
+		head.setState(one_bit_1);
+		assert(scheduler.getTickCount()			== chain_length);
+		assert(scheduler.getWaveCount()			== chain_length);
+		assert(chain.back()->getState()			== one_bit_1);
+	}
+
+	for (size_t i = chain_length; i > 0; --i)
+		delete chain[i];
+
+	// Two-phase waves: g = AND(s, NOT(s)) glitches to 1 for one delta cycle when s rises,
+	// whether or not the NOT happens to be ticked before the AND (a sticky probe records the glitch).
+	auto glitches = [](bool twoPhase, bool notFirst) {
+		MemoryCell<1>	s;
+		NOTGate<1>		*n = notFirst ? new NOTGate<1>(one_bit_1.to_ulong()) : nullptr;
+		ANDGate<1>		*g = new ANDGate<1>();
+		if (!n) n = new NOTGate<1>(one_bit_1.to_ulong());
+		n->addInput(s);
+		g->addInput( {&s, n} );
+		SynchrotronComponent<1> probe( {g} );
+		bool seen;
+		{
+			SynchrotronScheduler<1> scheduler( {&s} );
+			scheduler.setTwoPhase(twoPhase);
+			assert(scheduler.isTwoPhase()		== twoPhase);
+
+			s.setState(one_bit_1);
+			assert(g->getState()				== one_bit_0);
+			seen = probe.getState().test(0);
+		}
+		delete g;
+		delete n;
+		return seen;
+	};
+
+	assert(!glitches(false, true));		// In place: depends on the order of the ids
+	assert( glitches(false, false));
+	assert( glitches(true,  true));		// Two-phase: order-independent
+	assert( glitches(true,  false));
+
+	// evaluateNext() leaves the visible state alone until commit().
+	MemoryCell<4>	cell(for_bit_5.to_ulong());
+	NOTGate<4>		inverter( {&cell} );
+	auto next = inverter.evaluateNext();
+	assert(inverter.getState()					== for_bit_0);
+	assert(next									== for_bit_A);
+	inverter.commit(next);
+	assert(inverter.getState()					== for_bit_A);
+}
+
+/**	\brief
+ *	TimingWheel : Test that events come out in time order, across every level of the wheel.
+ */
+void testTimingWheel(void) {
+	TimingWheel<size_t> wheel;
+	std::vector<size_t> due;
+
+	assert(!wheel.pop(due));
+
+	// Spread over all levels, with duplicate times (popped in scheduling order).
+	const SimTime times[] = { 5, 300, 5, 70000, 1ULL << 40, 255, 256, 70000, 0, ~0ULL, 1ULL << 63, 65536 };
+	std::vector<std::pair<SimTime, size_t>> expected;
+	for (size_t i = 0; i < sizeof(times) / sizeof(times[0]); ++i) {
+		wheel.schedule(times[i], i);
+		expected.push_back(std::make_pair(times[i], i));
+	}
+	std::stable_sort(expected.begin(), expected.end(),
+		[](const std::pair<SimTime, size_t>& a, const std::pair<SimTime, size_t>& b) { return a.first < b.first; });
+	assert(wheel.size()								== expected.size());
+
+	// Only the event at 0 lies up to 4, then nothing: now() stays.
+	assert(wheel.pop(due, 4));
+	assert(due.size() == 1 && due[0]				== 8);
+	due.clear();
+	assert(!wheel.pop(due, 4));
+	assert(wheel.now()								== 0);
+
+	std::vector<std::pair<SimTime, size_t>> popped( 1, std::make_pair(SimTime(0), size_t(8)) );
+	while (wheel.pop(due)) {
+		for (auto value : due)
+			popped.push_back(std::make_pair(wheel.now(), value));
+		due.clear();
+
+		// Scheduling at now() and later keeps working while popping.
+		if (popped.size() == 3) {
+			wheel.schedule(wheel.now(), 100);
+			wheel.schedule(wheel.now() + 1, 101);
+			expected.insert(expected.begin() + 3, std::make_pair(expected[2].first, size_t(100)));
+			expected.insert(expected.begin() + 4, std::make_pair(expected[2].first + 1, size_t(101)));
+		}
+	}
+	assert(wheel.empty());
+	assert(popped									== expected);
+	#ifdef THROW_EXCEPTIONS
+		assert_error(wheel.schedule(0, 0), Exceptions::Exception);
+	#endif
+
+	// A limit inside a higher-level slot that starts before it, but whose events all lie after it:
+	// now() stays, so events up to the limit can still be scheduled and popped.
+	TimingWheel<size_t> ahead;
+	ahead.schedule(70000, 1);							// Level 2, slot 1 starts at 65536
+	assert(!ahead.pop(due, 66000));
+	assert(ahead.now()								== 0);
+	ahead.schedule(36668, 2);
+	assert(ahead.pop(due, 66000));
+	assert(ahead.now() == 36668 && due.size() == 1 && due[0] == 2);
+	due.clear();
+	assert(!ahead.pop(due, 66000));
+	assert(ahead.now()								== 36668);
+	assert(ahead.pop(due));
+	assert(ahead.now() == 70000 && due[0]			== 1);
+	due.clear();
+
+	// Against an ordered multimap, with random times and limits.
+	TimingWheel<size_t> wheel2;
+	std::multimap<SimTime, size_t> reference;
+	std::mt19937_64 random(7);
+	for (size_t step = 0; step < 20000; ++step) {
+		const SimTime now = wheel2.now();
+		if (random() % 3) {
+			const SimTime time = now + random() % (SimTime(1) << (random() % 24));
+			wheel2.schedule(time, step);
+			reference.emplace(time, step);
+			continue;
+		}
+
+		const SimTime limit = now + random() % (SimTime(1) << (random() % 24));
+		const bool popped = wheel2.pop(due, limit);
+		assert(popped == (!reference.empty() && reference.begin()->first <= limit));
+		if (!popped) {
+			assert(wheel2.now()							== now);
+			continue;
+		}
+
+		// Every event of the earliest time, in any order.
+		const SimTime time = reference.begin()->first;
+		std::vector<size_t> expectedValues;
+		for (auto it = reference.begin(); it != reference.end() && it->first == time; it = reference.erase(it))
+			expectedValues.push_back(it->second);
+		std::sort(due.begin(), due.end());
+		assert(wheel2.now()								== time);
+		assert(due										== expectedValues);
+		due.clear();
+	}
+}
+
+/**	\brief
+ *	SynchrotronTiming : Test transport delays, glitches and settling time on a timing wheel.
+ */
+void testSynchrotronTiming(void) {
+	// x = XOR(a, NOT a) is always 1, but the slower NOT lets it glitch to 0 on every change of a.
+	MemoryCell<1>	a;
+	NOTGate<1>		n( {&a} );
+	XORGate<1>		x( {&a, &n} );
+	n.tick(); x.tick();
+	SynchrotronComponent<1> sticky( {&x} );	// ORs every state of x into its own, without delay
+
+	DelayTable table;
+	table.set<NOTGate<1>>(2000).set<XORGate<1>>(1000).set<SynchrotronComponent<1>>(0);
+	assert(table.get(n)								== 2000);
+	assert(table.get(a)								== table.getDefault());
+
+	{
+		SynchrotronTiming<1> timing( {&a}, table );
+		assert(timing.size()						== 4);
+		assert(timing.getDelay(x)					== 1000);
+		assert(x.getPropagator()					== &timing);
+
+		// t = 1000: x falls, t = 2000: n falls, t = 3000: x rises again.
+		a.setState(one_bit_1);
+		assert(x.getState()							== one_bit_1);
+		assert(n.getState()							== one_bit_0);
+		assert(timing.getTime()						== 3000);
+		assert(timing.getSettleTime()				== 3000);
+		assert(timing.getChangeCount()				== 4);	// x, n, x, sticky (only once, when x rose)
+		assert(timing.getGlitchCount()				== 1);
+		assert(timing.getPendingCount()				== 0);
+
+		Clock<1> fast(500e6F), slow(250e6F);		// 2 ns and 4 ns
+		assert(!timing.settlesWithin(fast));
+		assert( timing.settlesWithin(slow));
+
+		// Step by step: the glitch is visible in between.
+		timing.setAutoSettle(false);
+		timing.resetStatistics();
+		a.setState(one_bit_0);
+		assert(x.getState()							== one_bit_1);
+		assert(!timing.runUntil(timing.getTime() + 1500));
+		assert(x.getState()							== one_bit_0);
+		assert(timing.getPendingCount()				== 1);	// n
+		assert(!timing.settlesWithin(slow));
+		assert(timing.settle()						== 3000);
+		assert(x.getState()							== one_bit_1);
+		assert(timing.getGlitchCount()				== 1);
+		assert_error(timing.runUntil(0), Exceptions::Exception);
+	}
+
+	assert(x.getPropagator()						== nullptr);
+	assert(sticky.getState()						== one_bit_1);
+
+	// A long chain: one event per gate, no recursion.
+	const size_t chain_length = 50000;
+	std::vector<SynchrotronComponent<1>*> chain;
+	MemoryCell<1> head;
+
+	chain.push_back(&head);
+	for (size_t i = 0; i < chain_length; ++i)
+		chain.push_back(new NOTGate<1>( {chain.back()} ));
+	for (size_t i = 1; i <= chain_length; ++i)
+		chain[i]->tick();
+
+	{
+		SynchrotronTiming<1> timing( {&head}, DelayTable(7) );
+
+		head.setState(one_bit_1);
+		assert(timing.getEventCount()				== chain_length);
+		assert(timing.getSettleTime()				== 7 * chain_length);
+		assert(chain.back()->getState()				== (chain_length % 2 ? one_bit_0 : one_bit_1));
+	}
+
+	for (size_t i = chain_length; i > 0; --i)
+		delete chain[i];
+}
+
+/**	\brief
+ *	SynchrotronParallelNetlist : Test level-parallel evaluation on a work-stealing pool.
+ */
+void testSynchrotronParallelNetlist(void) {
+	WorkStealingPool pool(3);
+	std::vector<std::atomic<size_t>> hits(1000);
+
+	assert(pool.getWorkerCount()				== 4);
+	pool.run(0, hits.size(), 7, [&](size_t b, size_t e) { for (; b < e; ++b) ++hits[b]; });
+	for (auto& hit : hits)
+		assert(hit								== 1);
+	assert_error(pool.run(0, 100, 1, [](size_t b, size_t) { if (b == 50) throw Exceptions::Exception("worker"); }),
+				 Exceptions::Exception);
+
+	// flow: 256 cells -> 128 AND -> 64 AND -> ... -> 1 AND, plus a NOT of every cell
+	std::vector<MemoryCell<4>*> cells;
+	std::vector<SynchrotronComponent<4>*> gates, layer, inverted;
+
+	for (size_t i = 0; i < 256; ++i) {
+		cells.push_back(new MemoryCell<4>(for_bit_F.to_ulong()));
+		layer.push_back(cells.back());
+		inverted.push_back(new NOTGate<4>( {cells.back()} ));
+	}
+
+	while (layer.size() > 1) {
+		std::vector<SynchrotronComponent<4>*> next;
+		for (size_t i = 0; i < layer.size(); i += 2) {
+			gates.push_back(new ANDGate<4>( {layer[i], layer[i + 1]} ));
+			next.push_back(gates.back());
+		}
+		layer.swap(next);
+	}
+
+	SynchrotronComponent<4> *root = layer.front();
+	{
+		SynchrotronParallelNetlist<4> parallel(1, 3);
+		parallel.compile( {root} );
+
+		assert(parallel.size()					== 256 * 2 + 255);
+		assert(parallel.getLevelCount()			== 9);
+		assert(parallel.getWorkerCount()		== 4);
+
+		parallel.evaluate();
+		assert(root->getState()					== for_bit_F);
+		assert(inverted[17]->getState()			== for_bit_0);
+		assert(parallel.getParallelLevelCount()	>= 1);
+
+		parallel.resetStatistics();
+		cells[200]->setState(for_bit_5);
+		assert(root->getState()					== for_bit_5);
+		assert(inverted[200]->getState()		== for_bit_A);
+		assert(parallel.getEvaluationCount()	== 9);	// One NOT and one AND per level
+
+		// Above the threshold every level stays on the calling thread.
+		parallel.setThreshold(100000);
+		parallel.resetStatistics();
+		parallel.evaluate();
+		assert(parallel.getParallelLevelCount()	== 0);
+		assert(parallel.getSerialLevelCount()	== 8);
+		assert(root->getState()					== for_bit_5);
+	}
+
+	for (auto it = gates.rbegin(); it != gates.rend(); ++it)
+		delete *it;
+	for (auto gate : inverted)
+		delete gate;
+	for (auto cell : cells)
+		delete cell;
+}
+
+/**	\brief
+ *	SynchrotronFixpointNetlist : Test loop detection and fixpoint iteration (NOR latch, NOT ring).
+ */
+void testSynchrotronFixpointNetlist(void) {
+	// SR latch: q = NOR(r, q_n), q_n = NOR(s, q)
+	MemoryCell<1>	set, reset;
+	NORGate<1>		q, q_n;
+	q.addInput( {&reset, &q_n} );
+	q_n.addInput( {&set, &q} );
+	NOTGate<1>		out( {&q} );
+
+	auto loops = findLoops<1>( {&set} );
+	assert(loops.size()							== 1);
+	assert(loops.front().size()					== 2);
+	assert(stronglyConnected<1>(std::vector<SynchrotronComponent<1>*>{ &out }).size() == 4);
+
+	{
+		SynchrotronFixpointNetlist<1> netlist(16);
+		netlist.compile( {&out} );
+		assert(netlist.size()					== 5);
+		assert(netlist.getLoopCount()			== 1);
+
+		netlist.evaluate();
+		assert(q.getState()						!= q_n.getState());
+		assert(netlist.getOscillations().empty());
+
+		set.setState(one_bit_1);
+		set.setState(one_bit_0);
+		assert(q.getState()						== one_bit_1);	// Latched
+		assert(q_n.getState()					== one_bit_0);
+		assert(out.getState()					== one_bit_0);
+
+		reset.setState(one_bit_1);
+		reset.setState(one_bit_0);
+		assert(q.getState()						== one_bit_0);
+		assert(q_n.getState()					== one_bit_1);
+		assert(out.getState()					== one_bit_1);
+		assert(netlist.getOscillations().empty());
+	}
+
+	// A ring of 3 NOT gates never settles.
+	NOTGate<1>	ring_1, ring_2( {&ring_1} ), ring_3( {&ring_2} );
+	ring_1.addInput(ring_3);
+	{
+		SynchrotronFixpointNetlist<1> netlist(10);
+		netlist.compile( {&ring_1} );
+		netlist.evaluate();
+
+		assert(netlist.getOscillations().size()	== 1);
+		assert(netlist.getOscillations().front().loop.size()	== 3);
+		assert(netlist.getOscillations().front().iterations		== 10);
+
+		netlist.clearOscillations();
+		netlist.setThrowOnOscillation(true);
+		assert_error(netlist.evaluate(), Exceptions::Exception);
+		assert(netlist.getOscillations().size()	== 1);
+	}
+
+	// A component that is its own input is a loop too.
+	SynchrotronComponent<1> self(one_bit_1.to_ulong());
+	self.addInput(self);
+	assert(findLoops<1>( {&self} ).size()		== 1);
+}
+
+/**	\brief
+ *	SynchrotronActivityReport : Test the activity counters (only counted with SYNCHROTRON_STATISTICS).
+ */
+void testSynchrotronActivityReport(void) {
+	MemoryCell<4>	src, mask(for_bit_F.to_ulong());
+	ANDGate<4>		and_1( {&src, &mask} ),
+					and_2( {&src, &mask} );
+	NOTGate<4>		not_1( {&and_1} );
+
+	resetActivity<4>(std::vector<SynchrotronComponent<4>*>{ &src });
+	src.setState(for_bit_5);	// and_1, and_2: 0000 -> 0101, not_1: 0000 -> 1010
+	src.setState(for_bit_5);	// No change, no emit
+
+	SynchrotronActivityReport<4> report( {&src} );
+	assert(report.getNodes().size()				== 5);
+	assert(report.getTypes().size()				== 3);
+
+	#ifdef SYNCHROTRON_STATISTICS
+		assert(and_1.getActivity().ticks		== 1);
+		assert(and_1.getActivity().changes		== 1);
+		assert(and_1.getActivity().toggles		== 2);
+		assert(not_1.getActivity().toggles		== 2);
+		assert(src.getActivity().emits			== 1);
+		assert(report.getTotal().ticks			== 3);
+		assert(report.getTotal().emits			== 4);
+		assert(report.getTypes().front().type	== std::type2name(and_1));
+		assert(report.getTypes().front().components	== 2);
+		assert(report.getTypes().front().activity.ticks	== 2);
+	#else
+		assert(report.getTotal().ticks			== 0);
+		assert(and_1.getActivity().emits		== 0);
+	#endif
+
+	// The table of types and the hottest components, by their creation order.
+	std::stringstream printed;
+	report.print(printed, 2);
+	const std::string table = printed.str();
+	assert(table.find("Type")					!= std::string::npos);
+	assert(table.find(std::type2name(not_1))	!= std::string::npos);
+	assert(table.find("Hottest components:")	!= std::string::npos);
+	assert(table.find("#" + std::to_string(report.getNodes().front().component->getOrder())) != std::string::npos);
+}
+
+/**	\brief
+ *	SynchrotronGraph : Test arena allocation, evaluation and teardown with connections leaving the graph.
+ */
+void testSynchrotronGraph(void) {
+	MemoryCell<4>			outside_in(for_bit_5.to_ulong());
+	SynchrotronComponent<4>	outside_out;
+
+	{
+		SynchrotronGraph<4> graph(256);	// Small blocks, so the graph spans several
+		MemoryCell<4>	*a	  = graph.create<MemoryCell<4>>(for_bit_3.to_ulong());
+		ANDGate<4>		*gate = graph.create<ANDGate<4>>( {a, &outside_in} );
+		SynchrotronComponent<4> *last = gate;
+
+		for (size_t i = 0; i < 20; ++i)
+			last = graph.create<NOTGate<4>>( {last} );
+		outside_out.addInput(*last);
+
+		assert(graph.size()							== 22);
+		assert(graph.getReservedBytes()				>= 2 * 256);
+		assert(&graph[1]							== gate);
+		assert(graph.getComponents().back()			== last);
+
+		a->setState(for_bit_7);						// 7 & 5 = 5, through an even amount of NOTs
+		assert(gate->getState()						== for_bit_5);
+		assert(last->getState()						== for_bit_5);
+		assert(outside_out.getState()				== for_bit_5);
+		assert(outside_in.getOutputs().size()		== 1);
+	}
+
+	// The components outside the graph were disconnected.
+	assert(outside_in.getOutputs().empty());
+	assert(outside_out.getInputs().empty());
+
+	SynchrotronGraph<4> reused;
+	reused.create<ANDGate<4>>( {&outside_in, reused.create<MemoryCell<4>>()} );
+	reused.clear();
+	assert(reused.size()							== 0);
+	assert(outside_in.getOutputs().empty());
+	reused.create<NOTGate<4>>( {&outside_in} );
+	assert(outside_in.getOutputs().size()			== 1);
+
+	// The members of a composite (the instructions of an ALUnit), wired to components created after it,
+	// are unlinked before those are destroyed.
+	{
+		SynchrotronGraph<4> composite;
+		ALUnit<4>		*alu   = composite.create<ALUnit<4>>();
+		MemoryCell<4>	*left  = composite.create<MemoryCell<4>>(for_bit_5.to_ulong()),
+						*right = composite.create<MemoryCell<4>>(for_bit_3.to_ulong());
+
+		alu->addInput(*left);
+		alu->addInput(*right);
+		alu->connectInternal();
+		assert(left->getOutputs().size()			> 1);
+		composite.clear();
+		assert(composite.size()						== 0);
+	}
+}
+
+/**	\brief
+ *	SynchrotronBuilder : Test bulk connection from an edge list and its validation.
+ */
+void testSynchrotronBuilder(void) {
+	MemoryCell<4>	a(for_bit_3.to_ulong()), b(for_bit_5.to_ulong());
+	ANDGate<4>		gate_and;
+	ORGate<4>		gate_or;
+	NOTGate<4>		gate_not;
+
+	SynchrotronBuilder<4> builder({ &a, &b, &gate_and, &gate_or });
+	assert(builder.add(gate_not)					== 4);
+
+	builder.connect({ {0, 2}, {1, 2}, {0, 3}, {1, 3}, {2, 4}, {0, 2} });	// (0, 2) twice
+	assert(builder.getEdgeCount()					== 6);
+	builder.commit();
+	assert(builder.getEdgeCount()					== 0);
+
+	assert(gate_and.getInputs().size()				== 2);
+	assert(gate_or.getInputs().size()				== 2);
+	assert(a.getOutputs().size()					== 2);
+	assert(*gate_not.getInputs().begin()			== &gate_and);
+	assert(*gate_and.getOutputs().begin()			== &gate_not);
+
+	a.emit();
+	b.emit();
+	assert(gate_and.getState()						== for_bit_1);
+	assert(gate_or.getState()						== for_bit_7);
+	assert(gate_not.getState()						== for_bit_E);
+
+	// Validated before anything is connected: gate_not already has its single input.
+	builder.connect({ {3, 0}, {0, 4} });
+	assert_error(builder.commit(), Exceptions::Exception);
+	assert(a.getInputs().empty());
+	assert(gate_or.getOutputs().empty());
+	assert(builder.getEdgeCount()					== 2);
+
+	SynchrotronBuilder<4> invalid({ &a });
+	invalid.connect(0, 1);
+	assert_error(invalid.validate(), Exceptions::Exception);
+}
+
+/**	\brief
+ *	SynchrotronSubcircuit : Test a 16-bit ripple-carry adder defined hierarchically from full adders.
+ */
+void testSynchrotronSubcircuit(void) {
+	typedef SynchrotronSubcircuit<1> Subcircuit;
+
+	// Full adder: (a, b, carry in) -> (sum, carry out)
+	Subcircuit full(3);
+	{
+		const Subcircuit::Signal a = full.input(0), b = full.input(1), c = full.input(2);
+		const Subcircuit::Signal half = full.add<XORGate<1>>( {a, b} );
+		full.output(full.add<XORGate<1>>( {half, c} ));
+		full.output(full.add<ORGate<1>>( {full.add<ANDGate<1>>( {a, b} ), full.add<ANDGate<1>>( {half, c} )} ));
+	}
+	assert(full.getGateCount()							== 5);
+	assert(full.getOutputCount()						== 2);
+
+	// Adder of 2 * width bits from two adders of width bits: (a..., b..., carry in) -> (sum..., carry out)
+	auto doubled = [](const Subcircuit& half, size_t width) {
+		Subcircuit adder(4 * width + 1);
+		std::vector<Subcircuit::Signal> low, high;
+
+		for (size_t i = 0; i < width; ++i) {
+			low.push_back(i);
+			high.push_back(width + i);
+		}
+		for (size_t i = 0; i < width; ++i) {
+			low.push_back(2 * width + i);
+			high.push_back(3 * width + i);
+		}
+		low.push_back(4 * width);
+
+		const std::vector<Subcircuit::Signal> lowSum = adder.add(half, low);
+		high.push_back(lowSum.back());
+		const std::vector<Subcircuit::Signal> highSum = adder.add(half, high);
+
+		adder.output(std::vector<Subcircuit::Signal>(lowSum.begin(), lowSum.end() - 1));
+		adder.output(highSum);
+		return adder;
+	};
+
+	const Subcircuit adder2 = doubled(full, 1), adder4 = doubled(adder2, 2),
+					 adder8 = doubled(adder4, 4), adder16 = doubled(adder8, 8);
+	assert(adder16.getGateCount()						== 16 * 5);
+	assert(adder16.getInputCount()						== 33);
+	assert(adder16.getOutputCount()						== 17);
+
+	// Two instances in one graph: only gates, no components at the subcircuit boundaries.
+	std::vector<MemoryCell<1>> cells(33);
+	std::vector<SynchrotronComponent<1>*> inputs;
+	for (auto& cell : cells)
+		inputs.push_back(&cell);
+
+	SynchrotronGraph<1> graph;
+	const std::vector<SynchrotronComponent<1>*> sum = adder16.instantiate(graph, inputs),
+												twice = adder16.instantiate(graph, inputs);
+	assert(graph.size()									== 2 * 16 * 5);
+	assert(sum.size()									== 17);
+	assert(sum[0] != twice[0]);
+	assert(dynamic_cast<XORGate<1>*>(sum[15]) != nullptr);
+	assert(dynamic_cast<ORGate<1>*>(sum[16]) != nullptr);
+
+	// The carry out of bit 0 is read directly by the gates of bit 1.
+	assert(cells[0].getOutputs().size()					== 4);	// 2 instances * (XOR + AND)
+
+	auto add = [&](unsigned a, unsigned b, unsigned carry) {
+		for (size_t i = 0; i < 16; ++i) {
+			cells[i].setState(std::bitset<1>((a >> i) & 1));
+			cells[16 + i].setState(std::bitset<1>((b >> i) & 1));
+		}
+		cells[32].setState(std::bitset<1>(carry));
+
+		unsigned result = 0;
+		for (size_t i = 0; i < 17; ++i) {
+			result |= unsigned(sum[i]->getState().to_ulong()) << i;
+			assert(twice[i]->getState()					== sum[i]->getState());
+		}
+		return result;
+	};
+
+	assert(add(0, 0, 0)									== 0);
+	assert(add(1234, 4321, 0)							== 5555);
+	assert(add(0xFFFF, 1, 0)							== 0x10000);
+	assert(add(0xFFFF, 0xFFFF, 1)						== 0x1FFFF);
+	assert(add(0x8000, 0x7FFF, 1)						== 0x10000);
+
+	// Usage errors.
+	Subcircuit broken(2);
+	assert_error(broken.input(2), Exceptions::OutOfBoundsException);
+	assert_error(broken.add<ANDGate<1>>( {0, 7} ), Exceptions::Exception);
+	assert_error(broken.output(2), Exceptions::Exception);
+	assert_error(broken.add(full, {0, 1}), Exceptions::Exception);
+	assert_error(full.instantiate(graph, {&cells[0]}), Exceptions::Exception);
+	assert(broken.getGateCount()						== 0);
+
+	// A NOTGate accepts one input only.
+	broken.add<NOTGate<1>>( {0, 1} );
+	assert_error(broken.instantiate(graph, {&cells[0], &cells[1]}), Exceptions::Exception);
+}
+
+/**	\brief
+ *	SynchrotronComponent ports : Test that inputs keep their connection order, whatever their creation order.
+ */
+void testSynchrotronComponentPorts(void) {
+	// The subtrahend is created first, so it also sorts first in getInputs() (ordered by creation).
+	MemoryCell<4>	subtrahend(for_bit_3.to_ulong()), minuend(for_bit_8.to_ulong()), third(for_bit_1.to_ulong());
+
+	SUBTRACT<4> difference({ &minuend, &subtrahend });
+	assert(difference.getPorts().size()				== 2);
+	assert(&difference.port(0)						== &minuend);
+	assert(&difference.port(1)						== &subtrahend);
+	difference.tick();
+	assert(difference.getState()					== for_bit_5);	// 8 - 3
+
+	// Later inputs are appended, removed ones shift the later ports.
+	difference.addInput(third);
+	assert(&difference.port(2)						== &third);
+	difference.removeInput(subtrahend);
+	assert(difference.getPorts().size()				== 2);
+	assert(&difference.port(0)						== &minuend);
+	assert(&difference.port(1)						== &third);
+	difference.tick();
+	assert(difference.getState()					== for_bit_7);	// 8 - 1
+	assert_error(difference.port(2), Exceptions::OutOfBoundsException);
+
+	// A copy keeps the port order.
+	SynchrotronComponent<4> copy(difference);
+	assert(&copy.port(0)							== &minuend);
+	assert(&copy.port(1)							== &third);
+
+	// SynchrotronBuilder connects in edge order, after the existing ports.
+	SUBTRACT<4> built({ &minuend });
+	SynchrotronBuilder<4> builder({ &subtrahend, &minuend, &third, &built });
+	builder.connect({ {2, 3}, {0, 3}, {2, 3} });	// (2, 3) twice
+	builder.commit();
+	assert(built.getPorts().size()					== 3);
+	assert(&built.port(0)							== &minuend);
+	assert(&built.port(1)							== &third);
+	assert(&built.port(2)							== &subtrahend);
+	built.tick();
+	assert(built.getState()							== for_bit_4);	// 8 - 1 - 3
+}
+
+/**	\brief
+ *	SynchrotronSnapshot : Test consistent copies while another thread publishes, and the ScottyCPU snapshot layout.
+ */
+void testSynchrotronSnapshot(void) {
+	SynchrotronSnapshot<16> snapshot(256);
+	std::vector<uint64_t> values;
+
+	assert(snapshot.read(values)					== 0);
+	assert(values.size()							== 256);
+	assert(values[0] == 0 && values[255]			== 0);
+
+	// Every publication sets all values to its own number: a torn copy would mix numbers.
+	const size_t publications = 20000;
+	std::atomic<bool> torn(false);
+	std::thread writer([&snapshot]() {
+		for (size_t v = 1; v <= publications; ++v)
+			snapshot.publish([v](SynchrotronSnapshot<16>::Writer& w) {
+				for (size_t i = 0; i < 256; ++i) w.set(i, uint64_t(v));
+			});
+	});
+	std::thread reader([&snapshot, &torn]() {
+		std::vector<uint64_t> copy;
+		size_t last = 0;
+
+		while (last < publications) {
+			const size_t published = snapshot.read(copy);
+			for (auto value : copy)
+				if (value != published) torn = true;
+			if (published < last) torn = true;
+			last = published;
+		}
+	});
+	writer.join();
+	reader.join();
+
+	assert(!torn);
+	assert(snapshot.getVersion()					== publications);
+	assert(snapshot.read(values)					== publications);
+
+	// ScottyCPU: registers, RAM and watched components after publishSnapshot().
+	typedef CPUComponents::ScottyCPU<16u, 64u, 16u> CPU;
+	CPU cpu(1.0f);
+	MemoryCell<16> watched(0x1234);
+
+	const size_t index = cpu.watch(watched);
+	assert(index									== CPU::SNAPSHOT_WATCHED);
+	assert(cpu.getSnapshot().size()					== CPU::SNAPSHOT_WATCHED + 1);
+
+	cpu.getRAM().setData(std::bitset<16>(5), std::bitset<16>(0xBEEF));
+	cpu.getControlUnit()->getRegisters().setData(std::bitset<16>(2), std::bitset<16>(0x42));
+	cpu.publishSnapshot();
+
+	assert(cpu.getSnapshot().read(values)			== 1);
+	assert(values[CPU::SNAPSHOT_RAM + 5]			== 0xBEEF);
+	assert(values[CPU::SNAPSHOT_REGISTERS + 2]		== 0x42);
+	assert(values[index]							== 0x1234);
+}
+
+/**	\brief
+ *	SynchrotronComponentEnable : Test that a disabled register or gate is not evaluated and emits nothing.
+ */
+void testSynchrotronComponentEnable(void) {
+	MemoryCell<1>	line(one_bit_1.to_ulong());
+	MemoryCell<4>	reg(for_bit_5.to_ulong());
+	NOTGate<4>		inv( {&reg} );
+
+	reg.setEnable(line);
+	assert(reg.getEnable()							== &line);
+	assert(reg.isEnabled());
+
+	reg.emit();
+	assert(inv.getState()							== for_bit_A);
+
+	// Enable line low: the register holds and drives nothing.
+	line.setState(one_bit_0);
+	assert(!reg.isEnabled());
+	reg.setState(for_bit_4);
+	assert(reg.getState()							== for_bit_4);
+	assert(inv.getState()							== for_bit_A);
+
+	// Enable line high: the register emits its current state once.
+	line.setState(one_bit_1);
+	assert(reg.isEnabled());
+	assert(inv.getState()							== for_bit_B);
+
+	// A disabled gate skips evaluation, also in a netlist, and catches up when enabled.
+	{
+		SynchrotronNetlist<4> netlist( {&reg} );
+		inv.setEnabled(false);
+		reg.setState(for_bit_0);
+		netlist.evaluate();
+		assert(inv.getState()						== for_bit_B);
+		assert(inv.evaluateNext()					== for_bit_B);
+	}
+	inv.setEnabled(true);
+	assert(inv.getState()							== for_bit_F);
+
+	// Enabled again without a change: counted as an update, but nothing downstream is evaluated.
+	NOTGate<4>		back( {&inv} );
+	const size_t updates = inv.getUpdateCount(), downstream = back.getUpdateCount();
+	inv.setEnabled(false);
+	inv.setEnabled(true);
+	assert(inv.getUpdateCount()						== updates + 1);
+	assert(back.getUpdateCount()					== downstream);
+
+	// A copy gets the inputs, but not the enable line.
+	MemoryCell<4>	latch( {&reg} );
+	MemoryCell<4>	copy(latch);
+	assert(copy.getInputs().size()					== 1);
+	assert(&copy.port(0)							== &reg);
+	assert(copy.getEnable()							== nullptr);
+	MemoryCell<4>	gated(reg);
+	assert(gated.getEnable()						== nullptr);
+	assert(gated.isEnabled());
+
+	reg.clearEnable();
+	assert(reg.getEnable()							== nullptr);
+	assert(reg.isEnabled());
+	line.setState(one_bit_0);
+	assert(reg.isEnabled());
+}
+
+/**	\brief
+ *	SynchrotronVCD : Test that probes record only changes, at the simulated time, without changing outputs.
+ */
+void testSynchrotronVCD(void) {
+	const std::string filename = "testSynchrotronVCD.vcd";
+	Clock<4>		c(1000.0F);			// 1 ms period
+	MemoryCell<4>	a(for_bit_1.to_ulong());
+	NOTGate<4>		n( {&a} );
+
+	{
+		SynchrotronVCD<4> vcd(filename, 2);
+
+		vcd.add(a, "reg a");
+		vcd.add(n, "not_a");
+		vcd.setClock(c);
+		assert_error(vcd.add(a, "again"), Exceptions::Exception);
+
+		assert(a.getProbe()							!= nullptr);
+		assert(a.getOutputs().size()				== 1);
+
+		a.emit();								// Sets n, a is unchanged
+		c.tick();
+		a.setState(for_bit_5);
+		a.setState(for_bit_5);					// No change
+		c.tick();
+		c.tick();
+		a.setState(for_bit_0);
+		assert(vcd.getChangeCount()					== 5);
+
+		assert_error(vcd.add(c, "clock"), Exceptions::Exception);
+		vcd.close();
+		assert(a.getProbe()							== nullptr);
+	}
+
+	std::ifstream file(filename);
+	std::stringstream contents;
+	contents << file.rdbuf();
+	file.close();
+	std::remove(filename.c_str());
+
+	const std::string vcd = contents.str();
+	assert(vcd.find("$var wire 4 ! reg_a $end")		!= std::string::npos);
+	assert(vcd.find("$var wire 4 \" not_a $end")	!= std::string::npos);
+	assert(vcd.find("#0\n$dumpvars\nb1 !\nb0 \"\n$end\n"
+					"b1110 \"\n"
+					"#1000000\nb101 !\nb1010 \"\n"
+					"#3000000\nb0 !\nb1111 \"\n")	!= std::string::npos);
+
+	// A probed Clock records both edges of every tick, half a period apart; the initial value is stamped #0.
+	{
+		Clock<1>		clock(1000.0F);
+		MemoryCell<1>	late;
+		SynchrotronVCD<1> waves(filename);
+
+		waves.add(clock, "clk");
+		waves.add(late, "late");
+		waves.setClock(clock);
+		for (size_t i = 0; i < 2; ++i)
+			clock.tick();
+		late.setState(one_bit_1);					// After the falling edge: time does not go back
+		assert(waves.getChangeCount()				== 5);
+	}
+
+	file.open(filename);
+	contents.str("");
+	contents << file.rdbuf();
+	file.close();
+	std::remove(filename.c_str());
+
+	assert(contents.str().find("#0\n$dumpvars\n0!\n0\"\n$end\n"
+							   "#1000000\n1!\n#1500000\n0!\n"
+							   "#2000000\n1!\n#2500000\n0!\n1\"\n")	!= std::string::npos);
+}
+
+/**	\brief
+ *	BitsetKernels : Test the n-ary gate kernels on wide bit_widths against a plain std::bitset fold.
+ */
+template <size_t bit_width>
+void testWideGates(size_t inputs) {
+	std::vector<MemoryCell<bit_width>*> cells;
+	std::bitset<bit_width> expect_and, expect_or, expect_xor;
+	size_t seed = 0x5EED + inputs;
+
+	expect_and.set();
+	for (size_t i = 0; i < inputs; ++i) {
+		std::bitset<bit_width> value;
+		for (size_t b = 0; b < bit_width; ++b) {
+			seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+			value[b] = (seed >> 40) & 1;
+		}
+		cells.push_back(new MemoryCell<bit_width>());
+		cells.back()->setState(value);
+
+		expect_and &= value;
+		expect_or  |= value;
+		expect_xor ^= value;
+	}
+
+	ANDGate<bit_width> gate_and;	NANDGate<bit_width> gate_nand;
+	ORGate<bit_width>  gate_or;		NORGate<bit_width>  gate_nor;
+	XORGate<bit_width> gate_xor;
+
+	for (auto cell : cells) {
+		gate_and.addInput(*cell);	gate_nand.addInput(*cell);
+		gate_or.addInput(*cell);	gate_nor.addInput(*cell);
+		gate_xor.addInput(*cell);
+	}
+	cells.front()->emit();
+
+	assert(gate_and.getState()						== expect_and);
+	assert(gate_nand.getState()						== ~expect_and);
+	assert(gate_or.getState()						== expect_or);
+	assert(gate_nor.getState()						== ~expect_or);
+	assert(gate_xor.getState()						== expect_xor);
+	assert(gate_nand.getState().count()				== bit_width - expect_and.count());	// No bits above bit_width
+
+	for (auto cell : cells)
+		delete cell;
+}
+
+void testBitsetKernels(void) {
+	testWideGates<8>(5);
+	testWideGates<64>(3);
+	testWideGates<65>(2);
+	testWideGates<128>(7);
+	testWideGates<200>(33);
+	testWideGates<256>(2);
+	testWideGates<512>(17);
+}
+
+/**	\brief
+ *	GateSummary : Test the incremental gates against a full fold, while inputs change one at a time,
+ *	are connected and disconnected, and are also evaluated by a SynchrotronNetlist.
+ */
+template <size_t bit_width>
+void testIncrementalGates(size_t inputs) {
+	std::vector<MemoryCell<bit_width>*> cells;
+	size_t seed = 0xF01D + inputs;
+
+	auto random = [&seed]() {
+		std::bitset<bit_width> value;
+		for (size_t b = 0; b < bit_width; ++b) {
+			seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+			// Mostly ones, so AND results are not always 0.
+			value[b] = ((seed >> 40) & 7) != 0;
+		}
+		return value;
+	};
+
+	for (size_t i = 0; i < inputs + 1; ++i)
+		cells.push_back(new MemoryCell<bit_width>());
+
+	ANDGate<bit_width> gate_and;	NANDGate<bit_width> gate_nand;
+	ORGate<bit_width>  gate_or;		NORGate<bit_width>  gate_nor;
+	XORGate<bit_width> gate_xor;
+
+	for (size_t i = 0; i < inputs; ++i) {
+		gate_and.addInput(*cells[i]);	gate_nand.addInput(*cells[i]);
+		gate_or.addInput(*cells[i]);	gate_nor.addInput(*cells[i]);
+		gate_xor.addInput(*cells[i]);
+	}
+
+	auto check = [&]() {
+		std::bitset<bit_width> expect_and, expect_or, expect_xor;
+		expect_and.set();
+		for (auto connection : gate_and.getInputs()) {
+			const std::bitset<bit_width> value(connection->getState());
+			expect_and &= value;
+			expect_or  |= value;
+			expect_xor ^= value;
+		}
+
+		assert(gate_and.getState()						== expect_and);
+		assert(gate_nand.getState()						== ~expect_and);
+		assert(gate_or.getState()						== expect_or);
+		assert(gate_nor.getState()						== ~expect_or);
+		assert(gate_xor.getState()						== expect_xor);
+	};
+
+	for (size_t step = 0; step < 20 * inputs; ++step) {
+		cells[seed % inputs]->setState(random());
+		check();
+	}
+
+	// A changed set of inputs rebuilds the summary.
+	for (auto gate : std::initializer_list<SynchrotronComponent<bit_width>*>{ &gate_and, &gate_nand, &gate_or, &gate_nor, &gate_xor }) {
+		gate->removeInput(*cells[0]);
+		gate->addInput(*cells[inputs]);
+	}
+	cells[inputs]->setState(random());
+	check();
+	cells[0]->setState(random());
+	check();
+
+	// Full tick()s by an engine and incremental ones mix.
+	{
+		SynchrotronNetlist<bit_width> netlist( {cells[1]} );
+		cells[1]->setState(random());
+		cells[2]->setState(random());
+		netlist.evaluate();
+		check();
+	}
+	cells[2]->setState(random());
+	check();
+
+	for (auto cell : cells)
+		delete cell;
+}
+
+void testGateSummary(void) {
+	testIncrementalGates<1>(17);
+	testIncrementalGates<8>(24);
+	testIncrementalGates<64>(40);
+	testIncrementalGates<200>(20);
+}
+
+/**	\brief
+ *	BitSliceSimulator : Test 64-lane evaluation of a full adder against tick().
+ */
+void testBitSliceSimulator(void) {
+	MemoryCell<1>	a, b, c_in;
+	XORGate<1>		s_ab( {&a, &b} ),
+					sum( {&s_ab, &c_in} );
+	ANDGate<1>		c_ab( {&a, &b} ),
+					c_s( {&s_ab, &c_in} );
+	ORGate<1>		c_out( {&c_ab, &c_s} );
+	NOTGate<1>		n_sum( {&sum} );
+
+	CPUFactory::BitSliceSimulator sim( {&a} );
+	assert(sim.size()							== 9);
+
+	// All 8 input combinations in lanes 0..7 (the other lanes repeat them).
+	sim.setExhaustive( {&a, &b, &c_in}, 0);
+	sim.evaluate();
+
+	for (size_t lane = 0; lane < CPUFactory::BitSliceSimulator::LANES; ++lane) {
+		const size_t total = (lane & 1u) + ((lane >> 1) & 1u) + ((lane >> 2) & 1u);
+
+		assert(sim.getLane(sum, lane)			== bool(total & 1u));
+		assert(sim.getLane(c_out, lane)			== bool(total >> 1));
+		assert(sim.getLane(n_sum, lane)			!= sim.getLane(sum, lane));
+	}
+
+	// The lanes match scalar propagation through tick().
+	for (size_t vector = 0; vector < 8; ++vector) {
+		a.setState(vector & 1u);
+		b.setState((vector >> 1) & 1u);
+		c_in.setState((vector >> 2) & 1u);
+		assert(sum.getState().test(0)			== sim.getLane(sum, vector));
+		assert(c_out.getState().test(0)			== sim.getLane(c_out, vector));
+	}
+
+	sim.setLanes(a, 0xF0F0F0F0F0F0F0F0ull);
+	sim.setLanes(b, 0);
+	sim.setLanes(c_in, 0);
+	sim.evaluate();
+	assert(sim.getLanes(sum)					== 0xF0F0F0F0F0F0F0F0ull);
+	assert(sim.getLanes(c_out)					== 0);
+
+	assert_error(sim.setLanes(sum, 0), Exceptions::Exception);
+
+	SynchrotronComponent<1>	outside;
+	assert_error(sim.getLanes(outside), Exceptions::Exception);
+
+	ADD<1> adder( {&a, &b} );
+	assert_error(sim.compile( {&a} ), Exceptions::Exception);	// Arithmetic is not bit-sliced
+}
+
+/**	\brief
+ *	LogicGraph : Test the optimizer passes and evaluation against tick().
+ */
+void testLogicGraph(void) {
+	MemoryCell<4>			in, in2;
+	SynchrotronComponent<4>	k_ones(for_bit_F.to_ulong()), k_zero, k_5(for_bit_5.to_ulong());
+	ANDGate<4>				and_k( {&k_5, &k_ones} ),	// Constant 0101
+							and_z( {&in, &k_zero} );	// Constant 0000
+	ORGate<4>				or_v( {&in, &k_zero} );		// Buffer of in
+	XORGate<4>				x1( {&in, &in2} ),
+							x2( {&in2, &in} );			// Same as x1
+	NOTGate<4>				n1( {&x1} ),
+							n2( {&n1} );				// Same as x1
+	ADD<4>					out( {&and_k, &or_v, &n2, &x2, &and_z} );
+
+	typedef CPUFactory::LogicGraph<4> Graph;
+	Graph graph( {&in} );
+	assert(graph.getNodeCount()					== 13);
+	assert(graph.getEdgeCount()					== 17);
+
+	// The constants and everything read from them.
+	Graph::PassReport report = graph.foldConstants();
+	assert(report.nodesRemoved					== 4);
+	assert(report.edgesRemoved					== 6);
+
+	// or_v and n2.
+	report = graph.eliminateBuffers();
+	assert(report.nodesRemoved					== 2);
+	assert(report.edgesRemoved					== 2);
+
+	// x2.
+	report = graph.eliminateCommonSubexpressions();
+	assert(report.nodesRemoved					== 1);
+	assert(report.edgesRemoved					== 2);
+
+	// n1 is no longer read.
+	report = graph.removeDeadNodes();
+	assert(report.nodesRemoved					== 1);
+	assert(report.edgesRemoved					== 1);
+
+	assert(graph.getNodeCount()					== 5);
+	assert(graph.getEdgeCount()					== 6);
+	assert(graph.getNode(x2)					== graph.getNode(x1));
+	assert(graph.getNode(or_v)					== graph.getNode(in));
+
+	// optimize() runs all passes to the same result.
+	Graph all( {&in} );
+	const std::vector<Graph::PassReport> reports = all.optimize();
+	assert(reports.size()						== 4);
+	assert(reports[0].name						== "foldConstants");
+	assert(reports[0].nodesRemoved				== 4);
+	assert(reports[3].nodesRemoved				== 1);
+	assert(all.getNodeCount()					== 5);
+
+	// Settle the live graph and compare.
+	k_ones.emit();
+	k_zero.emit();
+	k_5.emit();
+	in.setState(for_bit_3);
+	in2.setState(for_bit_8);
+	graph.evaluate();
+
+	assert(out.getState()						== for_bit_E);	// 5 + 3 + 11 + 11 + 0
+	assert(graph.getValue(out)					== out.getState());
+	assert(graph.getValue(n2)					== for_bit_B);
+	assert(graph.countMismatches()				== 0);
+
+	assert_error(graph.getValue(n1), Exceptions::Exception);	// Removed
+	assert_error(graph.getValue(and_z), Exceptions::Exception);
+
+	// Observed components are kept.
+	Graph observed( {&in} );
+	observed.setObserved( {&n1} );
+	observed.optimize();
+	observed.evaluate();
+	assert(observed.getValue(n1)				== for_bit_4);
+	assert_error(observed.setVariable( {&out} ), Exceptions::Exception);
+}
+
+/**	\brief	The exact code CodeGenerator<1> generates for the full adder of testCodeGenerator() (asserted there).
+ *			generatedFullAdder() below is this code verbatim: regenerate both together.
+ */
+static const char generatedFullAdderCode[] = R"(/**	Generated by CPUFactory::CodeGenerator<1> from 9 nodes and 11 edges.
+ *	in[3], state[0], out[4]
+ */
+inline void generatedFullAdder(const uint8_t *in, uint8_t *state, uint8_t *out) {
+	(void) state;
+	const uint8_t n0 = in[0];
+	const uint8_t n1 = in[1];
+	const uint8_t n3 = in[2];
+	const uint8_t n4 = uint8_t(n0 ^ n3);
+	const uint8_t n5 = uint8_t(n0 & n3);
+	const uint8_t n7 = uint8_t(n4 ^ n1);
+	const uint8_t n8 = uint8_t(n4 & n1);
+	const uint8_t n9 = uint8_t((~n7) & 0x1);
+	const uint8_t n10 = uint8_t(n5 | n8);
+	out[0] = n5;
+	out[1] = n7;
+	out[2] = n9;
+	out[3] = n10;
+}
+)";
+
+/**	Generated by CPUFactory::CodeGenerator<1> from 9 nodes and 11 edges.
+ *	in[3], state[0], out[4]
+ */
+inline void generatedFullAdder(const uint8_t *in, uint8_t *state, uint8_t *out) {
+	(void) state;
+	const uint8_t n0 = in[0];
+	const uint8_t n1 = in[1];
+	const uint8_t n3 = in[2];
+	const uint8_t n4 = uint8_t(n0 ^ n3);
+	const uint8_t n5 = uint8_t(n0 & n3);
+	const uint8_t n7 = uint8_t(n4 ^ n1);
+	const uint8_t n8 = uint8_t(n4 & n1);
+	const uint8_t n9 = uint8_t((~n7) & 0x1);
+	const uint8_t n10 = uint8_t(n5 | n8);
+	out[0] = n5;
+	out[1] = n7;
+	out[2] = n9;
+	out[3] = n10;
+}
+
+/**	\brief
+ *	CodeGenerator : Test generated code (generatedFullAdder() above, checked in as generated) against tick().
+ */
+void testCodeGenerator(void) {
+	MemoryCell<1>			a, b, c_in;
+	SynchrotronComponent<1>	one(one_bit_1.to_ulong());
+	XORGate<1>				s_ab( {&a, &b} ),
+							sum( {&s_ab, &c_in} );
+	ANDGate<1>				c_ab( {&a, &b} ),
+							c_s( {&s_ab, &c_in} ),
+							c_ba( {&b, &a, &one} );		// Same as c_ab
+	ORGate<1>				c_out( {&c_ba, &c_s} );
+	NOTGate<1>				n_sum( {&sum} );
+
+	CPUFactory::LogicGraph<1> graph( {&a} );
+	graph.setObserved( {&sum} );
+	graph.optimize();
+
+	CPUFactory::CodeGenerator<1> generator(graph);
+	const std::string code = generator.generate("generatedFullAdder");
+
+	assert(generator.getInputs().size()			== 3);
+	assert(generator.getOutputs().size()		== 4);	// c_ab, sum, n_sum, c_out
+	assert(generator.getInitialState().empty());
+	assert(code										== generatedFullAdderCode);
+	assert(code.find("tick")					== std::string::npos);
+
+	// tick() every gate once, so the live states match their inputs.
+	SynchrotronNetlist<1>( {&a} ).evaluate();
+
+	for (size_t vector = 0; vector < 8; ++vector) {
+		a.setState(vector & 1u);
+		b.setState((vector >> 1) & 1u);
+		c_in.setState((vector >> 2) & 1u);
+		assert(generator.countMismatches(generatedFullAdder)	== 0);
+	}
+
+	// A wrong evaluator is caught.
+	auto zero = [](const uint8_t*, uint8_t*, uint8_t *out) { out[0] = out[1] = out[2] = out[3] = 0; };
+	assert(generator.countMismatches(zero)		> 0);
+
+	// Plain SynchrotronComponents keep their state in state[].
+	MemoryCell<4>			x;
+	NOTGate<4>				n_x( {&x} );
+	SynchrotronComponent<4>	acc( {&n_x} );
+	CPUFactory::LogicGraph<4> sticky( {&x} );
+	CPUFactory::CodeGenerator<4> accumulator(sticky);
+	assert(accumulator.getInitialState().size()	== 1);
+	assert(accumulator.generate("f").find("state[0] = uint8_t(state[0] | n") != std::string::npos);
+	assert(accumulator.generate("f").find("& 0xF)") != std::string::npos);	// ~ sets the bits above bit_width
+}
+
+/**	\brief
+ *	NetlistFile : Test the text and binary round trip through CPUComponentFactory.
+ */
+void testNetlistFile(void) {
+	typedef CPUFactory::NetlistFile<4> Netlist;
+
+	MemoryCell<4>			a(for_bit_7.to_ulong()), b(for_bit_2.to_ulong());
+	SUBTRACT<4>				diff( {&a, &b} );			// a - b: the order of the inputs matters
+	ANDGate<4>				masked( {&diff, &b} );
+	SynchrotronComponent<4>	acc(for_bit_1.to_ulong());
+	acc.addInput(masked);
+
+	const std::vector<SynchrotronComponent<4>*> roots = { &a };
+
+	assert(CPUComponentFactory<4>::getName(diff)		== "SUBTRACT");
+	assert(CPUComponentFactory<4>::getName(acc)			== "SynchrotronComponent");
+	assert(CPUComponentFactory<4>::isRegistered("MemoryCell"));
+	assert_error(CPUComponentFactory<4>::create("FluxCapacitor"), Exceptions::Exception);
+
+	std::stringstream text, binary;
+	Netlist::writeText(text, roots);
+	Netlist::writeBinary(binary, roots);
+
+	assert(text.str().find("netlist 4 5\n")				!= std::string::npos);
+	assert(text.str().find("2 SUBTRACT 0x0 0 1\n")		!= std::string::npos);
+	assert(text.str().find("4 SynchrotronComponent 0x1 3\n") != std::string::npos);
+
+	auto check = [](Netlist& loaded) {
+		assert(loaded.size()							== 5);
+		assert(CPUComponentFactory<4>::getName(loaded[2])	== "SUBTRACT");
+		assert(loaded[0].getState()						== for_bit_7);
+		assert(loaded[4].getState()						== for_bit_1);
+		assert(*loaded[2].getInputs().begin()			== &loaded[0]);
+		assert(*loaded[4].getInputs().begin()			== &loaded[3]);
+
+		// The loaded graph computes: (8 - 2) & 2 = 2, then (8 - 4) & 4 = 4, both ORed into 1.
+		static_cast<MemoryCell<4>&>(loaded[0]).setState(for_bit_8);
+		static_cast<MemoryCell<4>&>(loaded[1]).setState(for_bit_4);
+		assert(loaded[2].getState()						== for_bit_4);
+		assert(loaded[4].getState()						== for_bit_7);
+	};
+
+	Netlist fromText, fromBinary, fromFile;
+	fromText.readText(text);
+	check(fromText);
+
+	const std::string bytes = binary.str();
+	fromBinary.readBinary(bytes.data(), bytes.size());
+	check(fromBinary);
+
+	// Through a memory mapped file.
+	const std::string filename = "testNetlistFile.scnl";
+	Netlist::saveBinary(filename, roots);
+	fromFile.loadBinary(filename);
+	check(fromFile);
+
+	// load() tells the binary form from the text form.
+	fromFile.load(filename);
+	check(fromFile);
+	Netlist::saveText(filename, roots);
+	fromFile.load(filename);
+	std::remove(filename.c_str());
+	check(fromFile);
+
+	// Invalid input is rejected.
+	std::stringstream wide("netlist 8 1\n0 ANDGate 0x0\n"),
+					  unknown("netlist 4 1\n0 FluxCapacitor 0x0\n"),
+					  dangling("netlist 4 2\n0 MemoryCell 0x0\n1 NOTGate 0x0 2\n");
+	assert_error(fromText.readText(wide), Exceptions::Exception);
+	assert_error(fromText.readText(unknown), Exceptions::Exception);
+	assert_error(fromText.readText(dangling), Exceptions::Exception);
+
+	// The header count of the text form is only checked against the lines read, nothing is allocated for it.
+	std::stringstream huge("netlist 4 300000000\n0 MemoryCell 0x0\n"),
+					  duplicate("netlist 4 2\n0 MemoryCell 0x0\n0 MemoryCell 0x1\n"),
+					  reordered("netlist 4 2\n1 NOTGate 0x0 0\n0 MemoryCell 0x5\n");
+	assert_error(fromText.readText(huge), Exceptions::Exception);
+	assert_error(fromText.readText(duplicate), Exceptions::Exception);
+	fromText.readText(reordered);
+	assert(fromText.size()								== 2);
+	assert(&fromText[1].port(0)							== &fromText[0]);
+	assert(fromText[0].getState()						== for_bit_5);
+	assert_error(fromBinary.readBinary(bytes.data(), bytes.size() - 1), Exceptions::Exception);
+
+	// Counts in a corrupt header are checked against the size before anything is allocated.
+	for (size_t field : { 2u, 3u, 4u }) {
+		std::string corrupt(bytes);
+		const uint32_t huge = 0xFFFFFFF0u;
+		std::memcpy(&corrupt[4 + 4 * field], &huge, sizeof(huge));
+		assert_error(fromBinary.readBinary(corrupt.data(), corrupt.size()), Exceptions::Exception);
+	}
+	assert_error(fromFile.loadBinary("does/not/exist.scnl"), Exceptions::FileReadException);
+	assert_error(fromFile.load("does/not/exist.scnl"), Exceptions::FileReadException);
+}
+
+/**	\brief
+ *	TimingAnalysis : Test arrival times, the critical path and the maximum frequency.
+ */
+void testTimingAnalysis(void) {
+	// r1 -> AND -> NOT -> XOR -> r3, r2 -> AND, r2 -> XOR, XOR -> OR (no outputs)
+	MemoryCell<4>	r1, r2, r3;
+	ANDGate<4>		gate_and( {&r1, &r2} );
+	NOTGate<4>		gate_not( {&gate_and} );
+	XORGate<4>		gate_xor( {&gate_not, &r2} );
+	ORGate<4>		gate_or( {&gate_xor} );
+	r3.addInput(gate_xor);
+
+	DelayTable table(5);	// MemoryCells: 5 ps from the clock edge
+	table.set<ANDGate<4>>(30).set<NOTGate<4>>(10).set<XORGate<4>>(40).set<ORGate<4>>(20);
+
+	{
+		CPUFactory::TimingAnalysis<4> analysis( {&r1}, table );
+		assert(analysis.size()								== 7);
+		assert(analysis.getEndpointCount()					== 2);	// r3 and OR
+		assert(analysis.getArrival(r2)						== 5);
+		assert(analysis.getArrival(gate_and)				== 35);
+		assert(analysis.getArrival(gate_xor)				== 85);
+		assert(analysis.getCriticalDelay()					== 105);	// through OR
+		assert(analysis.getCriticalPath().size()			== 5);
+		assert(analysis.getCriticalPath().front()			== &r1);
+		assert(analysis.getCriticalPath().back()			== &gate_or);
+		assert(std::abs(analysis.getMaxFrequency() - 1e12 / 105) < 1.0);
+
+		std::stringstream report;
+		analysis.print(report);
+		assert(report.str().find("105 ps")					!= std::string::npos);
+	}
+
+	// Without the OR, the path ends at the input of r3.
+	gate_or.removeInput(gate_xor);
+	{
+		CPUFactory::TimingAnalysis<4> analysis( {&r1}, table );
+		const std::vector<const SynchrotronComponent<4>*> path = { &r1, &gate_and, &gate_not, &gate_xor, &r3 };
+		assert(analysis.getCriticalDelay()					== 85);
+		assert(analysis.getCriticalPath()					== path);
+		assert(analysis.getMaxFrequency() > 11.7e9 && analysis.getMaxFrequency() < 11.8e9);
+	}
+
+	// Registers only: no combinational path.
+	{
+		MemoryCell<4> lonely;
+		CPUFactory::TimingAnalysis<4> analysis( {&lonely}, table );
+		assert(analysis.getCriticalDelay()					== 0);
+		assert(analysis.getMaxFrequency()					== 0.0);
+		assert(analysis.getCriticalPath().empty());
+		assert_error(analysis.getArrival(r1), Exceptions::Exception);
+	}
+
+	// The default delays grow with the width of arithmetic.
+	assert(CPUFactory::TimingAnalysis<16>::defaultDelays().get(ADD<16>())	> CPUFactory::TimingAnalysis<4>::defaultDelays().get(ADD<4>()));
+
+	// Combinational loops are rejected.
+	{
+		ORGate<4> a( {&r1} ), b( {&a} );
+		a.addInput(b);
+		assert_error(CPUFactory::TimingAnalysis<4>( {&r1}, table ), Exceptions::Exception);
+	}
+
+	// The ScottyCPU itself (-c max): the slowest ALU instruction reads the bus register.
+	{
+		CPUComponents::ScottyCPU<16u, 64u, 16u> cpu(1.0f);
+		CPUFactory::TimingAnalysis<16> analysis(cpu.getGraphRoots());
+		assert(analysis.getCriticalDelay()					== 20 + 60 * 16);
+		assert(analysis.getCriticalPath().size()			== 2);
+		assert(dynamic_cast<const DIVInstruction<16>*>(analysis.getCriticalPath().back()) != nullptr);
+	}
+}
+
 /**	\brief
  *	AND Gate : Test basic logic.
  */
@@ -1231,6 +2822,112 @@ void testClock(void) {
 	// TO-DO: Test emit cycle
 }
 
+/**	\brief
+ *	A 4-bit OR counting its tick()s, optionally with hidden state (see testClockQuiescence()).
+ */
+class QuiescenceProbe : public SynchrotronComponent<4u> {
+	public:
+		size_t ticks	= 0;
+		bool   hidden	= false;
+
+		void tick(void) {
+			++this->ticks;
+			SynchrotronComponent<4u>::tick();
+		}
+
+		bool hasHiddenState(void) const {
+			return this->hidden;
+		}
+};
+
+/**	\brief
+ *	Clock : Test skipping quiescent outputs on clock edges.
+ */
+void testClockQuiescence(void) {
+	Clock<4u>		c(1.0F);
+	MemoryCell<4u>	data(for_bit_0.to_ulong());
+	QuiescenceProbe	gate, state;
+
+	gate.addInput(c);
+	gate.addInput(data);
+	state.addInput(c);
+	state.hidden = true;
+
+	// First edge evaluates everything, the next one skips the unchanged gate.
+	c.tick();
+	assert(gate.ticks								== 1);
+	assert(gate.getState()							== for_bit_1);
+	c.tick();
+	assert(gate.ticks								== 1);
+	assert(state.ticks								== 2);
+
+	// A changed input is evaluated on the next edge (after its own emit()), then skipped again.
+	data.setState(for_bit_4);
+	assert(gate.ticks								== 2);
+	assert(gate.getState()							== for_bit_5);
+	c.tick();
+	assert(gate.ticks								== 3);
+	c.tick();
+	assert(gate.ticks								== 3);
+	assert(state.ticks								== 4);
+
+	assert(c.getQuiescence().edges					== 4);
+	assert(c.getQuiescence().evaluated				== 6);
+	assert(c.getQuiescence().skipped				== 2);
+	assert(c.getQuiescence().getSkipRatio()			== 0.25);
+
+	// A disabled clock evaluates nothing.
+	c.setEnabled(false);
+	c.tick();
+	assert(gate.ticks								== 3);
+	assert(state.ticks								== 4);
+	c.setEnabled(true);								// Emits once.
+	assert(gate.ticks								== 4);
+
+	// An input changed by a two-phase engine (evaluateNext() and commit(), no update()) is evaluated on the next edge.
+	{
+		Clock<4u>		clock(1.0F);
+		MemoryCell<4u>	x(for_bit_0.to_ulong());
+		ANDGate<4u>		gated( {&x} );
+		SynchrotronScheduler<4u> scheduler( {&x} );
+
+		scheduler.setTwoPhase(true);
+		gated.addInput(clock);						// The clock itself ticks its outputs directly.
+		clock.tick();
+		assert(gated.getState()						== for_bit_0);
+		clock.tick();
+		assert(clock.getQuiescence().skipped		== 1);
+
+		x.setState(for_bit_1);
+		assert(gated.getState()						== for_bit_0);
+		clock.tick();
+		assert(gated.getState()						== for_bit_1);
+		scheduler.release();
+	}
+
+	// In the ScottyCPU the Clock only drives the ControlUnit, which has hidden state: nothing is skipped.
+	{
+		CPUComponents::ScottyCPU<16u, 64u, 16u> cpu(1.0F);
+		for (size_t i = 0; i < 4; ++i)
+			cpu.step();
+		std::remove("RAMdump.txt");
+		std::remove("REGdump.txt");
+
+		assert(cpu.getClock().getQuiescence().edges			== 4);
+		assert(cpu.getClock().getQuiescence().evaluated		== 4);
+		assert(cpu.getClock().getQuiescence().getSkipRatio()	== 0.0);
+	}
+
+	// Without tracking every output is evaluated on every edge.
+	c.setQuiescenceTracking(false);
+	c.resetQuiescence();
+	c.tick();
+	c.tick();
+	assert(gate.ticks								== 6);
+	assert(c.getQuiescence().edges					== 0);
+	assert(c.getQuiescence().getSkipRatio()			== 0.0);
+}
+
 // TO-DO
 /**	\brief
  *	ADD : Test basic logic.
@@ -1256,9 +2953,8 @@ void testADD(void) {
  *	SUBTRACT : Test basic logic.
  */
 void testSUBTRACT(void) {
-	// Inputs are added in sequence sorted by address.
-	// To ensure proper working, the element to subtract from has to be created first.
-	// TO-DO: The sorting issue should be fixed in a previous build, so this testing in blocks should be unnecessary.
+	// The first input (port(0)) is the element to subtract from, whatever the creation order
+	// (see testSynchrotronComponentPorts()).
 
 	SUBTRACT<4> g4;
 	assert_error(g4.tick(), Exceptions::Exception);
@@ -1346,9 +3042,8 @@ void testMULTIPLY(void) {
  *	DIVIDE : Test basic logic.
  */
 void testDIVIDE(void) {
-	// Inputs are added in sequence sorted by address.
-	// To ensure proper working, the element to subtract from has to be created first.
-	// TO-DO: The sorting issue should be fixed in a previous build, so this testing in blocks should be unnecessary.
+	// The first input (port(0)) is the dividend, whatever the creation order
+	// (see testSynchrotronComponentPorts()).
 
 	DIVIDE<4> g4;
 	assert_error(g4.tick(), Exceptions::Exception);
@@ -1402,9 +3097,8 @@ void testDIVIDE(void) {
  *	MODULO : Test basic logic.
  */
 void testMODULO(void) {
-	// Inputs are added in sequence sorted by address.
-	// To ensure proper working, the element to subtract from has to be created first.
-	// TO-DO: The sorting issue should be fixed in a previous build, so this testing in blocks should be unnecessary.
+	// The first input (port(0)) is the dividend, whatever the creation order
+	// (see testSynchrotronComponentPorts()).
 
 	MODULO<4> g4;
 	assert_error(g4.tick(), Exceptions::Exception);
@@ -1450,9 +3144,8 @@ void testMODULO(void) {
  *	COMPERATOR : Test basic logic.
  */
 void testCOMPERATOR(void) {
-	// Inputs are added in sequence sorted by address.
-	// To ensure proper working, the element to subtract from has to be created first.
-	// TO-DO: The sorting issue should be fixed in a previous build, so this testing in blocks should be unnecessary.
+	// The first input (port(0)) is compared with the others, whatever the creation order
+	// (see testSynchrotronComponentPorts()).
 
 	COMPERATOR<4> g4;
 	assert_error(g4.tick(), Exceptions::Exception);
@@ -1861,9 +3554,8 @@ void testMODInstruction(void) {
  *	CMPInstruction : Test basic logic.
  */
 void testCMPInstruction(void) {
-	// Inputs are added in sequence sorted by address.
-	// To ensure proper working, the element to subtract from has to be created first.
-	// TO-DO: The sorting issue should be fixed in a previous build, so this testing in blocks should be unnecessary.
+	// The first input (port(0)) is compared with the others, whatever the creation order
+	// (see testSynchrotronComponentPorts()).
 
 	CMPInstruction<4> g4;
 	assert_error(g4.tick(), Exceptions::Exception);
@@ -1950,8 +3642,31 @@ void runTests(void) {
 	try {
 		testBitset();
 		testFloatingBitset();
+		testNativeBitset();
 
 		testSynchrotronComponent();
+		testLockPolicy();
+		testSynchrotronNetlist();
+		testSynchrotronScheduler();
+		testTimingWheel();
+		testSynchrotronTiming();
+		testSynchrotronParallelNetlist();
+		testSynchrotronFixpointNetlist();
+		testSynchrotronActivityReport();
+		testSynchrotronGraph();
+		testSynchrotronBuilder();
+		testSynchrotronComponentPorts();
+		testSynchrotronSubcircuit();
+		testSynchrotronSnapshot();
+		testSynchrotronComponentEnable();
+		testSynchrotronVCD();
+		testBitsetKernels();
+		testGateSummary();
+		testBitSliceSimulator();
+		testLogicGraph();
+		testCodeGenerator();
+		testNetlistFile();
+		testTimingAnalysis();
 		testLogic_AND_const();
 		testLogic_AND_dynamic();
 		testLogic_NAND_const();
@@ -1972,6 +3687,7 @@ void runTests(void) {
 		testLogic_ShiftLeft_dynamic();
 		testLogic_Memory();
 		testClock();					// WIP
+		testClockQuiescence();
 
 		testADD();
 		testSUBTRACT();
@@ -10,11 +10,18 @@
  */
 #define	THROW_EXCEPTIONS
 
+/**	\brief	Uncomment to count tick()s, emit()s and state changes per component (see SynchrotronActivityReport).
+ */
+//#define	SYNCHROTRON_STATISTICS
+
 #include <iostream>
 #include <iomanip>
 #include "ScottyCPU.hpp"
+#include "CPUFactory/NetlistFile.hpp"
+#include "CPUFactory/TimingAnalysis.hpp"
 
 #include "utils.hpp"
+#include "Benchmark.hpp"
 
 #ifndef NDEBUG
 #include "UnitTest.hpp"
@@ -26,12 +33,15 @@ using namespace std;
  */
 static struct SETTINGS {
 	float	clk_freq	= 1.0F;		///< The clock frequency.
+	bool	clk_max		= false;	///< Whether to use the maximum clock frequency of timingFile (or of the ScottyCPU).
 	bool	debug		= false;	///< Whether to execute UnitTests.
+	bool	bench		= false;	///< Whether to execute Benchmarks.
 	string	version		= "0.4.44";	///< The current version of this program.
 	bool	parseScAM	= true;		///< Whether to parse the .ScAM file from scamFile.
 	bool	loadScHex	= false;	///< Whether to load the .ScHex file from schexFile.
 	string	scamFile	= "";		///< The path to a .ScAM file.
 	string	schexFile	= "";		///< The path to a .ScHex file.
+	string	timingFile	= "";		///< The path to a netlist file to analyze (see TimingAnalysis).
 } ScottySettings;
 
 /**
@@ -42,8 +52,8 @@ static struct SETTINGS {
  */
 void showUsage(char* _name) {
 	string name(_name),
-		   help_1 = " [-h|-H] [-d|-D] [-c|-C <float>] [-i|-I]",
-		   help_2 = " [-l|-L|-a|-A <file>] [-o <file>] [-hex <file>]";
+		   help_1 = " [-h|-H] [-d|-D] [-b|-B] [-c|-C <float>|max] [-i|-I]",
+		   help_2 = " [-l|-L|-a|-A <file>] [-o <file>] [-hex <file>] [-t|-T <file>]";
 	stringstream usage;
 
 	std::strEraseToLast(name, "\\");
@@ -54,12 +64,16 @@ void showUsage(char* _name) {
 		  << std::setw(name.size() + help_2.size()) << help_2				<< endl << endl
 		  << "  -h, -H, --help     Show this help message"					<< endl
 		  << "  -d, -D, --debug    Execute UnitTests"						<< endl
+		  << "  -b, -B, --bench    Execute Benchmarks"						<< endl
 		  << "  -c, -C  <float>    Set the ScottyCPU clock frequency"		<< endl
+		  << "  -c, -C  max        Use the maximum frequency of the ScottyCPU"	<< endl
+		  << "                     (or of the -t netlist)"					<< endl
 		  << "  -i, -I             Show InstructionSet"						<< endl
 		  << "  -l, -L  <file>     Load .ScAM file and parse"				<< endl
 		  << "  -a, -A  <file>     Load .ScAM file and compile to .ScHex"	<< endl
 		  << "  -o      <file>     Specify output file for assembly"		<< endl
 		  << "  -hex    <file>     Load .ScHex file into ScottyCPU RAM"		<< endl
+		  << "  -t, -T  <file>     Show the critical path of a netlist file"	<< endl
 		  << endl;
 
 	//fprintf(stderr, usage.str().c_str());
@@ -72,16 +86,20 @@ void showUsage(char* _name) {
  *
  *	Command line arguments (showUsage()):
  *
- *	    Usage: ScottyCPU.exe [-h|-H] [-d|-D] [-c|-C <float>] [-i|-I]
- *	    				     [-l|-L|-a|-A <file>] [-o <file>] [-hex <file>]
+ *	    Usage: ScottyCPU.exe [-h|-H] [-d|-D] [-b|-B] [-c|-C <float>|max] [-i|-I]
+ *	    				     [-l|-L|-a|-A <file>] [-o <file>] [-hex <file>] [-t|-T <file>]
  *	      -h, -H, --help     Show this help message
  *	      -d, -D, --debug    Execute UnitTests
+ *	      -b, -B, --bench    Execute Benchmarks
  *	      -c, -C  <float>    Set the ScottyCPU clock frequency
+ *	      -c, -C  max        Use the maximum frequency of the ScottyCPU
+ *	                         (or of the -t netlist)
  *	      -i, -I             Show InstructionSet
  *	      -l, -L  <file>     Load .ScAM file and parse
  *	      -a, -A  <file>     Load .ScAM file and compile to .ScHex
  *	      -o      <file>     Specify output file for assembly
  *	      -hex    <file>     Load .ScHex file into ScottyCPU RAM
+ *	      -t, -T  <file>     Show the critical path of a netlist file
  */
 int main(int argc, char *argv[]) {
 	int i;
@@ -101,14 +119,20 @@ int main(int argc, char *argv[]) {
 			if (arg == "-d" || arg == "-D" || arg == "--debug") {
 				// Enable debugging
 				ScottySettings.debug = true;
+			} else if (arg == "-b" || arg == "-B" || arg == "--bench") {
+				// Enable benchmarks
+				ScottySettings.bench = true;
 			} else if (arg == "-h" || arg == "-H" || arg == "--help") {
 				// Show usage
 				showUsage(argv[0]);
 				SysUtils::callSystemCmd("PAUSE");
 				exit(1);
 			} else if (arg == "-c" || arg == "-C") {
-				// Set clk_freq
-				ScottySettings.clk_freq = SysUtils::lexical_cast<float>(argv[++i]);
+				// Set clk_freq, or take it from the timing analysis
+				arg = argv[++i];
+				ScottySettings.clk_max = (arg == "max");
+				if (!ScottySettings.clk_max)
+					ScottySettings.clk_freq = SysUtils::lexical_cast<float>(argv[i]);
 			} else if (arg == "-i" || arg == "-I") {
 				// Show InstructionSet
 				CPUInstructions::printInstructionSet();
@@ -123,6 +147,9 @@ int main(int argc, char *argv[]) {
 				// Load .ScHex file
 				ScottySettings.loadScHex = true;
 				ScottySettings.schexFile = std::string(argv[++i]);
+			} else if (arg == "-t" || arg == "-T") {
+				// Analyze netlist file
+				ScottySettings.timingFile = std::string(argv[++i]);
 			} else {
 				// Show usage
 				showUsage(argv[0]);
@@ -137,6 +164,9 @@ int main(int argc, char *argv[]) {
 			runTests();
 		#endif
 
+		if (ScottySettings.bench)
+			runBenchmarks();
+
 		if (!ScottySettings.scamFile.empty()) {
 			if (ScottySettings.parseScAM) {
 				CPUFactory::SCAMParser parser (ScottySettings.scamFile);
@@ -149,22 +179,49 @@ int main(int argc, char *argv[]) {
 			}
 		}
 
-		if (ScottySettings.loadScHex) {
+		if (!ScottySettings.timingFile.empty()) {
+			CPUFactory::NetlistFile<16u> netlist;
+			netlist.load(ScottySettings.timingFile);
+
+			CPUFactory::TimingAnalysis<16u> analysis(netlist.getComponents());
+			analysis.print(std::cout);
+
+			if (ScottySettings.clk_max && analysis.getMaxFrequency() > 0.0) {
+				ScottySettings.clk_freq = float(analysis.getMaxFrequency());
+				std::cout << "Clock frequency set to " << ScottySettings.clk_freq << " Hz." << std::endl;
+			}
+		}
+
+		if (ScottySettings.loadScHex || (ScottySettings.clk_max && ScottySettings.timingFile.empty())) {
 			CPUComponents::ScottyCPU<16u, 64u, 16u> cpu(ScottySettings.clk_freq);
 
-			std::vector<char> *buffer = SysUtils::readBinaryFile(ScottySettings.schexFile);
+			// Without a netlist, the fastest clock is that of the CPU itself.
+			if (ScottySettings.clk_max && ScottySettings.timingFile.empty()) {
+				CPUFactory::TimingAnalysis<16u> analysis(cpu.getGraphRoots());
+				analysis.print(std::cout);
+
+				if (analysis.getMaxFrequency() > 0.0) {
+					ScottySettings.clk_freq = float(analysis.getMaxFrequency());
+					cpu.getClock().setFrequency(ScottySettings.clk_freq);
+					std::cout << "Clock frequency set to " << ScottySettings.clk_freq << " Hz." << std::endl;
+				}
+			}
 
-			cpu.staticLoader(buffer);
+			if (ScottySettings.loadScHex) {
+				std::vector<char> *buffer = SysUtils::readBinaryFile(ScottySettings.schexFile);
 
-			std::cout << "Loaded binary file \"" << ScottySettings.schexFile << "\" into RAM. " << std::endl;
+				cpu.staticLoader(buffer);
 
-			SysUtils::deallocVar(buffer);
+				std::cout << "Loaded binary file \"" << ScottySettings.schexFile << "\" into RAM. " << std::endl;
 
-			//cpu.start();
+				SysUtils::deallocVar(buffer);
 
-			while (1) {
-				cpu.step();
-				SysUtils::callSystemCmd("PAUSE");
+				//cpu.start();
+
+				while (1) {
+					cpu.step();
+					SysUtils::callSystemCmd("PAUSE");
+				}
 			}
 		}
 